@@ -0,0 +1,366 @@
+// Benchmarks for the functions of the linalg library.
+//
+// Each function is timed for the sizes from '--min' to '--max' (3 to 8192 by
+// default), repeating the calls until '--time' seconds have passed. The results
+// are shown as a table and, with '--json', also saved in a JSON file that can be
+// compared between versions.
+//
+// Usage: bench_linalg [--min N] [--max N] [--cubic-max N] [--time S]
+//                     [--filter TEXT] [--json FILE]
+//
+// Functions with cubic cost are limited by '--cubic-max' (1024 by default),
+// since they take hours for the largest sizes.
+//
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "linalg.h"
+
+#define BENCH_FILE "bench_linalg.tmp"                   // File used by the reading functions
+
+enum cost {LINEAR, QUADRATIC, CUBIC};
+
+typedef struct context
+{
+    int n;
+
+    Matrix *a;                                          // 'n x n' well conditioned matrix
+
+    Matrix *b;                                          // 'n x n' matrix
+
+    Matrix *sys;                                        // 'n x (n + 1)' system of equations
+
+    Array *x;                                           // Arrays of length 'n'
+
+    Array *y;
+
+    int *perm;
+
+    double sink;                                        // Keeps the results alive
+} Context;
+
+typedef struct benchmark
+{
+    char *name;
+
+    enum cost cost;
+
+    void (*run)(Context *ctx);
+
+    double (*flops)(double n);                          // Floating point operations of one call
+
+    double (*bytes)(double n);                          // Minimum memory traffic of one call
+} Benchmark;
+
+
+// Estimates of operations and memory traffic:
+
+static double zero(double n) { (void) n; return 0; }
+static double n_flops(double n) { return n; }
+static double two_n(double n) { return 2 * n; }
+static double n2(double n) { return n * n; }
+static double two_n2(double n) { return 2 * n * n; }
+static double two_n3(double n) { return 2 * n * n * n; }
+static double two_thirds_n3(double n) { return 2 * n * n * n / 3; }
+static double vec_bytes1(double n) { return 8 * n; }
+static double vec_bytes2(double n) { return 16 * n; }
+static double vec_bytes3(double n) { return 24 * n; }
+static double mat_bytes1(double n) { return 8 * n * n; }
+static double mat_bytes2(double n) { return 16 * n * n; }
+static double mat_bytes3(double n) { return 24 * n * n; }
+static double inv_flops(double n) { return 2 * n * n * n; }
+
+
+// Benchmarked calls:
+
+static void run_create_matrix(Context *ctx) { free_matrix(create_matrix(ctx->n, ctx->n)); }
+static void run_copy_matrix(Context *ctx) { free_matrix(copy_matrix(ctx->a)); }
+static void run_get_matrix(Context *ctx) { (void) ctx; free_matrix(get_matrix(BENCH_FILE)); }
+static void run_sum_matrix(Context *ctx) { free_matrix(sum_matrix(ctx->a, ctx->b)); }
+static void run_over_sum_matrix(Context *ctx) { over_sum_matrix(ctx->b, ctx->a); }
+static void run_rnumber_times_matrix(Context *ctx) { free_matrix(rnumber_times_matrix(1.5, ctx->a)); }
+static void run_transpose_matrix(Context *ctx) { free_matrix(transpose_matrix(ctx->a)); }
+static void run_matrix_times_matrix(Context *ctx) { free_matrix(matrix_times_matrix(ctx->a, ctx->b)); }
+static void run_matrix_times_array(Context *ctx) { free_array(matrix_times_array(ctx->a, ctx->x)); }
+static void run_array_times_matrix(Context *ctx) { free_array(array_times_matrix(ctx->x, ctx->a)); }
+static void run_gemv(Context *ctx) { gemv(1, ctx->a, ctx->x, 0, ctx->y); }
+static void run_gemv_transposed(Context *ctx) { gemv_transposed(1, ctx->a, ctx->x, 0, ctx->y); }
+static void run_sum_array(Context *ctx) { free_array(sum_array(ctx->x, ctx->y)); }
+static void run_scalar_product(Context *ctx) { ctx->sink += scalar_product(ctx->x, ctx->y); }
+static void run_polynomial_eval_many(Context *ctx) { polynomial_eval_many(ctx->x, ctx->x, ctx->y, NULL); }
+static void run_inverse_matrix(Context *ctx) { free_matrix(inverse_matrix(ctx->a)); }
+static void run_solve_system(Context *ctx) { free_array(solve_system(ctx->sys)); }
+
+static void run_euclidean_norm(Context *ctx)
+{
+    array_changed(ctx->x);                          // Otherwise the norm saved by the first call is returned.
+
+    ctx->sink += euclidean_norm(ctx->x);
+}
+
+static void run_determinant(Context *ctx)
+{
+    matrix_changed(ctx->a);                         // Otherwise the determinant saved by the first call is returned.
+
+    ctx->sink += determinant(ctx->a);
+}
+
+static void run_lu_decomposition(Context *ctx)
+{
+    Matrix *lu = copy_matrix(ctx->a);
+
+    ctx->sink += lu_decomposition(lu, ctx->perm);
+
+    free_matrix(lu);
+}
+
+static void run_qr_decomposition(Context *ctx)
+{
+    Matrix *q, *r;
+
+    qr_decomposition(ctx->a, &q, &r);
+
+    free_matrix(q);
+
+    free_matrix(r);
+}
+
+static const Benchmark benchmarks[] =
+{
+    {"create_matrix", QUADRATIC, run_create_matrix, zero, mat_bytes1},
+    {"copy_matrix", QUADRATIC, run_copy_matrix, zero, mat_bytes2},
+    {"get_matrix", QUADRATIC, run_get_matrix, zero, mat_bytes1},
+    {"sum_matrix", QUADRATIC, run_sum_matrix, n2, mat_bytes3},
+    {"over_sum_matrix", QUADRATIC, run_over_sum_matrix, n2, mat_bytes3},
+    {"rnumber_times_matrix", QUADRATIC, run_rnumber_times_matrix, n2, mat_bytes2},
+    {"transpose_matrix", QUADRATIC, run_transpose_matrix, zero, mat_bytes2},
+    {"matrix_times_array", QUADRATIC, run_matrix_times_array, two_n2, mat_bytes1},
+    {"array_times_matrix", QUADRATIC, run_array_times_matrix, two_n2, mat_bytes1},
+    {"gemv", QUADRATIC, run_gemv, two_n2, mat_bytes1},
+    {"gemv_transposed", QUADRATIC, run_gemv_transposed, two_n2, mat_bytes1},
+    {"sum_array", LINEAR, run_sum_array, n_flops, vec_bytes3},
+    {"scalar_product", LINEAR, run_scalar_product, two_n, vec_bytes2},
+    {"euclidean_norm", LINEAR, run_euclidean_norm, two_n, vec_bytes1},
+    {"polynomial_eval_many", QUADRATIC, run_polynomial_eval_many, two_n2, vec_bytes2},
+    {"matrix_times_matrix", CUBIC, run_matrix_times_matrix, two_n3, mat_bytes3},
+    {"determinant", CUBIC, run_determinant, two_thirds_n3, mat_bytes2},
+    {"lu_decomposition", CUBIC, run_lu_decomposition, two_thirds_n3, mat_bytes2},
+    {"solve_system", CUBIC, run_solve_system, two_thirds_n3, mat_bytes2},
+    {"inverse_matrix", CUBIC, run_inverse_matrix, inv_flops, mat_bytes3},
+    {"qr_decomposition", CUBIC, run_qr_decomposition, two_thirds_n3, mat_bytes3},
+};
+
+static double seconds(void)         // Monotonic clock in seconds.
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void setup(Context *ctx, int n)      // Creates the inputs of a given size.
+{
+    register int i, j;
+    FILE *filout;
+
+    ctx->n = n;
+
+    ctx->a = create_matrix(n, n);
+
+    ctx->b = create_matrix(n, n);
+
+    ctx->sys = create_matrix(n, n + 1);
+
+    ctx->x = create_array(n);
+
+    ctx->y = create_array(n);
+
+    ctx->perm = malloc(n * sizeof(int));
+
+    srand(n);
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)             // Diagonal dominance keeps the matrix far from singular.
+        {
+            insert_in_matrix((double) rand() / RAND_MAX - 0.5 + (i == j ? n : 0), ctx->a, i, j);
+
+            insert_in_matrix((double) rand() / RAND_MAX - 0.5, ctx->b, i, j);
+
+            insert_in_matrix(get_from_matrix(ctx->a, i, j), ctx->sys, i, j);
+        }
+
+        insert_in_matrix(1, ctx->sys, i, n);
+
+        insert_in_array((double) rand() / RAND_MAX - 0.5, ctx->x, i);
+
+        insert_in_array((double) rand() / RAND_MAX - 0.5, ctx->y, i);
+    }
+
+    filout = fopen(BENCH_FILE, "w");
+
+    if (filout != NULL)
+    {
+        fprintf(filout, "%dx%d\n", n, n);
+
+        for (i = 0; i < n; i++)
+        {
+            for (j = 0; j < n; j++)
+                fprintf(filout, "%.17g ", get_from_matrix(ctx->b, i, j));
+
+            fprintf(filout, "\n");
+        }
+
+        fclose(filout);
+    }
+}
+
+static void teardown(Context *ctx)      // Deallocates the inputs.
+{
+    free_matrix(ctx->a);
+
+    free_matrix(ctx->b);
+
+    free_matrix(ctx->sys);
+
+    free_array(ctx->x);
+
+    free_array(ctx->y);
+
+    free(ctx->perm);
+
+    remove(BENCH_FILE);
+}
+
+static void usage(char *prog)
+{
+    fprintf(stderr, "Usage: %s [--min N] [--max N] [--cubic-max N] [--time S] [--filter TEXT] [--json FILE]\n", prog);
+
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    static const int sizes[] = {3, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
+
+    register int i, k;
+    int nmin = 3, nmax = 8192, cubicmax = 1024, first = 1;
+    long iter;
+    double mintime = 0.2, t0, elapsed, percall;
+    char *filter = NULL, *json = NULL;
+
+    Context ctx = {0};
+    FILE *jsonout = NULL;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+            usage(argv[0]);
+
+        if (strcmp(argv[i], "--min") == 0)
+            nmin = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max") == 0)
+            nmax = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cubic-max") == 0)
+            cubicmax = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--time") == 0)
+            mintime = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0)
+            json = argv[++i];
+        else
+            usage(argv[0]);
+    }
+
+    if (json != NULL)
+    {
+        jsonout = fopen(json, "w");
+
+        if (jsonout == NULL)
+        {
+            fprintf(stderr, "Error opening '%s'!\n", json);
+
+            return 1;
+        }
+
+        fprintf(jsonout, "{\n  \"library\": \"linalg\",\n  \"kernels\": \"%s\",\n  \"min_time\": %g,\n  \"benchmarks\": [",
+                linalg_kernels_name(), mintime);
+    }
+
+    printf("Kernels: %s\n\n", linalg_kernels_name());
+
+    printf("%-24s %6s %12s %14s %10s %10s\n", "function", "n", "iterations", "time/call (s)", "GFLOP/s", "GB/s");
+
+    for (k = 0; k < (int) (sizeof(sizes) / sizeof(sizes[0])); k++)
+    {
+        if (sizes[k] < nmin || sizes[k] > nmax)
+            continue;
+
+        setup(&ctx, sizes[k]);
+
+        for (i = 0; i < (int) (sizeof(benchmarks) / sizeof(benchmarks[0])); i++)
+        {
+            const Benchmark *bm = &benchmarks[i];
+
+            if (filter != NULL && strstr(bm->name, filter) == NULL)
+                continue;
+
+            if (bm->cost == CUBIC && sizes[k] > cubicmax)
+                continue;
+
+            bm->run(&ctx);                  // Warm-up call
+
+            iter = 0;
+
+            t0 = seconds();
+
+            do                              // Repeats until the minimum time has passed.
+            {
+                bm->run(&ctx);
+
+                iter++;
+
+                elapsed = seconds() - t0;
+            }
+            while (elapsed < mintime);
+
+            percall = elapsed / iter;
+
+            printf("%-24s %6d %12ld %14.6e %10.3f %10.3f\n", bm->name, sizes[k], iter, percall,
+                   bm->flops(sizes[k]) / percall * 1e-9, bm->bytes(sizes[k]) / percall * 1e-9);
+
+            fflush(stdout);
+
+            if (jsonout != NULL)
+            {
+                fprintf(jsonout, "%s\n    {\"name\": \"%s\", \"n\": %d, \"iterations\": %ld, \"seconds_per_call\": %.9e, "
+                        "\"gflops\": %.6f, \"gbytes_per_second\": %.6f}", first ? "" : ",", bm->name, sizes[k], iter,
+                        percall, bm->flops(sizes[k]) / percall * 1e-9, bm->bytes(sizes[k]) / percall * 1e-9);
+
+                first = 0;
+            }
+        }
+
+        teardown(&ctx);
+    }
+
+    if (jsonout != NULL)
+    {
+        fprintf(jsonout, "\n  ]\n}\n");
+
+        fclose(jsonout);
+    }
+
+    if (ctx.sink == 12345.6789)             // Prevents the results from being optimized away.
+        printf("\n");
+
+    return 0;
+}
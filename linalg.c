@@ -2,23 +2,84 @@
 //
 
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L                                 // For 'clock_gettime', 'pread' and the threads of the tiled matrices
+#endif
+
+#define _FILE_OFFSET_BITS 64                                    // Tiled matrices larger than 2 GB
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include "linalg.h"
 
+#ifdef LINALG_STATS
+#include <time.h>
+#endif
+
+#ifdef LINALG_ZLIB
+#include <zlib.h>                                               // Compression of the files of 'save_compressed_matrix'
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LA_X86_DISPATCH                                         // Kernels for AVX2 and AVX-512, selected at run time
+#include <immintrin.h>
+#endif
+
 #define ERRMSS01 "memory allocation error!"                     // Common error messages
 #define ERRMSS02 "NULL array informed!"
 #define ERRMSS03 "error opening file!"
 #define ERRMSS04 "NULL matrix informed!"
 #define ERRMSS05 "incompatible dimensions for overwriting!"
-// Last function number: 46
+
+static void error_message_la(int nmbr, char *mssg);             // Shows an error message indicating the function from where it came.
+
+#define SVD_SEED 0x2545F4914F6CDD1DULL                          // Seed of the random sampling of the range finder
+#define SVD_BLOCK 512                                           // Rows multiplied at a time by the range finder
+#define SVD_SWEEPS 60                                           // Maximum number of Jacobi sweeps
+
+#define POLY_LANES 8                                            // Values evaluated together by 'polynomial_eval_many'
+#define POLY_ESTRIN 8                                           // Degree from which Estrin's scheme is used
+
+#define POLY_PARALLEL 65536                                     // Default tuning parameters; see 'linalg_init'
+#define BATCH_PARALLEL 65536
+#define GEMV_PARALLEL 65536
+#define GEMV_COLUMNS 512
+#define GEMM_PARALLEL 262144
+#define GEMM_BLOCK_ROWS 64
+#define GEMM_BLOCK_INNER 256
+#define GEMM_BLOCK_COLS 1024
+#define STRASSEN_CUTOFF 0
+#define ELEMENTWISE_PARALLEL 262144
+#define DAG_TILE 128
+#define DAG_WORKERS 0
+#define TUNING_NEVER 2147483647                                 // Threshold value that disables multithreading
+// Last function number: 161
+
+#define LA_FUNCTIONS 162                                        // Function numbers, including the unused '0'
 
 struct array
 {
 	int len;
 
 	double *a;
+
+	int wrapped;                                                // The elements are in a buffer given by the caller.
+
+	void (*deleter)(void *buffer);                              // Releases that buffer, or NULL if the caller keeps it
+
+	unsigned long long version;                                 // Changes of the elements, counted from '1'
+
+	atomic_ullong norm_version;                                 // Version for which 'norm' was calculated, or '0'
+
+	_Atomic double norm;
 };
 
 struct matrix
@@ -28,1550 +89,10254 @@ struct matrix
 	int col;
 
 	double **m;
-};
 
-// In-Out functions:
+	double *buffer;                                             // Buffer given by the caller with all the rows, or NULL
 
-Array* create_array(int len)        // Creates an array with a given length.
-{
-    Array *ar;
+	void (*deleter)(void *buffer);                              // Releases that buffer, or NULL if the caller keeps it
 
-    if (len <= 0)
-    {
-        error_message_la(1, "incompatible dimension for an array!");
+	unsigned long long version;                                 // Changes of the elements, counted from '1'
 
-        return NULL;
-    }
+	atomic_ullong det_version;                                  // Version for which 'det' was calculated, or '0'
 
-    ar = malloc(sizeof(Array));
+	_Atomic double det;
 
-    if (ar == NULL)
-    {
-        error_message_la(1, ERRMSS01);
+	atomic_ullong norm_version;
 
-        exit(1);
-    }
+	_Atomic double norm;                                        // Frobenius norm
 
-    ar->a = calloc(len, sizeof(double));
+	atomic_ullong lu_version;
 
-    if (ar->a == NULL)
-    {
-        error_message_la(1, ERRMSS01);
+	atomic_ullong lu_entry;                                     // Decomposition in the factorization cache
+};
 
-        exit(1);
-    }
+#define LA_CHANGED(obj) ((obj)->version++)                      // Records a change of the elements of an array or matrix.
 
-    ar->len = len;
+struct vector_batch
+{
+	int len;
 
-    return ar;
-}
+	double *x;
 
-void free_array(Array *arr)         // Deallocates memory previously used for an array.
-{
-    if (arr != NULL)
-    {
-        free(arr->a);
+	double *y;
 
-        free(arr);
-    }
-}
+	double *z;
+};
 
-int length_of_array(Array *arr)     // Gives the length of an array.
+static char *function_names[LA_FUNCTIONS] =                    // Names of the functions, by their numbers
 {
-    if (arr == NULL)
-        return 0;
-    else
-        return arr->len;
-}
+    "", "create_array", "insert_in_array", "get_from_array", "get_array", "create_matrix",
+    "create_identity_matrix", "insert_in_matrix", "get_from_matrix", "get_matrix", "copy_array",
+    "over_copy_array", "copy_matrix", "over_copy_matrix", "sum_array", "subtract_array",
+    "rnumber_times_array", "array_times_matrix", "matrix_times_array", "over_sum_array",
+    "over_subtract_array", "over_rnumber_times_array", "over_array_times_matrix",
+    "over_matrix_times_array", "sum_matrix", "subtract_matrix", "rnumber_times_matrix",
+    "matrix_times_matrix", "transpose_matrix", "over_sum_matrix", "over_subtract_matrix",
+    "over_rnumber_times_matrix", "over_matrix_times_matrix", "over_transpose_matrix",
+    "scalar_product", "euclidean_norm", "cosine_similarity", "swap_rows", "gaussian_elimination",
+    "determinant", "over_determinant", "inverse_matrix", "polynomial_function", "get_system",
+    "independent_system", "solve_system", "vector_product", "qr_decomposition", "randomized_svd",
+    "randomized_svd_stream", "polynomial_eval_many", "create_vector_batch", "free_vector_batch",
+    "insert_in_vector_batch", "get_from_vector_batch", "batch_vector_product",
+    "batch_scalar_product", "batch_euclidean_norm", "over_normalize_vector_batch", "gemv",
+    "gemv_transposed", "gemv_multiple", "lu_decomposition", "over_lu_solve",
+    "apply_permutation_to_array", "apply_permutation_to_matrix", "linalg_stats_snapshot",
+    "linalg_stats_print_json", "linalg_kernels_name", "linalg_select_kernels", "linalg_init",
+    "linalg_set_parameter", "linalg_get_parameter", "linalg_print_tuning", "create_tiled_matrix",
+    "open_tiled_matrix", "free_tiled_matrix", "insert_in_tiled_matrix", "get_from_tiled_matrix",
+    "matrix_to_tiled_matrix", "tiled_matrix_to_matrix", "tiled_matrix_times_matrix",
+    "tiled_transpose_matrix", "tiled_lu_decomposition", "sync_tiled_matrix", "tiled_matrix_row_number",
+    "tiled_matrix_column_number", "inverse_matrix_async", "matrix_times_matrix_async",
+    "solve_system_async", "task_status", "task_progress", "task_cancel", "task_wait", "free_task",
+    "linalg_start_workers", "linalg_stop_workers", "cholesky_decomposition",
+    "dag_cholesky_decomposition", "dag_lu_decomposition", "dag_qr_decomposition",
+    "over_inverse_update", "over_lu_update", "over_cholesky_update", "over_cholesky_downdate",
+    "over_qr_update", "linalg_factor_cache", "factor_cache_stats", "factor_cache_clear",
+    "array_version", "matrix_version", "frobenius_norm", "set_matrix_row", "get_matrix_row",
+    "set_matrix_column", "get_matrix_column", "set_matrix_block", "get_matrix_block",
+    "set_matrix_buffer", "get_matrix_buffer", "set_array_buffer", "get_array_buffer", "array_pointer",
+    "matrix_row_pointer", "wrap_array", "create_array_uninitialized", "wrap_matrix", "create_matrix_uninitialized",
+    "array_changed", "matrix_changed", "matrix_times_matrix_into", "open_matrix_reader", "matrix_reader_row_number",
+    "matrix_reader_column_number", "read_matrix_rows", "stream_matrix", "matrix_reader_block", "free_matrix_reader",
+    "open_matrix_writer", "write_matrix_rows", "free_matrix_writer", "save_matrix", "save_compressed_matrix",
+    "compress_matrix_file", "open_compressed_matrix", "get_compressed_matrix", "compressed_matrix_block",
+    "compressed_matrix_row_number", "compressed_matrix_column_number", "free_compressed_matrix", "create_band_matrix",
+    "free_band_matrix", "insert_in_band_matrix", "get_from_band_matrix", "matrix_to_band_matrix", "band_matrix_to_matrix",
+    "band_matrix_times_array", "band_lu_decomposition", "over_band_lu_solve", "solve_band_system", "tridiagonal_solve",
+    "batch_tridiagonal_solve"
+};
 
-void insert_in_array(double a, Array *arr, int pos)     // Inserts a value in an array in a given position.
+typedef struct tuning                                           // Parameters that depend on the machine
 {
-    if (arr == NULL)
-    {
-        error_message_la(2, ERRMSS02);
-
-        return;
-    }
-    else if (pos < 0 || pos >= arr->len)
-    {
-        error_message_la(2, "inexistent position in the array!");
+	int gemm_block_rows;                                        // Rows of 'c' computed together in matrix products
 
-        return;
-    }
+	int gemm_block_inner;                                       // Rows of 'b' in each block kept in cache
 
-    arr->a[pos] = a;
-}
+	int gemm_block_cols;                                        // Columns of 'b' in each block kept in cache
 
-double get_from_array(Array *arr, int pos)      // Gets a value in an array from a given position.
-{
-    if (arr == NULL)
-    {
-        error_message_la(3, ERRMSS02);
+	int gemm_parallel;                                          // Multiply-adds from which matrix products are multithreaded
 
-        return 0;
-    }
-    else if (pos < 0 || pos >= arr->len)
-    {
-        error_message_la(3, "inexistent position in the array!");
+	int gemv_parallel;                                          // Matrix elements from which matrix-vector products are multithreaded
 
-        return 0;
-    }
+	int gemv_columns;                                           // Columns of each block in transposed matrix-vector products
 
-    return arr->a[pos];
-}
+	int elementwise_parallel;                                   // Matrix elements from which sums and scalings are multithreaded
 
-Array* get_array(char *name)        // Get an array from a 'txt' file.
-{
-    register int i;
-    int len;
+	int batch_parallel;                                         // Vectors from which batch operations are multithreaded
 
-    FILE *filin;
-    Array *ar;
+	int poly_parallel;                                          // Values from which polynomial evaluation is multithreaded
 
-    filin = fopen(name, "r");
+	int strassen_cutoff;                                        // Order from which matrix products use Strassen's method; '0' disables it
 
-    if (filin == NULL)
-    {
-        error_message_la(4, ERRMSS03);
+	int dag_tile;                                               // Order of the tiles of the task-graph factorizations
 
-        exit(4);
-    }
+	int dag_workers;                                            // Threads of the task-graph factorizations; '0' for one per processor
+} Tuning;
 
-    fscanf(filin, "%d", &len);
+static Tuning tuning_la = {GEMM_BLOCK_ROWS, GEMM_BLOCK_INNER, GEMM_BLOCK_COLS, GEMM_PARALLEL, GEMV_PARALLEL,
+                           GEMV_COLUMNS, ELEMENTWISE_PARALLEL, BATCH_PARALLEL, POLY_PARALLEL, STRASSEN_CUTOFF,
+                           DAG_TILE, DAG_WORKERS};
 
-    ar = create_array(len);
+static struct parameter                                         // Names of the parameters in tuning profiles
+{
+	char *name;
 
-    for (i = 0; i < len; i++)
-        fscanf(filin, " %lf", &ar->a[i]);
+	int *value;
 
-    fclose(filin);
+	int min;
+} parameters_la[] =
+{
+    {"gemm_block_rows", &tuning_la.gemm_block_rows, 1},
+    {"gemm_block_inner", &tuning_la.gemm_block_inner, 1},
+    {"gemm_block_cols", &tuning_la.gemm_block_cols, 1},
+    {"gemm_parallel", &tuning_la.gemm_parallel, 0},
+    {"gemv_parallel", &tuning_la.gemv_parallel, 0},
+    {"gemv_columns", &tuning_la.gemv_columns, 1},
+    {"elementwise_parallel", &tuning_la.elementwise_parallel, 0},
+    {"batch_parallel", &tuning_la.batch_parallel, 0},
+    {"poly_parallel", &tuning_la.poly_parallel, 0},
+    {"strassen_cutoff", &tuning_la.strassen_cutoff, 0},
+    {"dag_tile", &tuning_la.dag_tile, 1},
+    {"dag_workers", &tuning_la.dag_workers, 0}
+};
 
-    return ar;
-}
+#define LA_PARAMETERS ((int) (sizeof(parameters_la) / sizeof(parameters_la[0])))
 
-void print_array(Array *arr)        // Shows an array on the screen.
+struct async_task                                               // Operation run by the workers (see 'Asynchronous tasks')
 {
-    register int i;
-
-    if (arr == NULL)
-    {
-        printf("\n\nNULL array informed to print!\n");
+	void* (*run)(struct async_task *task);
 
-        return;
-    }
+	Matrix *a;                                                  // Copies of the arguments
 
-    printf("\n\n");
+	Matrix *b;
 
-    for (i = 0; i < arr->len; i++)
-        printf("%lf\t", arr->a[i]);
+	void *result;
 
-    printf("\n");
-}
+	int array;                                                  // The result is an array, not a matrix.
 
-Matrix* create_matrix(int m, int n)         // Creates a matrix with given dimensions.
-{
-    register int i;
+	int status;
 
-    Matrix *mat;
+	int taken;                                                  // The result was given to the caller.
 
-    if (m <= 0 || n <= 0)
-    {
-        error_message_la(5, "incompatible dimensions for a matrix!");
+	int released;                                               // 'free_task' was called.
 
-        return NULL;
-    }
+	int finished;                                               // The callback returned.
 
-    mat = malloc(sizeof(Matrix));
+	atomic_int cancel;
 
-    if (mat == NULL)
-    {
-        error_message_la(5, ERRMSS01);
+	atomic_llong progress;                                      // Millionths of the work
 
-        exit(5);
-    }
+	TaskCallback done;
 
-    mat->row = m;
+	void *data;
 
-    mat->col = n;
+	struct async_task *next;
+};
 
-    mat->m = calloc(m, sizeof(double*));
+static _Thread_local AsyncTask *task_current_la = NULL;        // Task run by this thread
 
-    if (mat->m == NULL)
-    {
-        error_message_la(5, ERRMSS01);
+static int task_checkpoint_la(AsyncTask *task, double done)    // Records the progress of a task, if 'done' is not negative. Tells if it was cancelled.
+{
+    if (task == NULL)
+        return 0;
 
-        exit(5);
-    }
+    if (done >= 0)
+        atomic_store_explicit(&task->progress, (long long) (done * 1e6), memory_order_relaxed);
 
-    for (i = 0; i < m; i++)
-    {
-        mat->m[i] = calloc(n, sizeof(double));
+    return atomic_load_explicit(&task->cancel, memory_order_relaxed);
+}
 
-        if (mat->m[i] == NULL)
-        {
-            error_message_la(5, ERRMSS01);
+static void task_advance_la(AsyncTask *task, double part)      // Adds a part of the work to the progress of a task.
+{
+    if (task != NULL)
+        atomic_fetch_add_explicit(&task->progress, (long long) (part * 1e6), memory_order_relaxed);
+}
 
-            exit(5);
-        }
-    }
+// Profiling counters:
+//
+// With LINALG_STATS defined, each function counts its calls (after the arguments are
+// checked), the time spent in it, the memory allocated for it and an estimate of its
+// floating point operations. Times and operations include the nested calls; memory
+// is also added to the outermost function running in the thread. Without LINALG_STATS
+// the macros are empty.
 
-    return mat;
-}
+#ifdef LINALG_STATS
 
-Matrix* create_identity_matrix(int ord)     // Creates an identity matrix of a given order.
+struct stats_counter
 {
-    register int i, j;
+    atomic_llong calls;
 
-    Matrix *mat;
+    atomic_llong nanoseconds;
 
-    if (ord <= 0)
-    {
-        error_message_la(6, "invalid order value informed for a matrix!");
+    atomic_llong bytes;
 
-        return NULL;
-    }
+    atomic_llong flops;
+};
 
-    mat = create_matrix(ord, ord);
+static struct stats_counter stats_la[LA_FUNCTIONS];
 
-    for (i = 0; i < ord; i++)
-    {
-        for (j = 0; j < ord; j++)
-        {
-            if (i == j)
-                mat->m[i][j] = 1;
-            else
-                mat->m[i][j] = 0;
-        }
-    }
+static _Thread_local int stats_current_la = 0;         // Outermost function running in the thread
 
-    return mat;
+static long long stats_clock_la(void)                   // Monotonic clock in nanoseconds.
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
 }
 
-void free_matrix(Matrix *mat)       // Deallocates memory previously used for a matrix.
+static int stats_enter_la(int nmbr)                     // Counts a call and marks the outermost function.
 {
-    if (mat != NULL)
-    {
-        register int i;
+    int prev = stats_current_la;
 
-        for (i = 0; i < mat->row; i++)
-            free(mat->m[i]);
+    atomic_fetch_add_explicit(&stats_la[nmbr].calls, 1, memory_order_relaxed);
 
-        free(mat->m);
+    if (prev == 0)
+        stats_current_la = nmbr;
 
-        free(mat);
-    }
+    return prev;
 }
 
-int matrix_row_number(Matrix *mat)      // Gives the number of rows of a matrix.
+static void stats_leave_la(int nmbr, long long t0, int prev, double flops)     // Adds the time and operations of a call.
 {
-    if (mat == NULL)
-        return 0;
-    else
-        return mat->row;
+    atomic_fetch_add_explicit(&stats_la[nmbr].nanoseconds, stats_clock_la() - t0, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&stats_la[nmbr].flops, (long long) flops, memory_order_relaxed);
+
+    stats_current_la = prev;
 }
 
-int matrix_column_number(Matrix *mat)   // Gives the number of columns of a matrix.
+static void stats_bytes_la(int nmbr, long long bytes)  // Adds allocated memory to a function and to the outermost one.
 {
-    if (mat == NULL)
-        return 0;
-    else
-        return mat->col;
+    atomic_fetch_add_explicit(&stats_la[nmbr].bytes, bytes, memory_order_relaxed);
+
+    if (stats_current_la != 0 && stats_current_la != nmbr)
+        atomic_fetch_add_explicit(&stats_la[stats_current_la].bytes, bytes, memory_order_relaxed);
 }
 
-void insert_in_matrix(double a, Matrix *mat, int i, int j)      // Inserts a value in a matrix in a given position.
-{
-    if (mat == NULL)
-    {
-        error_message_la(7, ERRMSS04);
+#define LA_STATS_COUNT(nmbr) atomic_fetch_add_explicit(&stats_la[nmbr].calls, 1, memory_order_relaxed)
+#define LA_STATS_START(nmbr) long long stats_t0 = stats_clock_la(); int stats_prev = stats_enter_la(nmbr)
+#define LA_STATS_STOP(nmbr, flops) stats_leave_la(nmbr, stats_t0, stats_prev, (flops))
+#define LA_STATS_BYTES(nmbr, bytes) stats_bytes_la(nmbr, (bytes))
 
-        return;
-    }
-    else if (i < 0 || i >= mat->row || j < 0 || j >= mat->col)
-    {
-        error_message_la(7, "inexistent position in the matrix!");
+#else
 
-        return;
-    }
+#define LA_STATS_COUNT(nmbr)
+#define LA_STATS_START(nmbr)
+#define LA_STATS_STOP(nmbr, flops)
+#define LA_STATS_BYTES(nmbr, bytes)
 
-    mat->m[i][j] = a;
-}
+#endif
 
-double get_from_matrix(Matrix *mat, int i, int j)           // Gets a value in a matrix from a given position.
+// Kernels selected at run time:
+//
+// The innermost loops of the library (scalar products, 'y += a * x' updates and
+// elementwise operations) go through a table of kernels chosen once, when the library
+// is loaded, by the instruction sets of the processor. The environment variable
+// LINALG_KERNELS ("generic", "avx2" or "avx512") forces a choice, for testing.
+
+typedef struct kernels
 {
-    if (mat == NULL)
-    {
-        error_message_la(8, ERRMSS04);
+	char *name;
 
-        return 0;
-    }
-    else if (i < 0 || i >= mat->row || j < 0 || j >= mat->col)
-    {
-        error_message_la(8, "inexistent position in the matrix!");
+	double (*dot)(double *a, double *b, int n);                 // Scalar product
 
-        return 0;
-    }
+	void (*axpy)(double a, double *x, double *y, int n);        // y = y + a * x
 
-    return mat->m[i][j];
-}
+	void (*add)(double *a, double *b, double *c, int n);        // c = a + b
 
-Matrix* get_matrix(char *name)      // Get a matrix from a 'txt' file.
-{
-    register int i, j;
-    int m, n;
+	void (*sub)(double *a, double *b, double *c, int n);        // c = a - b
 
-    Matrix *mat;
-    FILE *filin;
+	void (*scale)(double num, double *a, double *c, int n);     // c = num * a
+} Kernels;
 
-    filin = fopen(name, "r");
+static double dot_generic_la(double *a, double *b, int n)      // Scalar product of two vectors of doubles.
+{
+    register int i;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
 
-    if (filin == NULL)
+    for (i = 0; i + 3 < n; i += 4)                  // Independent partial sums, so that the loop is not one long dependency chain.
     {
-        error_message_la(9, ERRMSS03);
-
-        exit(9);
-    }
+        s0 += a[i] * b[i];
 
-    fscanf(filin, "%dx%d", &m, &n);
+        s1 += a[i + 1] * b[i + 1];
 
-    mat = create_matrix(m, n);
+        s2 += a[i + 2] * b[i + 2];
 
-    for (i = 0; i < m; i++)
-    {
-        for (j = 0; j < n; j++)
-            fscanf(filin, " %lf", &mat->m[i][j]);
+        s3 += a[i + 3] * b[i + 3];
     }
 
-    fclose(filin);
+    for (; i < n; i++)
+        s0 += a[i] * b[i];
 
-    return mat;
+    return (s0 + s1) + (s2 + s3);
 }
 
-void print_matrix(Matrix *mat)      // Shows a matrix on the screen.
+static void axpy_generic_la(double a, double *x, double *y, int n)
 {
-    register int i, j;
+    register int i;
 
-    if (mat == NULL)
-    {
-        printf("\n\nNULL matrix informed to print!\n");
+    for (i = 0; i < n; i++)
+        y[i] += a * x[i];
+}
 
-        return;
-    }
+static void add_generic_la(double *a, double *b, double *c, int n)
+{
+    register int i;
 
-    printf("\n\n");
+    for (i = 0; i < n; i++)
+        c[i] = a[i] + b[i];
+}
 
-    for (i = 0; i < mat->row; i++)
-    {
-        for (j = 0; j < mat->col; j++)
-            printf("%lf\t", mat->m[i][j]);
+static void sub_generic_la(double *a, double *b, double *c, int n)
+{
+    register int i;
 
-        printf("\n");
-    }
+    for (i = 0; i < n; i++)
+        c[i] = a[i] - b[i];
 }
 
-static void error_message_la(int nmbr, char *mssg)  // Shows an error message indicating the function from where it came.
+static void scale_generic_la(double num, double *a, double *c, int n)
 {
-    if (mssg == NULL)
-    {
-        error_message_la(0, "NULL string informed!");
-
-        return;
-    }
+    register int i;
 
-    printf("\n\n** Error **\n** [LA%04d]: %s **\n\a", nmbr, mssg);
+    for (i = 0; i < n; i++)
+        c[i] = num * a[i];
 }
 
-// Copy functions:
+static const Kernels generic_kernels = {"generic", dot_generic_la, axpy_generic_la, add_generic_la, sub_generic_la, scale_generic_la};
 
-Array* copy_array(Array *arr)       // Copies an array as a new one.
+#ifdef LA_X86_DISPATCH
+
+__attribute__((target("avx2,fma")))
+static double dot_avx2_la(double *a, double *b, int n)
 {
-    register i;
-    Array *arrcp;
+    register int i;
+    double res;
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    __m128d h;
 
-    if (arr == NULL)
+    for (i = 0; i + 15 < n; i += 16)                // Four independent accumulators hide the latency of the FMA.
     {
-        error_message_la(10, ERRMSS02);
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
 
-        return NULL;
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
     }
 
-    arrcp = create_array(arr->len);
+    for (; i + 3 < n; i += 4)
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
 
-    for (i = 0; i < arr->len; i++)
-        arrcp->a[i] = arr->a[i];
+    s0 = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
 
-    return arrcp;
+    h = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+
+    res = _mm_cvtsd_f64(h) + _mm_cvtsd_f64(_mm_unpackhi_pd(h, h));
+
+    for (; i < n; i++)
+        res += a[i] * b[i];
+
+    return res;
 }
 
-void over_copy_array(Array *cpy, Array *pst)        // Copies an array in a pre-existing one, overwriting it.
+__attribute__((target("avx2,fma")))
+static void axpy_avx2_la(double a, double *x, double *y, int n)
 {
-    register i;
+    register int i;
+    __m256d va = _mm256_set1_pd(a);
 
-    if (cpy == NULL || pst == NULL)
-    {
-        error_message_la(11, ERRMSS02);
+    for (i = 0; i + 3 < n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
 
-        return;
-    }
-    else if (cpy->len != pst->len)
-    {
-        error_message_la(11, ERRMSS05);
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
 
-        printf("\nThe destination array must have the same number of elements of the original one.\n");
+__attribute__((target("avx2,fma")))
+static void add_avx2_la(double *a, double *b, double *c, int n)
+{
+    register int i;
 
-        exit(11);
-    }
+    for (i = 0; i + 3 < n; i += 4)
+        _mm256_storeu_pd(c + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
 
-    for (i = 0; i < cpy->len; i++)
-        pst->a[i] = cpy->a[i];
+    for (; i < n; i++)
+        c[i] = a[i] + b[i];
 }
 
-Matrix* copy_matrix(Matrix *mat)        // Copies a matrix as a new one.
+__attribute__((target("avx2,fma")))
+static void sub_avx2_la(double *a, double *b, double *c, int n)
 {
-    register i, j;
-    Matrix *matcp;
+    register int i;
 
-    if (mat == NULL)
-    {
-        error_message_la(12, ERRMSS04);
+    for (i = 0; i + 3 < n; i += 4)
+        _mm256_storeu_pd(c + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
 
-        return NULL;
-    }
+    for (; i < n; i++)
+        c[i] = a[i] - b[i];
+}
 
-    matcp = create_matrix(mat->row, mat->col);
+__attribute__((target("avx2,fma")))
+static void scale_avx2_la(double num, double *a, double *c, int n)
+{
+    register int i;
+    __m256d vn = _mm256_set1_pd(num);
 
-    for (i = 0; i < mat->row; i++)
-    {
-        for (j = 0; j < mat->col; j++)
-            matcp->m[i][j] = mat->m[i][j];
-    }
+    for (i = 0; i + 3 < n; i += 4)
+        _mm256_storeu_pd(c + i, _mm256_mul_pd(vn, _mm256_loadu_pd(a + i)));
 
-    return matcp;
+    for (; i < n; i++)
+        c[i] = num * a[i];
 }
 
-void over_copy_matrix(Matrix *cpy, Matrix *pst)     // Copies a matrix in a pre-existing one, overwriting it.
+__attribute__((target("avx512f")))
+static double dot_avx512_la(double *a, double *b, int n)
 {
-    register i, j;
+    register int i;
+    double res;
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
 
-    if (cpy == NULL || pst == NULL)
+    for (i = 0; i + 31 < n; i += 32)
     {
-        error_message_la(13, ERRMSS04);
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
 
-        return;
-    }
-    else if (cpy->row != pst->row || cpy->col != pst->col)
-    {
-        error_message_la(13, ERRMSS05);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
 
-        printf("\nThe destination matrix must have the same number of rows and columns of the original one.\n");
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
 
-        exit(13);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
     }
 
-    for (i = 0; i < cpy->row; i++)
+    for (; i + 7 < n; i += 8)
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+
+    if (i < n)                                      // The remainder with a masked load
     {
-        for (j = 0; j < cpy->col; j++)
-            pst->m[i][j] = cpy->m[i][j];
+        __mmask8 mask = (__mmask8) ((1u << (n - i)) - 1);
+
+        s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), s1);
     }
-}
 
-// Arithmetic operation functions:
+    res = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
 
-Array* sum_array(Array *a, Array *b)            // Sums two arrays and saves the result as a new one.
+    return res;
+}
+
+__attribute__((target("avx512f")))
+static void axpy_avx512_la(double a, double *x, double *y, int n)
 {
     register int i;
+    __m512d va = _mm512_set1_pd(a);
+    __mmask8 mask;
 
-    Array *ar;
+    for (i = 0; i + 7 < n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
 
-    if (a == NULL || b == NULL)
+    if (i < n)
     {
-        error_message_la(14, ERRMSS02);
+        mask = (__mmask8) ((1u << (n - i)) - 1);
 
-        return NULL;
+        _mm512_mask_storeu_pd(y + i, mask, _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
     }
+}
 
-    if (a->len != b->len)                           // Tests the compatibility of dimensions.
+__attribute__((target("avx512f")))
+static void add_avx512_la(double *a, double *b, double *c, int n)
+{
+    register int i;
+    __mmask8 mask;
+
+    for (i = 0; i + 7 < n; i += 8)
+        _mm512_storeu_pd(c + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+
+    if (i < n)
     {
-        error_message_la(14, "incompatible dimensions for an array sum!");
+        mask = (__mmask8) ((1u << (n - i)) - 1);
 
-        return NULL;
+        _mm512_mask_storeu_pd(c + i, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i)));
     }
+}
 
-    ar = create_array(a->len);
+__attribute__((target("avx512f")))
+static void sub_avx512_la(double *a, double *b, double *c, int n)
+{
+    register int i;
+    __mmask8 mask;
 
-    for (i = 0; i < ar->len; i++)
-        ar->a[i] = a->a[i] + b->a[i];
+    for (i = 0; i + 7 < n; i += 8)
+        _mm512_storeu_pd(c + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
 
-    return ar;
+    if (i < n)
+    {
+        mask = (__mmask8) ((1u << (n - i)) - 1);
+
+        _mm512_mask_storeu_pd(c + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i)));
+    }
 }
 
-Array* subtract_array(Array *a, Array *b)       // Subtracts two arrays and saves the result as a new one.
+__attribute__((target("avx512f")))
+static void scale_avx512_la(double num, double *a, double *c, int n)
 {
     register int i;
+    __m512d vn = _mm512_set1_pd(num);
+    __mmask8 mask;
 
-    Array *ar;
+    for (i = 0; i + 7 < n; i += 8)
+        _mm512_storeu_pd(c + i, _mm512_mul_pd(vn, _mm512_loadu_pd(a + i)));
 
-    if (a == NULL || b == NULL)
+    if (i < n)
     {
-        error_message_la(15, ERRMSS02);
+        mask = (__mmask8) ((1u << (n - i)) - 1);
 
-        return NULL;
+        _mm512_mask_storeu_pd(c + i, mask, _mm512_mul_pd(vn, _mm512_maskz_loadu_pd(mask, a + i)));
     }
+}
 
-    if (a->len != b->len)                           // Tests the compatibility of dimensions.
-    {
-        error_message_la(15, "incompatible dimensions for an array subtraction!");
+static const Kernels avx2_kernels = {"avx2", dot_avx2_la, axpy_avx2_la, add_avx2_la, sub_avx2_la, scale_avx2_la};
 
-        return NULL;
-    }
+static const Kernels avx512_kernels = {"avx512", dot_avx512_la, axpy_avx512_la, add_avx512_la, sub_avx512_la, scale_avx512_la};
 
-    ar = create_array(a->len);
+#endif
 
-    for (i = 0; i < ar->len; i++)
-        ar->a[i] = a->a[i] - b->a[i];
+static const Kernels *kernels_la = NULL;                        // Kernels in use
 
-    return ar;
+static const Kernels* kernels_by_name_la(char *name)           // Gives the kernels with a given name, if the processor supports them.
+{
+    if (strcmp(name, "generic") == 0)
+        return &generic_kernels;
+
+#ifdef LA_X86_DISPATCH
+    __builtin_cpu_init();
+
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return &avx2_kernels;
+
+    if (strcmp(name, "avx512") == 0 && __builtin_cpu_supports("avx512f"))
+        return &avx512_kernels;
+#endif
+
+    return NULL;
 }
 
-Array* rnumber_times_array(double num, Array *arr)  // Multiplies a real number by an array and saves the result as a new array.
+#ifdef __GNUC__
+__attribute__((constructor))
+#endif
+static void kernels_init_la(void)               // Chooses the best kernels for the processor, unless LINALG_KERNELS forces others.
 {
-    register int i;
+    char *name = getenv("LINALG_KERNELS");
 
-    Array *ar;
+    if (kernels_la != NULL)
+        return;
 
-    if (arr == NULL)
+    if (name != NULL && name[0] != '\0')
     {
-        error_message_la(16, ERRMSS02);
+        kernels_la = kernels_by_name_la(name);
 
-        return NULL;
+        if (kernels_la == NULL)
+            fprintf(stderr, "\nlinalg: kernels '%s' are not available, choosing automatically.\n", name);
     }
 
-    ar = create_array(arr->len);
+    if (kernels_la == NULL)
+        kernels_la = kernels_by_name_la("avx512");
 
-    for (i = 0; i < ar->len; i++)
-        ar->a[i] = num * arr->a[i];
+    if (kernels_la == NULL)
+        kernels_la = kernels_by_name_la("avx2");
 
-    return ar;
+    if (kernels_la == NULL)
+        kernels_la = &generic_kernels;
 }
 
-Array* array_times_matrix(Array *arr, Matrix *mat)      // Multiplies an array by a matrix and saves the result as a new array.
+static const Kernels* kernels(void)             // Gives the kernels in use, choosing them if it was not done when loading.
 {
-    register int i, j;
+    if (kernels_la == NULL)
+        kernels_init_la();
+
+    return kernels_la;
+}
+
+static double dot_la(double *a, double *b, int n)      // Scalar product of two vectors of doubles.
+{
+    return kernels()->dot(a, b, n);
+}
+
+// In-Out functions:
 
+Array* create_array(int len)        // Creates an array with a given length.
+{
     Array *ar;
 
-    if (arr == NULL)
+    if (len <= 0)
     {
-        error_message_la(17, ERRMSS02);
+        error_message_la(1, "incompatible dimension for an array!");
 
         return NULL;
     }
-    else if (mat == NULL)
-    {
-        error_message_la(17, ERRMSS04);
 
-        return NULL;
-    }
+    LA_STATS_START(1);
 
-    if (arr->len != mat->row)                               // Tests the compatibility of dimensions.
+    ar = malloc(sizeof(Array));
+
+    if (ar == NULL)
     {
-        error_message_la(17, "incompatible dimensions for an array-matrix multiplication!");
+        error_message_la(1, ERRMSS01);
 
-        return NULL;
+        exit(1);
     }
 
-    ar = create_array(mat->col);
+    ar->a = calloc(len, sizeof(double));
 
-    for (j = 0; j < mat->col; j++)
+    if (ar->a == NULL)
     {
-        ar->a[j] = 0;
+        error_message_la(1, ERRMSS01);
 
-        for (i = 0; i < mat->row; i++)
-            ar->a[j] += arr->a[i] * mat->m[i][j];     
+        exit(1);
     }
 
+    ar->len = len;
+
+    ar->wrapped = 0;
+
+    ar->deleter = NULL;
+
+    ar->version = 1;
+
+    atomic_init(&ar->norm_version, 0);
+
+    LA_STATS_BYTES(1, sizeof(Array) + (long long) len * sizeof(double));
+
+    LA_STATS_STOP(1, 0);
+
     return ar;
 }
 
-Array* matrix_times_array(Matrix *mat, Array *arr)      // Multiplies a matrix by an array and saves the result as a new array.
+Array* wrap_array(double *buffer, int len, void (*deleter)(void *buffer))   // Creates an array that uses a given buffer.
 {
-    register int i, j;
-
     Array *ar;
 
-    if (arr == NULL)
+    if (buffer == NULL)
     {
-        error_message_la(18, ERRMSS02);
+        error_message_la(124, "NULL buffer informed!");
 
         return NULL;
     }
-    else if (mat == NULL)
+    else if (len <= 0)
     {
-        error_message_la(18, ERRMSS04);
+        error_message_la(124, "incompatible dimension for an array!");
 
         return NULL;
     }
 
-    if (mat->col != arr->len)                               // Tests the compatibility of dimensions.
+    LA_STATS_START(124);
+
+    ar = malloc(sizeof(Array));
+
+    if (ar == NULL)
     {
-        error_message_la(18, "incompatible dimensions for a matrix-array multiplication!");
+        error_message_la(124, ERRMSS01);
 
-        return NULL;
+        exit(124);
     }
 
-    ar = create_array(mat->row);
+    ar->len = len;
 
-    for (i = 0; i < mat->row; i++)
-    {
-        ar->a[i] = 0;
+    ar->a = buffer;
 
-        for (j = 0; j < mat->col; j++)
-            ar->a[i] += mat->m[i][j] * arr->a[j];
-    }
+    ar->wrapped = 1;
+
+    ar->deleter = deleter;
+
+    ar->version = 1;
+
+    atomic_init(&ar->norm_version, 0);
+
+    LA_STATS_BYTES(124, sizeof(Array));
+
+    LA_STATS_STOP(124, 0);
 
     return ar;
 }
 
-void over_sum_array(Array *a, Array *b)     // Sums two arrays and overwrites the result in the first one.
+Array* create_array_uninitialized(int len)  // Creates an array with a given length without setting its elements.
 {
-    register int i;
+    Array *ar;
 
-    if (a == NULL || b == NULL)
+    if (len <= 0)
     {
-        error_message_la(19, ERRMSS02);
+        error_message_la(125, "incompatible dimension for an array!");
 
-        return;
+        return NULL;
     }
 
-    if (a->len != b->len)                       // Tests the compatibility of dimensions.
+    LA_STATS_START(125);
+
+    ar = malloc(sizeof(Array));
+
+    if (ar == NULL)
     {
-        error_message_la(19, "incompatible dimensions for an array sum!");
+        error_message_la(125, ERRMSS01);
 
-        return;
+        exit(125);
     }
 
-    for (i = 0; i < a->len; i++)
-        a->a[i] += b->a[i];
-}
-
-void over_subtract_array(Array *a, Array *b)        // Subtracts two arrays and overwrites the result in the first one.
-{
-    register int i;
+    ar->a = malloc(len * sizeof(double));
 
-    if (a == NULL || b == NULL)
+    if (ar->a == NULL)
     {
-        error_message_la(20, ERRMSS02);
+        error_message_la(125, ERRMSS01);
 
-        return NULL;
+        exit(125);
     }
 
-    if (a->len != b->len)                               // Tests the compatibility of dimensions.
-    {
-        error_message_la(20, "incompatible dimensions for an array subtraction!");
+    ar->len = len;
 
-        return;
-    }
+    ar->wrapped = 0;
 
-    for (i = 0; i < a->len; i++)
-        a->a[i] -= b->a[i];
-}
+    ar->deleter = NULL;
 
-void over_rnumber_times_array(double num, Array *arr)       // Multiplies a real number by an array and overwrites the result in the original array.
-{
-    register int i;
+    ar->version = 1;
 
-    if (arr == NULL)
+    atomic_init(&ar->norm_version, 0);
+
+    LA_STATS_BYTES(125, sizeof(Array) + (long long) len * sizeof(double));
+
+    LA_STATS_STOP(125, 0);
+
+    return ar;
+}
+
+void free_array(Array *arr)         // Deallocates memory previously used for an array.
+{
+    if (arr != NULL)
     {
-        error_message_la(21, ERRMSS02);
+        if (!arr->wrapped)
+            free(arr->a);
+        else if (arr->deleter != NULL)
+            arr->deleter(arr->a);
 
-        return;
+        free(arr);
     }
+}
 
-    for (i = 0; i < arr->len; i++)
-        arr->a[i] *= num;
+int length_of_array(Array *arr)     // Gives the length of an array.
+{
+    if (arr == NULL)
+        return 0;
+    else
+        return arr->len;
 }
 
-void over_array_times_matrix(Array *arr, Matrix *mat)       // Multiplies an array by a matrix and overwrites the result in the first one.
+unsigned long long array_version(Array *arr)    // Gives the counter of changes of an array.
 {
-    register int i, j;
+    if (arr == NULL)
+        return 0;
 
-    Array *tempar;
+    LA_STATS_COUNT(109);
 
+    return arr->version;
+}
+
+void insert_in_array(double a, Array *arr, int pos)     // Inserts a value in an array in a given position.
+{
     if (arr == NULL)
     {
-        error_message_la(22, ERRMSS02);
+        error_message_la(2, ERRMSS02);
 
         return;
     }
-    else if (mat == NULL)
+    else if (pos < 0 || pos >= arr->len)
     {
-        error_message_la(22, ERRMSS04);
+        error_message_la(2, "inexistent position in the array!");
 
         return;
     }
 
-    if (arr->len != mat->row)                   // Tests the compatibility of dimensions.
-    {
-        error_message_la(22, "incompatible dimensions for an array-matrix multiplication!");
-
-        return;
-    }
-    else if (mat->row != mat->col)                  // Only works if the matrix is square.
-    {
-        error_message_la(22, ERRMSS05);
+    LA_STATS_COUNT(2);
 
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+    arr->a[pos] = a;
 
-        return;
-    }
+    LA_CHANGED(arr);
+}
 
-    tempar = create_array(arr->len);
+double get_from_array(Array *arr, int pos)      // Gets a value in an array from a given position.
+{
+    if (arr == NULL)
+    {
+        error_message_la(3, ERRMSS02);
 
-    for (j = 0; j < mat->col; j++)              // Multiplication
+        return 0;
+    }
+    else if (pos < 0 || pos >= arr->len)
     {
-        tempar->a[j] = 0;
+        error_message_la(3, "inexistent position in the array!");
 
-        for (i = 0; i < mat->row; i++)
-            tempar->a[j] += arr->a[i] * mat->m[i][j];
+        return 0;
     }
 
-    over_copy_array(tempar, arr);               // Overwriting
+    LA_STATS_COUNT(3);
 
-    free_array(tempar);
+    return arr->a[pos];
 }
 
-void over_matrix_times_array(Matrix *mat, Array *arr)   // Multiplies a matrix by an array and overwrites the result in the second one.
+void set_array_buffer(Array *arr, double *values)  // Copies a buffer to all the elements of an array.
 {
-    register int i, j;
-
-    Array *tempar;
-
     if (arr == NULL)
     {
-        error_message_la(23, ERRMSS02);
+        error_message_la(120, ERRMSS02);
 
         return;
     }
-    else if (mat == NULL)
+    else if (values == NULL)
     {
-        error_message_la(23, ERRMSS04);
+        error_message_la(120, "NULL buffer informed!");
 
         return;
     }
 
-    if (mat->col != arr->len)                   // Tests the compatibility of dimensions.
-    {
-        error_message_la(23, "incompatible dimensions for a matrix-array multiplication!");
+    LA_STATS_COUNT(120);
 
-        return;
-    }
-    else if (mat->row != mat->col)                  // Only works if the matrix is square.
-    {
-        error_message_la(23, ERRMSS05);
+    memcpy(arr->a, values, arr->len * sizeof(double));
 
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+    LA_CHANGED(arr);
+}
+
+void get_array_buffer(Array *arr, double *values)  // Copies all the elements of an array to a buffer.
+{
+    if (arr == NULL)
+    {
+        error_message_la(121, ERRMSS02);
 
         return;
     }
-
-    tempar = create_array(arr->len);
-
-    for (i = 0; i < mat->row; i++)              // Multiplication
+    else if (values == NULL)
     {
-        tempar->a[i] = 0;
+        error_message_la(121, "NULL buffer informed!");
 
-        for (j = 0; j < mat->col; j++)
-            tempar->a[i] += mat->m[i][j] * arr->a[j];
+        return;
     }
 
-    over_copy_array(tempar, arr);               // Overwriting
+    LA_STATS_COUNT(121);
 
-    free_array(tempar);
+    memcpy(values, arr->a, arr->len * sizeof(double));
 }
 
-Matrix* sum_matrix(Matrix *a, Matrix *b)            // Sums two matrixes and saves the result as a new one.
+double* array_pointer(Array *arr)   // Gives the elements of an array.
 {
-    register int i, j;
-
-    Matrix *mat;
-
-    if (a == NULL || b == NULL)
+    if (arr == NULL)
     {
-        error_message_la(24, ERRMSS04);
+        error_message_la(122, ERRMSS02);
 
         return NULL;
     }
 
-    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
-    {
-        error_message_la(24, "incompatible dimensions for a matrix sum!");
-
-        return NULL;
-    }
+    LA_STATS_COUNT(122);
 
-    mat = create_matrix(a->row, a->col);
+    return arr->a;
+}
 
-    for (i = 0; i < mat->row; i++)
+void array_changed(Array *arr)      // Records a change made directly to the elements of an array.
+{
+    if (arr == NULL)
     {
-        for (j = 0; j < mat->col; j++)
-            mat->m[i][j] = a->m[i][j] + b->m[i][j];
+        error_message_la(128, ERRMSS02);
+
+        return;
     }
 
-    return mat;
+    LA_STATS_COUNT(128);
+
+    LA_CHANGED(arr);
 }
 
-Matrix* subtract_matrix(Matrix *a, Matrix *b)       // Subtracts two matrixes and saves the result as a new one.
+Array* get_array(char *name)        // Get an array from a 'txt' file.
 {
-    register int i, j;
+    register int i;
+    int len;
 
-    Matrix *mat;
+    FILE *filin;
+    Array *ar;
 
-    if (a == NULL || b == NULL)
-    {
-        error_message_la(25, ERRMSS04);
+    LA_STATS_START(4);
 
-        return NULL;
-    }
+    filin = fopen(name, "r");
 
-    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    if (filin == NULL)
     {
-        error_message_la(25, "incompatible dimensions for a matrix subtraction!");
+        error_message_la(4, ERRMSS03);
 
-        return NULL;
+        exit(4);
     }
 
-    mat = create_matrix(a->row, a->col);
+    fscanf(filin, "%d", &len);
 
-    for (i = 0; i < mat->row; i++)
-    {
-        for (j = 0; j < mat->col; j++)
-            mat->m[i][j] = a->m[i][j] - b->m[i][j];
-    }
+    ar = create_array(len);
 
-    return mat;
+    for (i = 0; i < len; i++)
+        fscanf(filin, " %lf", &ar->a[i]);
+
+    fclose(filin);
+
+    LA_STATS_STOP(4, 0);
+
+    return ar;
 }
 
-Matrix* rnumber_times_matrix(double num, Matrix *mat)       // Multiplies a real number by a matrix and saves the result as a new matrix.
+void print_array(Array *arr)        // Shows an array on the screen.
 {
-    register int i, j;
-
-    Matrix *m;
+    register int i;
 
-    if (mat == NULL)
+    if (arr == NULL)
     {
-        error_message_la(26, ERRMSS04);
+        printf("\n\nNULL array informed to print!\n");
 
-        return NULL;
+        return;
     }
 
-    m = create_matrix(mat->row, mat->col);
+    printf("\n\n");
 
-    for (i = 0; i < m->row; i++)
-    {
-        for (j = 0; j < m->col; j++)
-            m->m[i][j] = num * mat->m[i][j];
-    }
+    for (i = 0; i < arr->len; i++)
+        printf("%lf\t", arr->a[i]);
 
-    return m;
+    printf("\n");
 }
 
-Matrix* matrix_times_matrix(Matrix *a, Matrix *b)   // Multiplies two matrixes and saves the result as a new one.
+Matrix* create_matrix(int m, int n)         // Creates a matrix with given dimensions.
 {
-    register int i, j, k;
+    register int i;
 
     Matrix *mat;
 
-    if (a == NULL || b == NULL)
+    if (m <= 0 || n <= 0)
     {
-        error_message_la(27, ERRMSS04);
+        error_message_la(5, "incompatible dimensions for a matrix!");
 
         return NULL;
     }
 
-    if (a->col != b->row)                               // Tests the compatibility of dimensions.
+    LA_STATS_START(5);
+
+    mat = malloc(sizeof(Matrix));
+
+    if (mat == NULL)
     {
-        error_message_la(27, "incompatible dimensions for a matrix multiplication!");
+        error_message_la(5, ERRMSS01);
 
-        return NULL;
+        exit(5);
     }
 
-    mat = create_matrix(a->row, b->col);
+    mat->row = m;
 
-    for (i = 0; i < mat->row; i++)
+    mat->col = n;
+
+    mat->buffer = NULL;
+
+    mat->deleter = NULL;
+
+    mat->version = 1;
+
+    atomic_init(&mat->det_version, 0);
+
+    atomic_init(&mat->norm_version, 0);
+
+    atomic_init(&mat->lu_version, 0);
+
+    mat->m = calloc(m, sizeof(double*));
+
+    if (mat->m == NULL)
     {
-        for (j = 0; j < mat->col; j++)
+        error_message_la(5, ERRMSS01);
+
+        exit(5);
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        mat->m[i] = calloc(n, sizeof(double));
+
+        if (mat->m[i] == NULL)
         {
-            mat->m[i][j] = 0;
+            error_message_la(5, ERRMSS01);
 
-            for (k = 0; k < b->row; k++)
-                mat->m[i][j] += a->m[i][k] * b->m[k][j];
+            exit(5);
         }
     }
 
+    LA_STATS_BYTES(5, sizeof(Matrix) + (long long) m * sizeof(double*) + (long long) m * n * sizeof(double));
+
+    LA_STATS_STOP(5, 0);
+
     return mat;
 }
 
-Matrix* transpose_matrix(Matrix *mat)               // Transposes a matrix and saves the result as a new one.
+Matrix* create_identity_matrix(int ord)     // Creates an identity matrix of a given order.
 {
     register int i, j;
 
-    Matrix *m;
+    Matrix *mat;
 
-    if (mat == NULL)
+    if (ord <= 0)
     {
-        error_message_la(28, ERRMSS04);
+        error_message_la(6, "invalid order value informed for a matrix!");
 
         return NULL;
     }
 
-    m = create_matrix(mat->col, mat->row);
+    LA_STATS_START(6);
 
-    for (i = 0; i < m->row; i++)
+    mat = create_matrix(ord, ord);
+
+    for (i = 0; i < ord; i++)
     {
-        for (j = 0; j < m->col; j++)
-            m->m[i][j] = mat->m[j][i];
+        for (j = 0; j < ord; j++)
+        {
+            if (i == j)
+                mat->m[i][j] = 1;
+            else
+                mat->m[i][j] = 0;
+        }
     }
 
-    return m;
+    LA_STATS_STOP(6, 0);
+
+    return mat;
 }
 
-void over_sum_matrix(Matrix *a, Matrix *b)          // Sums two matrixes and overwrites the result in the first one.
+// Creates a matrix whose rows are in a given buffer: the row 'i' starts at
+// 'buffer + i * stride'.
+Matrix* wrap_matrix(double *buffer, int m, int n, int stride, void (*deleter)(void *buffer))
 {
-    register int i, j;
+    register int i;
 
-    if (a == NULL || b == NULL)
+    Matrix *mat;
+
+    if (buffer == NULL)
     {
-        error_message_la(29, ERRMSS04);
+        error_message_la(126, "NULL buffer informed!");
 
-        return;
+        return NULL;
     }
-
-    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    else if (m <= 0 || n <= 0 || stride < n)
     {
-        error_message_la(29, "incompatible dimensions for a matrix sum!");
+        error_message_la(126, "incompatible dimensions for a matrix!");
 
-        return;
+        return NULL;
     }
 
-    for (i = 0; i < a->row; i++)
-    {
-        for (j = 0; j < a->col; j++)
-            a->m[i][j] += b->m[i][j];
-    }
-}
+    LA_STATS_START(126);
 
-void over_subtract_matrix(Matrix *a, Matrix *b)     // Subtracts two matrixes and overwrites the result in the first one.
-{
-    register int i, j;
+    mat = malloc(sizeof(Matrix));
 
-    if (a == NULL || b == NULL)
+    if (mat == NULL)
     {
-        error_message_la(30, ERRMSS04);
+        error_message_la(126, ERRMSS01);
 
-        return;
+        exit(126);
     }
 
-    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
-    {
-        error_message_la(30, "incompatible dimensions for a matrix subtraction!");
+    mat->row = m;
 
-        return;
-    }
+    mat->col = n;
 
-    for (i = 0; i < a->row; i++)
+    mat->buffer = buffer;
+
+    mat->deleter = deleter;
+
+    mat->version = 1;
+
+    atomic_init(&mat->det_version, 0);
+
+    atomic_init(&mat->norm_version, 0);
+
+    atomic_init(&mat->lu_version, 0);
+
+    mat->m = malloc(m * sizeof(double*));
+
+    if (mat->m == NULL)
     {
-        for (j = 0; j < a->col; j++)
-            a->m[i][j] -= b->m[i][j];
+        error_message_la(126, ERRMSS01);
+
+        exit(126);
     }
+
+    for (i = 0; i < m; i++)
+        mat->m[i] = buffer + (size_t) i * stride;
+
+    LA_STATS_BYTES(126, sizeof(Matrix) + (long long) m * sizeof(double*));
+
+    LA_STATS_STOP(126, 0);
+
+    return mat;
 }
 
-void over_rnumber_times_matrix(double num, Matrix *mat)     // Multiplies a real number by a matrix and overwrites the result in the original matrix.
+Matrix* create_matrix_uninitialized(int m, int n)   // Creates a matrix with given dimensions without setting its elements.
 {
-    register int i, j;
+    register int i;
 
-    if (mat == NULL)
+    Matrix *mat;
+
+    if (m <= 0 || n <= 0)
     {
-        error_message_la(31, ERRMSS04);
+        error_message_la(127, "incompatible dimensions for a matrix!");
 
-        return;
+        return NULL;
     }
 
-    for (i = 0; i < mat->row; i++)
+    LA_STATS_START(127);
+
+    mat = malloc(sizeof(Matrix));
+
+    if (mat == NULL)
     {
-        for (j = 0; j < mat->col; j++)
-            mat->m[i][j] *= num;
+        error_message_la(127, ERRMSS01);
+
+        exit(127);
     }
-}
 
-void over_matrix_times_matrix(Matrix *a, Matrix *b)     // Multiplies two matrixes and overwrites the result in the first one.
-{
-    register int i, j, k;
+    mat->row = m;
 
-    Matrix *tempmat;
+    mat->col = n;
 
-    if (a == NULL || b == NULL)
-    {
-        error_message_la(32, ERRMSS04);
+    mat->buffer = NULL;
 
-        return;
-    }
+    mat->deleter = NULL;
 
-    if (a->col != b->row)                   // Tests the compatibility of dimensions.
+    mat->version = 1;
+
+    atomic_init(&mat->det_version, 0);
+
+    atomic_init(&mat->norm_version, 0);
+
+    atomic_init(&mat->lu_version, 0);
+
+    mat->m = malloc(m * sizeof(double*));
+
+    if (mat->m == NULL)
     {
-        error_message_la(32, "incompatible dimensions for a matrix multiplication!");
+        error_message_la(127, ERRMSS01);
 
-        return;
+        exit(127);
     }
-    else if (b->row != b->col)                  // Only works if the second matrix is square.
+
+    for (i = 0; i < m; i++)
     {
-        error_message_la(32, ERRMSS05);
+        mat->m[i] = malloc(n * sizeof(double));
 
-        printf("\nThe second matrix must have the same number of rows and columns.\n");
+        if (mat->m[i] == NULL)
+        {
+            error_message_la(127, ERRMSS01);
 
-        return;
+            exit(127);
+        }
     }
 
-    tempmat = create_matrix(a->row, a->col);
+    LA_STATS_BYTES(127, sizeof(Matrix) + (long long) m * sizeof(double*) + (long long) m * n * sizeof(double));
+
+    LA_STATS_STOP(127, 0);
+
+    return mat;
+}
 
-    for (i = 0; i < a->row; i++)            // Multiplication
+void free_matrix(Matrix *mat)       // Deallocates memory previously used for a matrix.
+{
+    if (mat != NULL)
     {
-        for (j = 0; j < a->col; j++)
-        {
-            tempmat->m[i][j] = 0;
+        register int i;
 
-            for (k = 0; k < b->row; k++)
-                tempmat->m[i][j] += a->m[i][k] * b->m[k][j];
+        if (mat->buffer == NULL)
+        {
+            for (i = 0; i < mat->row; i++)
+                free(mat->m[i]);
         }
+        else if (mat->deleter != NULL)
+            mat->deleter(mat->buffer);
+
+        free(mat->m);
+
+        free(mat);
     }
+}
 
-    over_copy_matrix(tempmat, a);           // Overwriting
+int matrix_row_number(Matrix *mat)      // Gives the number of rows of a matrix.
+{
+    if (mat == NULL)
+        return 0;
+    else
+        return mat->row;
+}
 
-    free_matrix(tempmat);
+int matrix_column_number(Matrix *mat)   // Gives the number of columns of a matrix.
+{
+    if (mat == NULL)
+        return 0;
+    else
+        return mat->col;
 }
 
-void over_transpose_matrix(Matrix *mat)         // Transposes a matrix and overwrites the result in the original one.
+unsigned long long matrix_version(Matrix *mat)  // Gives the counter of changes of a matrix.
 {
-    register int i, j;
+    if (mat == NULL)
+        return 0;
 
-    Matrix *tempmat;
+    LA_STATS_COUNT(110);
 
+    return mat->version;
+}
+
+void insert_in_matrix(double a, Matrix *mat, int i, int j)      // Inserts a value in a matrix in a given position.
+{
     if (mat == NULL)
     {
-        error_message_la(33, ERRMSS04);
+        error_message_la(7, ERRMSS04);
 
         return;
     }
-
-    if (mat->row != mat->col)                       // Only works if the matrix is square.
+    else if (i < 0 || i >= mat->row || j < 0 || j >= mat->col)
     {
-        error_message_la(33, ERRMSS05);
-
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+        error_message_la(7, "inexistent position in the matrix!");
 
         return;
     }
 
-    tempmat = create_matrix(mat->col, mat->row);
-
-    for (i = 0; i < mat->row; i++)                  // Transposition
-    {
-        for (j = 0; j < mat->col; j++)
-            tempmat->m[i][j] = mat->m[j][i];
-    }
+    LA_STATS_COUNT(7);
 
-    over_copy_matrix(tempmat, mat);                 // Overwriting
+    mat->m[i][j] = a;
 
-    free_matrix(tempmat);
+    LA_CHANGED(mat);
 }
 
-// Other operations:
-
-double scalar_product(Array *a, Array *b)   // Calculates the scalar product of two vectors (arrays).
+double get_from_matrix(Matrix *mat, int i, int j)           // Gets a value in a matrix from a given position.
 {
-    register int i;
-
-    double spro = 0;
-
-    if (a == NULL || b == NULL)
+    if (mat == NULL)
     {
-        error_message_la(34, ERRMSS02);
+        error_message_la(8, ERRMSS04);
 
         return 0;
     }
-    else if (a->len != b->len)                  // Tests the compatibility of dimensions.
+    else if (i < 0 || i >= mat->row || j < 0 || j >= mat->col)
     {
-        error_message_la(34, "incompatible dimensions for scalar product!");
+        error_message_la(8, "inexistent position in the matrix!");
 
         return 0;
     }
 
-    for (i = 0; i < a->len; i++)                // Scalar product
-        spro += a->a[i] * b->a[i];
+    LA_STATS_COUNT(8);
 
-    return spro;
+    return mat->m[i][j];
 }
 
-Array* vector_product(Array *a, Array *b)   // Calculates the vector product of two vectors (arrays).
+static int block_check_la(int nmbr, Matrix *mat, int i, int j, int rows, int cols, double *values)  // Checks the arguments of the bulk accessors.
 {
-    Array *prod;
+    if (mat == NULL)
+    {
+        error_message_la(nmbr, ERRMSS04);
 
-    if (a == NULL || b == NULL)
+        return 0;
+    }
+    else if (values == NULL)
     {
-        error_message_la(46, ERRMSS02);
+        error_message_la(nmbr, "NULL buffer informed!");
 
-        return NULL;
+        return 0;
     }
-    if (a->len != 3 || b->len != 3)             // Vector product is defined only for three-dimensional vectors.
+    else if (rows < 0 || cols < 0 || i < 0 || j < 0 || i > mat->row - rows || j > mat->col - cols)
     {
-        error_message_la(46, "incompatible dimensions for vector product!");
+        error_message_la(nmbr, "inexistent position in the matrix!");
 
-        return NULL;
+        return 0;
     }
 
-    prod = create_array(3);
+    return 1;
+}
 
-    prod->a[0] = a->a[1] * b->a[2] - a->a[2] * b->a[1];
+// Copies a block of 'rows x cols' elements from a buffer, whose rows start every
+// 'ld' elements, to a matrix from position (i, j), or the opposite.
+static void block_copy_la(Matrix *mat, int i, int j, int rows, int cols, double *values, int ld, int set)
+{
+    register int r;
 
-    prod->a[1] = a->a[2] * b->a[0] - a->a[0] * b->a[2];
+    for (r = 0; r < rows; r++)
+    {
+        if (set)
+            memcpy(mat->m[i + r] + j, values + (size_t) r * ld, cols * sizeof(double));
+        else
+            memcpy(values + (size_t) r * ld, mat->m[i + r] + j, cols * sizeof(double));
+    }
+}
 
-    prod->a[2] = a->a[0] * b->a[1] - a->a[1] * b->a[0];
+void set_matrix_row(Matrix *mat, int i, double *values)    // Copies a buffer to a row of a matrix.
+{
+    if (!block_check_la(112, mat, i, 0, 1, (mat != NULL) ? mat->col : 0, values))
+        return;
 
-    return prod;
+    LA_STATS_COUNT(112);
+
+    block_copy_la(mat, i, 0, 1, mat->col, values, mat->col, 1);
+
+    LA_CHANGED(mat);
 }
 
-double euclidean_norm(Array *arr)       // Calculates the euclidean norm of a vector (array).
+void get_matrix_row(Matrix *mat, int i, double *values)    // Copies a row of a matrix to a buffer.
 {
-    register int i;
+    if (!block_check_la(113, mat, i, 0, 1, (mat != NULL) ? mat->col : 0, values))
+        return;
 
-    double norm = 0;
+    LA_STATS_COUNT(113);
 
-    if (arr == NULL)
-    {
-        error_message_la(35, ERRMSS02);
+    block_copy_la(mat, i, 0, 1, mat->col, values, mat->col, 0);
+}
 
-        return 0;
-    }
+void set_matrix_column(Matrix *mat, int j, double *values)     // Copies a buffer to a column of a matrix.
+{
+    if (!block_check_la(114, mat, 0, j, (mat != NULL) ? mat->row : 0, 1, values))
+        return;
 
-    for (i = 0; i < arr->len; i++)          // Euclidean norm
-        norm += arr->a[i] * arr->a[i];
+    LA_STATS_COUNT(114);
 
-    norm = sqrt(norm);
+    block_copy_la(mat, 0, j, mat->row, 1, values, 1, 1);
 
-    return norm;
+    LA_CHANGED(mat);
 }
 
-double cosine_similarity(Array *a, Array *b)    // Determines the cosine of the angle between two vectors (arrays).
+void get_matrix_column(Matrix *mat, int j, double *values)     // Copies a column of a matrix to a buffer.
 {
-    double anrm, bnrm, co;
+    if (!block_check_la(115, mat, 0, j, (mat != NULL) ? mat->row : 0, 1, values))
+        return;
 
-    if (a == NULL || b == NULL)
+    LA_STATS_COUNT(115);
+
+    block_copy_la(mat, 0, j, mat->row, 1, values, 1, 0);
+}
+
+void set_matrix_block(Matrix *mat, int i, int j, int rows, int cols, double *values, int ld)   // Copies a buffer to a block of a matrix.
+{
+    if (!block_check_la(116, mat, i, j, rows, cols, values))
+        return;
+    else if (ld < cols)
     {
-        error_message_la(36, ERRMSS02);
+        error_message_la(116, "invalid distance between the rows of the buffer!");
 
-        return 100000;
+        return;
     }
 
-    anrm = euclidean_norm(a);       // Calculates the euclidean norm of the two vectors.
+    LA_STATS_COUNT(116);
 
-    bnrm = euclidean_norm(b);
+    block_copy_la(mat, i, j, rows, cols, values, ld, 1);
 
-    if (anrm == 0 || bnrm == 0)
-    {
-        error_message_la(36, "vector with zero length informed!");
+    LA_CHANGED(mat);
+}
 
-        printf("\nThere is no cosine value available.\n");
+void get_matrix_block(Matrix *mat, int i, int j, int rows, int cols, double *values, int ld)   // Copies a block of a matrix to a buffer.
+{
+    if (!block_check_la(117, mat, i, j, rows, cols, values))
+        return;
+    else if (ld < cols)
+    {
+        error_message_la(117, "invalid distance between the rows of the buffer!");
 
-        return 100000;
+        return;
     }
-    else
-        co = scalar_product(a, b) / (anrm * bnrm);      // Cosine similarity
 
-    return co;
+    LA_STATS_COUNT(117);
+
+    block_copy_la(mat, i, j, rows, cols, values, ld, 0);
 }
 
-void swap_rows(Matrix *mat, int a, int b)           // Swaps two rows of a matrix.
+void set_matrix_buffer(Matrix *mat, double *values)    // Copies a buffer, by rows, to all the elements of a matrix.
 {
-    register int j;
-    double temp;
+    if (!block_check_la(118, mat, 0, 0, 0, 0, values))
+        return;
 
-    if (mat == NULL)
-    {
-        error_message_la(37, ERRMSS04);
+    LA_STATS_COUNT(118);
 
-        exit(37);
-    }
-    else if (a >= mat->row || a < 0 || b >= mat->row || b < 0)  // Tests if the rows exist.
-    {
-        error_message_la(37, "invalid row number!");
+    block_copy_la(mat, 0, 0, mat->row, mat->col, values, mat->col, 1);
 
-        exit(37);
-    }
+    LA_CHANGED(mat);
+}
 
-    for (j = 0; j < mat->col; j++)                              // Swaps the rows.
-    {
-        temp = mat->m[a][j];
+void get_matrix_buffer(Matrix *mat, double *values)    // Copies all the elements of a matrix to a buffer, by rows.
+{
+    if (!block_check_la(119, mat, 0, 0, 0, 0, values))
+        return;
 
-        mat->m[a][j] = mat->m[b][j];
+    LA_STATS_COUNT(119);
 
-        mat->m[b][j] = temp;
-    }
+    block_copy_la(mat, 0, 0, mat->row, mat->col, values, mat->col, 0);
 }
 
-int gaussian_elimination(Matrix *mat)   // Transforms a square matrix into an upper triangular matrix, if it is possible.
+double* matrix_row_pointer(Matrix *mat, int i)  // Gives the elements of a row of a matrix.
 {
-    register i, j, k;
-    int correction = 1;                     // This can be used for a correction in the calculation of a determinant if necessary.
+    if (mat == NULL)
+    {
+        error_message_la(123, ERRMSS04);
+
+        return NULL;
+    }
+    else if (i < 0 || i >= mat->row)
+    {
+        error_message_la(123, "inexistent position in the matrix!");
+
+        return NULL;
+    }
+
+    LA_STATS_COUNT(123);
+
+    return mat->m[i];
+}
+
+void matrix_changed(Matrix *mat)    // Records a change made directly to the elements of a matrix.
+{
+    if (mat == NULL)
+    {
+        error_message_la(129, ERRMSS04);
+
+        return;
+    }
+
+    LA_STATS_COUNT(129);
+
+    LA_CHANGED(mat);
+}
+
+#define COMPRESSED_MAGIC "LINALGCM"                             // Start of the files of 'save_compressed_matrix'
+
+Matrix* get_matrix(char *name)      // Get a matrix from a 'txt' file.
+{
+    char magic[8];
+
+    Matrix *mat;
+    FILE *filin;
+    MatrixReader *rd;
+
+    LA_STATS_START(9);
+
+    filin = fopen(name, "r");
+
+    if (filin == NULL)
+    {
+        error_message_la(9, ERRMSS03);
+
+        exit(9);
+    }
+
+    if (fread(magic, 1, 8, filin) == 8 && memcmp(magic, COMPRESSED_MAGIC, 8) == 0)
+    {
+        fclose(filin);
+
+        mat = get_compressed_matrix(name);
+
+        LA_STATS_STOP(9, 0);
+
+        return mat;
+    }
+
+    rewind(filin);
+
+    rd = open_matrix_reader(filin);                 // Also reads the binary files of 'save_matrix'.
+
+    if (rd == NULL)
+    {
+        fclose(filin);
+
+        LA_STATS_STOP(9, 0);
+
+        return NULL;
+    }
+
+    mat = create_matrix(matrix_reader_row_number(rd), matrix_reader_column_number(rd));
+
+    if (read_matrix_rows(rd, mat) < 0)              // Truncated or malformed file
+    {
+        free_matrix(mat);
+
+        mat = NULL;
+    }
+
+    free_matrix_reader(rd);
+
+    fclose(filin);
+
+    LA_STATS_STOP(9, 0);
+
+    return mat;
+}
+
+void print_matrix(Matrix *mat)      // Shows a matrix on the screen.
+{
+    register int i, j;
+
+    if (mat == NULL)
+    {
+        printf("\n\nNULL matrix informed to print!\n");
+
+        return;
+    }
+
+    printf("\n\n");
+
+    for (i = 0; i < mat->row; i++)
+    {
+        for (j = 0; j < mat->col; j++)
+            printf("%lf\t", mat->m[i][j]);
+
+        printf("\n");
+    }
+}
+
+static void error_message_la(int nmbr, char *mssg)  // Shows an error message indicating the function from where it came.
+{
+    if (mssg == NULL)
+    {
+        error_message_la(0, "NULL string informed!");
+
+        return;
+    }
+
+    printf("\n\n** Error **\n** [LA%04d]: %s **\n\a", nmbr, mssg);
+}
+
+// Copy functions:
+
+Array* copy_array(Array *arr)       // Copies an array as a new one.
+{
+    register i;
+    Array *arrcp;
+
+    if (arr == NULL)
+    {
+        error_message_la(10, ERRMSS02);
+
+        return NULL;
+    }
+
+    LA_STATS_START(10);
+
+    arrcp = create_array(arr->len);
+
+    for (i = 0; i < arr->len; i++)
+        arrcp->a[i] = arr->a[i];
+
+    LA_STATS_STOP(10, 0);
+
+    return arrcp;
+}
+
+void over_copy_array(Array *cpy, Array *pst)        // Copies an array in a pre-existing one, overwriting it.
+{
+    register i;
+
+    if (cpy == NULL || pst == NULL)
+    {
+        error_message_la(11, ERRMSS02);
+
+        return;
+    }
+    else if (cpy->len != pst->len)
+    {
+        error_message_la(11, ERRMSS05);
+
+        printf("\nThe destination array must have the same number of elements of the original one.\n");
+
+        exit(11);
+    }
+
+    LA_STATS_START(11);
+
+    LA_CHANGED(pst);
+
+    for (i = 0; i < cpy->len; i++)
+        pst->a[i] = cpy->a[i];
+
+    LA_STATS_STOP(11, 0);
+}
+
+Matrix* copy_matrix(Matrix *mat)        // Copies a matrix as a new one.
+{
+    register i, j;
+    Matrix *matcp;
+
+    if (mat == NULL)
+    {
+        error_message_la(12, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(12);
+
+    matcp = create_matrix(mat->row, mat->col);
+
+    for (i = 0; i < mat->row; i++)
+    {
+        for (j = 0; j < mat->col; j++)
+            matcp->m[i][j] = mat->m[i][j];
+    }
+
+    LA_STATS_STOP(12, 0);
+
+    return matcp;
+}
+
+void over_copy_matrix(Matrix *cpy, Matrix *pst)     // Copies a matrix in a pre-existing one, overwriting it.
+{
+    register i, j;
+
+    if (cpy == NULL || pst == NULL)
+    {
+        error_message_la(13, ERRMSS04);
+
+        return;
+    }
+    else if (cpy->row != pst->row || cpy->col != pst->col)
+    {
+        error_message_la(13, ERRMSS05);
+
+        printf("\nThe destination matrix must have the same number of rows and columns of the original one.\n");
+
+        exit(13);
+    }
+
+    LA_STATS_START(13);
+
+    LA_CHANGED(pst);
+
+    for (i = 0; i < cpy->row; i++)
+    {
+        for (j = 0; j < cpy->col; j++)
+            pst->m[i][j] = cpy->m[i][j];
+    }
+
+    LA_STATS_STOP(13, 0);
+}
+
+// Arithmetic operation functions:
+
+Array* sum_array(Array *a, Array *b)            // Sums two arrays and saves the result as a new one.
+{
+    Array *ar;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(14, ERRMSS02);
+
+        return NULL;
+    }
+
+    if (a->len != b->len)                           // Tests the compatibility of dimensions.
+    {
+        error_message_la(14, "incompatible dimensions for an array sum!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(14);
+
+    ar = create_array(a->len);
+
+    kernels()->add(a->a, b->a, ar->a, ar->len);
+
+    LA_STATS_STOP(14, a->len);
+
+    return ar;
+}
+
+Array* subtract_array(Array *a, Array *b)       // Subtracts two arrays and saves the result as a new one.
+{
+    Array *ar;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(15, ERRMSS02);
+
+        return NULL;
+    }
+
+    if (a->len != b->len)                           // Tests the compatibility of dimensions.
+    {
+        error_message_la(15, "incompatible dimensions for an array subtraction!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(15);
+
+    ar = create_array(a->len);
+
+    kernels()->sub(a->a, b->a, ar->a, ar->len);
+
+    LA_STATS_STOP(15, a->len);
+
+    return ar;
+}
+
+Array* rnumber_times_array(double num, Array *arr)  // Multiplies a real number by an array and saves the result as a new array.
+{
+    Array *ar;
+
+    if (arr == NULL)
+    {
+        error_message_la(16, ERRMSS02);
+
+        return NULL;
+    }
+
+    LA_STATS_START(16);
+
+    ar = create_array(arr->len);
+
+    kernels()->scale(num, arr->a, ar->a, ar->len);
+
+    LA_STATS_STOP(16, arr->len);
+
+    return ar;
+}
+
+static void dot4_la(double *a, double **x, int n, double *res)    // Scalar products of a vector with four others, reading it only once.
+{
+    register int i;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        s0 += a[i] * x[0][i];
+
+        s1 += a[i] * x[1][i];
+
+        s2 += a[i] * x[2][i];
+
+        s3 += a[i] * x[3][i];
+    }
+
+    res[0] = s0;
+
+    res[1] = s1;
+
+    res[2] = s2;
+
+    res[3] = s3;
+}
+
+static void gemv_kernel_la(double alpha, Matrix *mat, double *x, double beta, double *y)    // y = alpha * mat * x + beta * y
+{
+    register int i;
+
+    #pragma omp parallel for if ((double) mat->row * mat->col >= tuning_la.gemv_parallel)
+    for (i = 0; i < mat->row; i++)                  // Each row is read once, contiguously.
+    {
+        if (beta == 0)
+            y[i] = alpha * dot_la(mat->m[i], x, mat->col);
+        else
+            y[i] = alpha * dot_la(mat->m[i], x, mat->col) + beta * y[i];
+    }
+}
+
+static void gemv_transposed_kernel_la(double alpha, Matrix *mat, double *x, double beta, double *y)     // y = alpha * transpose(mat) * x + beta * y
+{
+    register int i, j;
+    int jb, jend;
+    double fctr;
+
+    #pragma omp parallel for private(i, j, jend, fctr) if ((double) mat->row * mat->col >= tuning_la.gemv_parallel)
+    for (jb = 0; jb < mat->col; jb += tuning_la.gemv_columns)     // Blocks of columns, so that each part of 'y' stays in cache while the rows stream by.
+    {
+        jend = (jb + tuning_la.gemv_columns < mat->col) ? jb + tuning_la.gemv_columns : mat->col;
+
+        for (j = jb; j < jend; j++)
+            y[j] = (beta == 0) ? 0 : beta * y[j];
+
+        for (i = 0; i < mat->row; i++)
+        {
+            fctr = alpha * x[i];
+
+            kernels()->axpy(fctr, mat->m[i] + jb, y + jb, jend - jb);
+        }
+    }
+}
+
+Array* array_times_matrix(Array *arr, Matrix *mat)      // Multiplies an array by a matrix and saves the result as a new array.
+{
+    Array *ar;
+
+    if (arr == NULL)
+    {
+        error_message_la(17, ERRMSS02);
+
+        return NULL;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(17, ERRMSS04);
+
+        return NULL;
+    }
+
+    if (arr->len != mat->row)                               // Tests the compatibility of dimensions.
+    {
+        error_message_la(17, "incompatible dimensions for an array-matrix multiplication!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(17);
+
+    ar = create_array(mat->col);
+
+    gemv_transposed_kernel_la(1, mat, arr->a, 0, ar->a);
+
+    LA_STATS_STOP(17, 2.0 * mat->row * mat->col);
+
+    return ar;
+}
+
+Array* matrix_times_array(Matrix *mat, Array *arr)      // Multiplies a matrix by an array and saves the result as a new array.
+{
+    Array *ar;
+
+    if (arr == NULL)
+    {
+        error_message_la(18, ERRMSS02);
+
+        return NULL;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(18, ERRMSS04);
+
+        return NULL;
+    }
+
+    if (mat->col != arr->len)                               // Tests the compatibility of dimensions.
+    {
+        error_message_la(18, "incompatible dimensions for a matrix-array multiplication!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(18);
+
+    ar = create_array(mat->row);
+
+    gemv_kernel_la(1, mat, arr->a, 0, ar->a);
+
+    LA_STATS_STOP(18, 2.0 * mat->row * mat->col);
+
+    return ar;
+}
+
+void over_sum_array(Array *a, Array *b)     // Sums two arrays and overwrites the result in the first one.
+{
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(19, ERRMSS02);
+
+        return;
+    }
+
+    if (a->len != b->len)                       // Tests the compatibility of dimensions.
+    {
+        error_message_la(19, "incompatible dimensions for an array sum!");
+
+        return;
+    }
+
+    LA_STATS_START(19);
+
+    LA_CHANGED(a);
+
+    kernels()->add(a->a, b->a, a->a, a->len);
+
+    LA_STATS_STOP(19, a->len);
+}
+
+void over_subtract_array(Array *a, Array *b)        // Subtracts two arrays and overwrites the result in the first one.
+{
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(20, ERRMSS02);
+
+        return NULL;
+    }
+
+    if (a->len != b->len)                               // Tests the compatibility of dimensions.
+    {
+        error_message_la(20, "incompatible dimensions for an array subtraction!");
+
+        return;
+    }
+
+    LA_STATS_START(20);
+
+    LA_CHANGED(a);
+
+    kernels()->sub(a->a, b->a, a->a, a->len);
+
+    LA_STATS_STOP(20, a->len);
+}
+
+void over_rnumber_times_array(double num, Array *arr)       // Multiplies a real number by an array and overwrites the result in the original array.
+{
+    if (arr == NULL)
+    {
+        error_message_la(21, ERRMSS02);
+
+        return;
+    }
+
+    LA_STATS_START(21);
+
+    LA_CHANGED(arr);
+
+    kernels()->scale(num, arr->a, arr->a, arr->len);
+
+    LA_STATS_STOP(21, arr->len);
+}
+
+void over_array_times_matrix(Array *arr, Matrix *mat)       // Multiplies an array by a matrix and overwrites the result in the first one.
+{
+    Array *tempar;
+
+    if (arr == NULL)
+    {
+        error_message_la(22, ERRMSS02);
+
+        return;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(22, ERRMSS04);
+
+        return;
+    }
+
+    if (arr->len != mat->row)                   // Tests the compatibility of dimensions.
+    {
+        error_message_la(22, "incompatible dimensions for an array-matrix multiplication!");
+
+        return;
+    }
+    else if (mat->row != mat->col)                  // Only works if the matrix is square.
+    {
+        error_message_la(22, ERRMSS05);
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(22);
+
+    LA_CHANGED(arr);
+
+    tempar = create_array(arr->len);
+
+    gemv_transposed_kernel_la(1, mat, arr->a, 0, tempar->a);   // Multiplication
+
+    over_copy_array(tempar, arr);               // Overwriting
+
+    free_array(tempar);
+
+    LA_STATS_STOP(22, 2.0 * mat->row * mat->col);
+}
+
+void over_matrix_times_array(Matrix *mat, Array *arr)   // Multiplies a matrix by an array and overwrites the result in the second one.
+{
+    Array *tempar;
+
+    if (arr == NULL)
+    {
+        error_message_la(23, ERRMSS02);
+
+        return;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(23, ERRMSS04);
+
+        return;
+    }
+
+    if (mat->col != arr->len)                   // Tests the compatibility of dimensions.
+    {
+        error_message_la(23, "incompatible dimensions for a matrix-array multiplication!");
+
+        return;
+    }
+    else if (mat->row != mat->col)                  // Only works if the matrix is square.
+    {
+        error_message_la(23, ERRMSS05);
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(23);
+
+    LA_CHANGED(arr);
+
+    tempar = create_array(arr->len);
+
+    gemv_kernel_la(1, mat, arr->a, 0, tempar->a);   // Multiplication
+
+    over_copy_array(tempar, arr);               // Overwriting
+
+    free_array(tempar);
+
+    LA_STATS_STOP(23, 2.0 * mat->row * mat->col);
+}
+
+void gemv(double alpha, Matrix *mat, Array *x, double beta, Array *y)  // Calculates 'y = alpha * mat * x + beta * y'.
+{
+    if (x == NULL || y == NULL)
+    {
+        error_message_la(59, ERRMSS02);
+
+        return;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(59, ERRMSS04);
+
+        return;
+    }
+
+    if (mat->col != x->len || mat->row != y->len)  // Tests the compatibility of dimensions.
+    {
+        error_message_la(59, "incompatible dimensions for a matrix-array multiplication!");
+
+        return;
+    }
+    else if (x == y)
+    {
+        error_message_la(59, "the same array informed as 'x' and 'y'!");
+
+        return;
+    }
+
+    LA_STATS_START(59);
+
+    LA_CHANGED(y);
+
+    gemv_kernel_la(alpha, mat, x->a, beta, y->a);
+
+    LA_STATS_STOP(59, 2.0 * mat->row * mat->col);
+}
+
+void gemv_transposed(double alpha, Matrix *mat, Array *x, double beta, Array *y)   // Calculates 'y = alpha * transpose(mat) * x + beta * y'.
+{
+    if (x == NULL || y == NULL)
+    {
+        error_message_la(60, ERRMSS02);
+
+        return;
+    }
+    else if (mat == NULL)
+    {
+        error_message_la(60, ERRMSS04);
+
+        return;
+    }
+
+    if (mat->row != x->len || mat->col != y->len)  // Tests the compatibility of dimensions.
+    {
+        error_message_la(60, "incompatible dimensions for an array-matrix multiplication!");
+
+        return;
+    }
+    else if (x == y)
+    {
+        error_message_la(60, "the same array informed as 'x' and 'y'!");
+
+        return;
+    }
+
+    LA_STATS_START(60);
+
+    LA_CHANGED(y);
+
+    gemv_transposed_kernel_la(alpha, mat, x->a, beta, y->a);
+
+    LA_STATS_STOP(60, 2.0 * mat->row * mat->col);
+}
+
+void gemv_multiple(double alpha, Matrix *mat, Matrix *xs, double beta, Matrix *ys)     // Calculates 'y = alpha * mat * x + beta * y' for several vectors.
+{
+    register int i, k, l;
+    double res[4];
+
+    if (mat == NULL || xs == NULL || ys == NULL)
+    {
+        error_message_la(61, ERRMSS04);
+
+        return;
+    }
+
+    if (xs->col != mat->col || ys->col != mat->row || xs->row != ys->row)  // Tests the compatibility of dimensions.
+    {
+        error_message_la(61, "incompatible dimensions for a matrix-array multiplication!");
+
+        return;
+    }
+    else if (xs == ys)
+    {
+        error_message_la(61, "the same matrix informed as 'xs' and 'ys'!");
+
+        return;
+    }
+
+    LA_STATS_START(61);
+
+    LA_CHANGED(ys);
+
+    #pragma omp parallel for private(k, l, res) if ((double) mat->row * mat->col >= tuning_la.gemv_parallel)
+    for (i = 0; i < mat->row; i++)                  // Each row of the matrix is used for all vectors while it is in cache.
+    {
+        for (k = 0; k < xs->row; k += 4)
+        {
+            if (k + 4 <= xs->row)                   // Four vectors for each pass over the row.
+                dot4_la(mat->m[i], xs->m + k, mat->col, res);
+            else
+            {
+                for (l = 0; k + l < xs->row; l++)
+                    res[l] = dot_la(mat->m[i], xs->m[k + l], mat->col);
+            }
+
+            for (l = 0; l < 4 && k + l < xs->row; l++)
+            {
+                if (beta == 0)
+                    ys->m[k + l][i] = alpha * res[l];
+                else
+                    ys->m[k + l][i] = alpha * res[l] + beta * ys->m[k + l][i];
+            }
+        }
+    }
+
+    LA_STATS_STOP(61, 2.0 * mat->row * mat->col * xs->row);
+}
+
+Matrix* sum_matrix(Matrix *a, Matrix *b)            // Sums two matrixes and saves the result as a new one.
+{
+    register int i;
+
+    Matrix *mat;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(24, ERRMSS04);
+
+        return NULL;
+    }
+
+    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    {
+        error_message_la(24, "incompatible dimensions for a matrix sum!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(24);
+
+    mat = create_matrix(a->row, a->col);
+
+    #pragma omp parallel for if ((double) a->row * a->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < mat->row; i++)
+        kernels()->add(a->m[i], b->m[i], mat->m[i], mat->col);
+
+    LA_STATS_STOP(24, (double) a->row * a->col);
+
+    return mat;
+}
+
+Matrix* subtract_matrix(Matrix *a, Matrix *b)       // Subtracts two matrixes and saves the result as a new one.
+{
+    register int i;
+
+    Matrix *mat;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(25, ERRMSS04);
+
+        return NULL;
+    }
+
+    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    {
+        error_message_la(25, "incompatible dimensions for a matrix subtraction!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(25);
+
+    mat = create_matrix(a->row, a->col);
+
+    #pragma omp parallel for if ((double) a->row * a->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < mat->row; i++)
+        kernels()->sub(a->m[i], b->m[i], mat->m[i], mat->col);
+
+    LA_STATS_STOP(25, (double) a->row * a->col);
+
+    return mat;
+}
+
+Matrix* rnumber_times_matrix(double num, Matrix *mat)       // Multiplies a real number by a matrix and saves the result as a new matrix.
+{
+    register int i;
+
+    Matrix *m;
+
+    if (mat == NULL)
+    {
+        error_message_la(26, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(26);
+
+    m = create_matrix(mat->row, mat->col);
+
+    #pragma omp parallel for if ((double) mat->row * mat->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < m->row; i++)
+        kernels()->scale(num, mat->m[i], m->m[i], m->col);
+
+    LA_STATS_STOP(26, (double) mat->row * mat->col);
+
+    return m;
+}
+
+// Strassen-Winograd method: 7 products of half size instead of 8 at each level,
+// down to 'strassen_cutoff'. It works on contiguous copies of the factors padded
+// with zeros, so that every dimension can be halved at every level, and the
+// temporaries of all levels come from one workspace allocated per product.
+
+static void block_add_la(int m, int n, double *a, int lda, double *b, int ldb, double *c, int ldc)    // c = a + b, for blocks in contiguous buffers
+{
+    register int i;
+
+    for (i = 0; i < m; i++)
+        kernels()->add(a + (size_t) i * lda, b + (size_t) i * ldb, c + (size_t) i * ldc, n);
+}
+
+static void block_sub_la(int m, int n, double *a, int lda, double *b, int ldb, double *c, int ldc)    // c = a - b, for blocks in contiguous buffers
+{
+    register int i;
+
+    for (i = 0; i < m; i++)
+        kernels()->sub(a + (size_t) i * lda, b + (size_t) i * ldb, c + (size_t) i * ldc, n);
+}
+
+static void block_gemm_la(int m, int k, int n, double *a, int lda, double *b, int ldb, double *c, int ldc)    // c = a * b, for blocks in contiguous buffers
+{
+    register int i, l;
+    double *ci;
+
+    #pragma omp parallel for private(l, ci) if ((double) m * k * n >= tuning_la.gemm_parallel)
+    for (i = 0; i < m; i++)
+    {
+        ci = c + (size_t) i * ldc;
+
+        memset(ci, 0, n * sizeof(double));
+
+        for (l = 0; l < k; l++)
+            kernels()->axpy(a[(size_t) i * lda + l], b + (size_t) l * ldb, ci, n);
+    }
+}
+
+// c = a * b, with 'a' m x k and 'b' k x n, all dimensions divisible by 2^levels.
+// 'work' must hold the temporaries of all levels (see 'strassen_product_la').
+static void strassen_la(int m, int k, int n, double *a, int lda, double *b, int ldb, double *c, int ldc, int levels, double *work)
+{
+    int mh = m / 2, kh = k / 2, nh = n / 2;
+    double *a11, *a12, *a21, *a22, *b11, *b12, *b21, *b22, *c11, *c12, *c21, *c22;
+    double *x, *y, *z, *rest;
+
+    if (levels == 0)
+    {
+        block_gemm_la(m, k, n, a, lda, b, ldb, c, ldc);
+
+        return;
+    }
+
+    if (task_checkpoint_la(task_current_la, -1))    // Cancelled asynchronous task
+        return;
+
+    a11 = a;
+    a12 = a + kh;
+    a21 = a + (size_t) mh * lda;
+    a22 = a21 + kh;
+
+    b11 = b;
+    b12 = b + nh;
+    b21 = b + (size_t) kh * ldb;
+    b22 = b21 + nh;
+
+    c11 = c;
+    c12 = c + nh;
+    c21 = c + (size_t) mh * ldc;
+    c22 = c21 + nh;
+
+    x = work;                                       // mh x kh
+    y = x + (size_t) mh * kh;                       // kh x nh
+    z = y + (size_t) kh * nh;                       // mh x nh
+    rest = z + (size_t) mh * nh;                    // Next levels
+
+    // Schedule of Douglas et al., with the quadrants of 'c' as temporaries:
+
+    block_sub_la(mh, kh, a11, lda, a21, lda, x, kh);                    // S3 = A11 - A21
+    block_sub_la(kh, nh, b22, ldb, b12, ldb, y, nh);                    // T3 = B22 - B12
+    strassen_la(mh, kh, nh, x, kh, y, nh, c21, ldc, levels - 1, rest);  // P7 = S3 * T3
+
+    block_add_la(mh, kh, a21, lda, a22, lda, x, kh);                    // S1 = A21 + A22
+    block_sub_la(kh, nh, b12, ldb, b11, ldb, y, nh);                    // T1 = B12 - B11
+    strassen_la(mh, kh, nh, x, kh, y, nh, c22, ldc, levels - 1, rest);  // P5 = S1 * T1
+
+    block_sub_la(mh, kh, x, kh, a11, lda, x, kh);                       // S2 = S1 - A11
+    block_sub_la(kh, nh, b22, ldb, y, nh, y, nh);                       // T2 = B22 - T1
+    strassen_la(mh, kh, nh, x, kh, y, nh, c12, ldc, levels - 1, rest);  // P6 = S2 * T2
+
+    block_sub_la(mh, kh, a12, lda, x, kh, x, kh);                       // S4 = A12 - S2
+    strassen_la(mh, kh, nh, x, kh, b22, ldb, c11, ldc, levels - 1, rest);   // P3 = S4 * B22
+
+    strassen_la(mh, kh, nh, a11, lda, b11, ldb, z, nh, levels - 1, rest);   // P1 = A11 * B11
+
+    block_add_la(mh, nh, z, nh, c12, ldc, c12, ldc);                    // U2 = P1 + P6
+    block_add_la(mh, nh, c12, ldc, c21, ldc, c21, ldc);                 // U3 = U2 + P7
+    block_add_la(mh, nh, c12, ldc, c22, ldc, c12, ldc);                 // U4 = U2 + P5
+    block_add_la(mh, nh, c21, ldc, c22, ldc, c22, ldc);                 // C22 = U3 + P5
+    block_add_la(mh, nh, c12, ldc, c11, ldc, c12, ldc);                 // C12 = U4 + P3
+
+    block_sub_la(kh, nh, y, nh, b21, ldb, y, nh);                       // T4 = T2 - B21
+    strassen_la(mh, kh, nh, a22, lda, y, nh, c11, ldc, levels - 1, rest);   // P4 = A22 * T4
+    block_sub_la(mh, nh, c21, ldc, c11, ldc, c21, ldc);                 // C21 = U3 - P4
+
+    strassen_la(mh, kh, nh, a12, lda, b21, ldb, c11, ldc, levels - 1, rest);    // P2 = A12 * B21
+    block_add_la(mh, nh, c11, ldc, z, nh, c11, ldc);                    // C11 = P1 + P2
+}
+
+static int strassen_levels_la(int m, int k, int n)     // Levels of recursion of a product, or '0' if Strassen's method is not used.
+{
+    int levels = 0, cut = tuning_la.strassen_cutoff;
+
+    if (cut == 0)
+        return 0;
+
+    while ((m >> levels) > cut && (k >> levels) > cut && (n >> levels) > cut && levels < 30)
+        levels++;
+
+    return levels;
+}
+
+static void strassen_product_la(int nmbr, Matrix *a, Matrix *b, Matrix *c, int levels)  // c = a * b by Strassen's method
+{
+    register int i, l;
+    int step = 1 << levels;
+    int mp = (a->row + step - 1) / step * step, kp = (a->col + step - 1) / step * step, np = (b->col + step - 1) / step * step;
+    size_t size = (size_t) mp * kp + (size_t) kp * np + (size_t) mp * np;
+    double *buf, *pa, *pb, *pc;
+
+    for (l = 1; l <= levels; l++)                   // Temporaries of each level
+        size += (size_t) (mp >> l) * (kp >> l) + (size_t) (kp >> l) * (np >> l) + (size_t) (mp >> l) * (np >> l);
+
+    buf = calloc(size, sizeof(double));             // The padding must be zero.
+
+    if (buf == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    LA_STATS_BYTES(nmbr, (long long) size * sizeof(double));
+
+    pa = buf;
+    pb = pa + (size_t) mp * kp;
+    pc = pb + (size_t) kp * np;
+
+    for (i = 0; i < a->row; i++)
+        memcpy(pa + (size_t) i * kp, a->m[i], a->col * sizeof(double));
+
+    for (i = 0; i < b->row; i++)
+        memcpy(pb + (size_t) i * np, b->m[i], b->col * sizeof(double));
+
+    strassen_la(mp, kp, np, pa, kp, pb, np, pc, np, levels, pc + (size_t) mp * np);
+
+    for (i = 0; i < c->row; i++)
+        memcpy(c->m[i], pc + (size_t) i * np, c->col * sizeof(double));
+
+    free(buf);
+}
+
+static void gemm_kernel_la(int nmbr, Matrix *a, Matrix *b, Matrix *c)  // c = a * b, by blocks that stay in cache or by Strassen's method.
+{
+    register int i, k;
+    int ib, jb, kb, iend, jend, kend;
+    int mb = tuning_la.gemm_block_rows, kbs = tuning_la.gemm_block_inner, nb = tuning_la.gemm_block_cols;
+    int levels = strassen_levels_la(a->row, a->col, b->col);
+    AsyncTask *task = task_current_la;              // The threads of OpenMP do not see it.
+
+    if (levels > 0)
+    {
+        strassen_product_la(nmbr, a, b, c, levels);
+
+        return;
+    }
+
+    #pragma omp parallel for private(i, k, jb, kb, iend, jend, kend) if ((double) a->row * a->col * b->col >= tuning_la.gemm_parallel)
+    for (ib = 0; ib < a->row; ib += mb)             // Each thread computes whole blocks of rows of 'c'.
+    {
+        iend = (ib + mb < a->row) ? ib + mb : a->row;
+
+        if (task_checkpoint_la(task, -1))           // Cancelled asynchronous task: the rest is skipped.
+            continue;
+
+        for (i = ib; i < iend; i++)
+            memset(c->m[i], 0, b->col * sizeof(double));
+
+        for (jb = 0; jb < b->col; jb += nb)
+        {
+            jend = (jb + nb < b->col) ? jb + nb : b->col;
+
+            for (kb = 0; kb < a->col; kb += kbs)    // The block of 'b' is used by all rows of the block of 'c' while it is in cache.
+            {
+                kend = (kb + kbs < a->col) ? kb + kbs : a->col;
+
+                for (i = ib; i < iend; i++)         // Rows of 'b' are added to the row of 'c', so that every access is contiguous.
+                {
+                    for (k = kb; k < kend; k++)
+                        kernels()->axpy(a->m[i][k], b->m[k] + jb, c->m[i] + jb, jend - jb);
+                }
+            }
+        }
+
+        task_advance_la(task, (double) (iend - ib) / a->row);
+    }
+}
+
+Matrix* matrix_times_matrix(Matrix *a, Matrix *b)   // Multiplies two matrixes and saves the result as a new one.
+{
+    Matrix *mat;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(27, ERRMSS04);
+
+        return NULL;
+    }
+
+    if (a->col != b->row)                               // Tests the compatibility of dimensions.
+    {
+        error_message_la(27, "incompatible dimensions for a matrix multiplication!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(27);
+
+    mat = create_matrix(a->row, b->col);
+
+    gemm_kernel_la(27, a, b, mat);
+
+    if (task_checkpoint_la(task_current_la, -1))    // Cancelled asynchronous task
+    {
+        free_matrix(mat);
+
+        LA_STATS_STOP(27, 0);
+
+        return NULL;
+    }
+
+    LA_STATS_STOP(27, 2.0 * a->row * a->col * b->col);
+
+    return mat;
+}
+
+void matrix_times_matrix_into(Matrix *a, Matrix *b, Matrix *c)     // Multiplies two matrixes and saves the result in a third one.
+{
+    if (a == NULL || b == NULL || c == NULL)
+    {
+        error_message_la(130, ERRMSS04);
+
+        return;
+    }
+
+    if (a->col != b->row || c->row != a->row || c->col != b->col)     // Tests the compatibility of dimensions.
+    {
+        error_message_la(130, "incompatible dimensions for a matrix multiplication!");
+
+        return;
+    }
+    else if (c == a || c == b)
+    {
+        error_message_la(130, "the result cannot be one of the factors!");
+
+        return;
+    }
+
+    LA_STATS_START(130);
+
+    LA_CHANGED(c);
+
+    gemm_kernel_la(130, a, b, c);
+
+    LA_STATS_STOP(130, 2.0 * a->row * a->col * b->col);
+}
+
+Matrix* transpose_matrix(Matrix *mat)               // Transposes a matrix and saves the result as a new one.
+{
+    register int i, j;
+
+    Matrix *m;
+
+    if (mat == NULL)
+    {
+        error_message_la(28, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(28);
+
+    m = create_matrix(mat->col, mat->row);
+
+    for (i = 0; i < m->row; i++)
+    {
+        for (j = 0; j < m->col; j++)
+            m->m[i][j] = mat->m[j][i];
+    }
+
+    LA_STATS_STOP(28, 0);
+
+    return m;
+}
+
+void over_sum_matrix(Matrix *a, Matrix *b)          // Sums two matrixes and overwrites the result in the first one.
+{
+    register int i;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(29, ERRMSS04);
+
+        return;
+    }
+
+    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    {
+        error_message_la(29, "incompatible dimensions for a matrix sum!");
+
+        return;
+    }
+
+    LA_STATS_START(29);
+
+    LA_CHANGED(a);
+
+    #pragma omp parallel for if ((double) a->row * a->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < a->row; i++)
+        kernels()->add(a->m[i], b->m[i], a->m[i], a->col);
+
+    LA_STATS_STOP(29, (double) a->row * a->col);
+}
+
+void over_subtract_matrix(Matrix *a, Matrix *b)     // Subtracts two matrixes and overwrites the result in the first one.
+{
+    register int i;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(30, ERRMSS04);
+
+        return;
+    }
+
+    if (a->row != b->row || a->col != b->col)           // Tests the compatibility of dimensions.
+    {
+        error_message_la(30, "incompatible dimensions for a matrix subtraction!");
+
+        return;
+    }
+
+    LA_STATS_START(30);
+
+    LA_CHANGED(a);
+
+    #pragma omp parallel for if ((double) a->row * a->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < a->row; i++)
+        kernels()->sub(a->m[i], b->m[i], a->m[i], a->col);
+
+    LA_STATS_STOP(30, (double) a->row * a->col);
+}
+
+void over_rnumber_times_matrix(double num, Matrix *mat)     // Multiplies a real number by a matrix and overwrites the result in the original matrix.
+{
+    register int i;
+
+    if (mat == NULL)
+    {
+        error_message_la(31, ERRMSS04);
+
+        return;
+    }
+
+    LA_STATS_START(31);
+
+    LA_CHANGED(mat);
+
+    #pragma omp parallel for if ((double) mat->row * mat->col >= tuning_la.elementwise_parallel)
+    for (i = 0; i < mat->row; i++)
+        kernels()->scale(num, mat->m[i], mat->m[i], mat->col);
+
+    LA_STATS_STOP(31, (double) mat->row * mat->col);
+}
+
+void over_matrix_times_matrix(Matrix *a, Matrix *b)     // Multiplies two matrixes and overwrites the result in the first one.
+{
+    Matrix *tempmat;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(32, ERRMSS04);
+
+        return;
+    }
+
+    if (a->col != b->row)                   // Tests the compatibility of dimensions.
+    {
+        error_message_la(32, "incompatible dimensions for a matrix multiplication!");
+
+        return;
+    }
+    else if (b->row != b->col)                  // Only works if the second matrix is square.
+    {
+        error_message_la(32, ERRMSS05);
+
+        printf("\nThe second matrix must have the same number of rows and columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(32);
+
+    LA_CHANGED(a);
+
+    tempmat = create_matrix(a->row, a->col);
+
+    gemm_kernel_la(32, a, b, tempmat);          // Multiplication
+
+    over_copy_matrix(tempmat, a);           // Overwriting
+
+    free_matrix(tempmat);
+
+    LA_STATS_STOP(32, 2.0 * a->row * a->col * b->col);
+}
+
+void over_transpose_matrix(Matrix *mat)         // Transposes a matrix and overwrites the result in the original one.
+{
+    register int i, j;
+
+    Matrix *tempmat;
+
+    if (mat == NULL)
+    {
+        error_message_la(33, ERRMSS04);
+
+        return;
+    }
+
+    if (mat->row != mat->col)                       // Only works if the matrix is square.
+    {
+        error_message_la(33, ERRMSS05);
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(33);
+
+    LA_CHANGED(mat);
+
+    tempmat = create_matrix(mat->col, mat->row);
+
+    for (i = 0; i < mat->row; i++)                  // Transposition
+    {
+        for (j = 0; j < mat->col; j++)
+            tempmat->m[i][j] = mat->m[j][i];
+    }
+
+    over_copy_matrix(tempmat, mat);                 // Overwriting
+
+    free_matrix(tempmat);
+
+    LA_STATS_STOP(33, 0);
+}
+
+// Other operations:
+
+double scalar_product(Array *a, Array *b)   // Calculates the scalar product of two vectors (arrays).
+{
+    double spro = 0;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(34, ERRMSS02);
+
+        return 0;
+    }
+    else if (a->len != b->len)                  // Tests the compatibility of dimensions.
+    {
+        error_message_la(34, "incompatible dimensions for scalar product!");
+
+        return 0;
+    }
+
+    LA_STATS_START(34);
+
+    spro = dot_la(a->a, b->a, a->len);          // Scalar product
+
+    LA_STATS_STOP(34, 2.0 * a->len);
+
+    return spro;
+}
+
+Array* vector_product(Array *a, Array *b)   // Calculates the vector product of two vectors (arrays).
+{
+    Array *prod;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(46, ERRMSS02);
+
+        return NULL;
+    }
+    if (a->len != 3 || b->len != 3)             // Vector product is defined only for three-dimensional vectors.
+    {
+        error_message_la(46, "incompatible dimensions for vector product!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(46);
+
+    prod = create_array(3);
+
+    prod->a[0] = a->a[1] * b->a[2] - a->a[2] * b->a[1];
+
+    prod->a[1] = a->a[2] * b->a[0] - a->a[0] * b->a[2];
+
+    prod->a[2] = a->a[0] * b->a[1] - a->a[1] * b->a[0];
+
+    LA_STATS_STOP(46, 9);
+
+    return prod;
+}
+
+double euclidean_norm(Array *arr)       // Calculates the euclidean norm of a vector (array).
+{
+    double norm = 0;
+
+    if (arr == NULL)
+    {
+        error_message_la(35, ERRMSS02);
+
+        return 0;
+    }
+
+    LA_STATS_START(35);
+
+    if (atomic_load(&arr->norm_version) == arr->version)   // Not changed since the last call
+    {
+        norm = atomic_load(&arr->norm);
+
+        LA_STATS_STOP(35, 0);
+
+        return norm;
+    }
+
+    norm = sqrt(dot_la(arr->a, arr->a, arr->len));     // Euclidean norm
+
+    atomic_store(&arr->norm, norm);
+
+    atomic_store(&arr->norm_version, arr->version);
+
+    LA_STATS_STOP(35, 2.0 * arr->len);
+
+    return norm;
+}
+
+double frobenius_norm(Matrix *mat)      // Calculates the Frobenius norm of a matrix.
+{
+    register int i;
+    double norm = 0;
+
+    if (mat == NULL)
+    {
+        error_message_la(111, ERRMSS04);
+
+        return 0;
+    }
+
+    LA_STATS_START(111);
+
+    if (atomic_load(&mat->norm_version) == mat->version)   // Not changed since the last call
+    {
+        norm = atomic_load(&mat->norm);
+
+        LA_STATS_STOP(111, 0);
+
+        return norm;
+    }
+
+    for (i = 0; i < mat->row; i++)
+        norm += dot_la(mat->m[i], mat->m[i], mat->col);
+
+    norm = sqrt(norm);
+
+    atomic_store(&mat->norm, norm);
+
+    atomic_store(&mat->norm_version, mat->version);
+
+    LA_STATS_STOP(111, 2.0 * mat->row * mat->col);
+
+    return norm;
+}
+
+double cosine_similarity(Array *a, Array *b)    // Determines the cosine of the angle between two vectors (arrays).
+{
+    double anrm, bnrm, co;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(36, ERRMSS02);
+
+        return 100000;
+    }
+
+    LA_STATS_START(36);
+
+    anrm = euclidean_norm(a);       // Calculates the euclidean norm of the two vectors.
+
+    bnrm = euclidean_norm(b);
+
+    if (anrm == 0 || bnrm == 0)
+    {
+        error_message_la(36, "vector with zero length informed!");
+
+        printf("\nThere is no cosine value available.\n");
+
+        LA_STATS_STOP(36, 0);
+
+        return 100000;
+    }
+    else
+        co = scalar_product(a, b) / (anrm * bnrm);      // Cosine similarity
+
+    LA_STATS_STOP(36, 6.0 * a->len);
+
+    return co;
+}
+
+void swap_rows(Matrix *mat, int a, int b)           // Swaps two rows of a matrix.
+{
+    double *temp;
+
+    if (mat == NULL)
+    {
+        error_message_la(37, ERRMSS04);
+
+        exit(37);
+    }
+    else if (a >= mat->row || a < 0 || b >= mat->row || b < 0)  // Tests if the rows exist.
+    {
+        error_message_la(37, "invalid row number!");
+
+        exit(37);
+    }
+
+    LA_STATS_START(37);
+
+    LA_CHANGED(mat);
+
+    if (mat->buffer != NULL)                                    // The rows must stay in their places in the buffer.
+    {
+        register int j;
+        double t;
+
+        for (j = 0; j < mat->col; j++)
+        {
+            t = mat->m[a][j];
+
+            mat->m[a][j] = mat->m[b][j];
+
+            mat->m[b][j] = t;
+        }
+
+        LA_STATS_STOP(37, 0);
+
+        return;
+    }
+
+    temp = mat->m[a];                                           // Swaps the references to the rows.
+
+    mat->m[a] = mat->m[b];
+
+    mat->m[b] = temp;
+
+    LA_STATS_STOP(37, 0);
+}
+
+static int valid_permutation_la(int *perm, int len)     // Tests if 'perm' has each index from '0' to 'len - 1' exactly once.
+{
+    register int i;
+    char *seen;
+
+    seen = calloc(len, sizeof(char));
+
+    if (seen == NULL)
+        return 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (perm[i] < 0 || perm[i] >= len || seen[perm[i]])
+            break;
+
+        seen[perm[i]] = 1;
+    }
+
+    free(seen);
+
+    return i == len;
+}
+
+void apply_permutation_to_array(Array *arr, int *perm)     // Rearranges the elements of an array according to a permutation.
+{
+    register int i;
+    double *temp;
+
+    if (arr == NULL)
+    {
+        error_message_la(64, ERRMSS02);
+
+        return;
+    }
+    else if (perm == NULL || !valid_permutation_la(perm, arr->len))
+    {
+        error_message_la(64, "invalid permutation informed!");
+
+        return;
+    }
+
+    LA_STATS_START(64);
+
+    LA_CHANGED(arr);
+
+    temp = malloc(arr->len * sizeof(double));
+
+    if (temp == NULL)
+    {
+        error_message_la(64, ERRMSS01);
+
+        exit(64);
+    }
+
+    for (i = 0; i < arr->len; i++)
+        temp[i] = arr->a[perm[i]];
+
+    for (i = 0; i < arr->len; i++)
+        arr->a[i] = temp[i];
+
+    free(temp);
+
+    LA_STATS_STOP(64, 0);
+}
+
+void apply_permutation_to_matrix(Matrix *mat, int *perm)   // Rearranges the rows of a matrix according to a permutation.
+{
+    register int i;
+    double **temp;
+
+    if (mat == NULL)
+    {
+        error_message_la(65, ERRMSS04);
+
+        return;
+    }
+    else if (perm == NULL || !valid_permutation_la(perm, mat->row))
+    {
+        error_message_la(65, "invalid permutation informed!");
+
+        return;
+    }
+
+    LA_STATS_START(65);
+
+    LA_CHANGED(mat);
+
+    if (mat->buffer != NULL)                        // The rows must stay in their places in the buffer.
+    {
+        double *rows = malloc((size_t) mat->row * mat->col * sizeof(double));
+
+        if (rows == NULL)
+        {
+            error_message_la(65, ERRMSS01);
+
+            exit(65);
+        }
+
+        for (i = 0; i < mat->row; i++)
+            memcpy(rows + (size_t) i * mat->col, mat->m[perm[i]], mat->col * sizeof(double));
+
+        for (i = 0; i < mat->row; i++)
+            memcpy(mat->m[i], rows + (size_t) i * mat->col, mat->col * sizeof(double));
+
+        free(rows);
+
+        LA_STATS_STOP(65, 0);
+
+        return;
+    }
+
+    temp = malloc(mat->row * sizeof(double*));
+
+    if (temp == NULL)
+    {
+        error_message_la(65, ERRMSS01);
+
+        exit(65);
+    }
+
+    for (i = 0; i < mat->row; i++)                  // Only the references to the rows are moved.
+        temp[i] = mat->m[perm[i]];
+
+    free(mat->m);
+
+    mat->m = temp;
+
+    LA_STATS_STOP(65, 0);
+}
+
+int gaussian_elimination(Matrix *mat)   // Transforms a square matrix into an upper triangular matrix, if it is possible.
+{
+    register i, j, k;
+    int correction = 1;                     // This can be used for a correction in the calculation of a determinant if necessary.
+    double fctr;
+
+    if (mat == NULL)
+    {
+        error_message_la(38, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(38);
+
+    LA_CHANGED(mat);
+
+    for (i = 0; i < mat->row; i++)
+    {
+        if (task_checkpoint_la(task_current_la, (double) i / mat->row))  // Cancelled asynchronous task: the caller checks it.
+            break;
+
+        if (mat->m[i][i] == 0 && i < mat->row - 1)  // Swaps rows, if necessary, to better organize the matrix.
+        {
+            for (k = i + 1; k < mat->row; k++)
+            {
+                if (mat->m[k][i] != 0)
+                {
+                    swap_rows(mat, i, k);
+
+                    correction = - correction;
+
+                    break;
+                }
+            }
+        }
+
+        if (mat->m[i][i] != 0 && i < mat->row - 1)
+        {
+            for (k = i + 1; k < mat->row; k++)      // Transforms into a triangular matrix.
+            {
+                if (mat->m[k][i] == 0)
+                    continue;
+                
+                fctr = - mat->m[k][i] / mat->m[i][i];
+                
+                for (j = i + 1; j < mat->col; j++)
+                    mat->m[k][j] += fctr * mat->m[i][j];
+
+                mat->m[k][i] = 0;
+            }
+        }
+    }
+
+    LA_STATS_STOP(38, 2.0 * mat->row * mat->row * mat->col / 3);
+
+    return correction;
+}
+
+int lu_decomposition(Matrix *mat, int *perm)   // Transforms a square matrix into its LU decomposition with partial pivoting.
+{
+    register int i, j, k;
+    int piv, sign = 1;
+    double fctr;
+
+    if (mat == NULL)
+    {
+        error_message_la(62, ERRMSS04);
+
+        return 0;
+    }
+    else if (perm == NULL)
+    {
+        error_message_la(62, "NULL permutation informed!");
+
+        return 0;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(62, "incompatible dimensions for a LU decomposition!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return 0;
+    }
+
+    LA_STATS_START(62);
+
+    LA_CHANGED(mat);
+
+    for (i = 0; i < mat->row; i++)
+        perm[i] = i;
+
+    for (k = 0; k < mat->row; k++)
+    {
+        piv = k;                                    // Searches for the largest element of the column.
+
+        for (i = k + 1; i < mat->row; i++)
+        {
+            if (fabs(mat->m[i][k]) > fabs(mat->m[piv][k]))
+                piv = i;
+        }
+
+        if (mat->m[piv][k] == 0)                    // Singular matrix
+        {
+            LA_STATS_STOP(62, 2.0 * k * mat->row * mat->row);
+
+            return 0;
+        }
+
+        if (piv != k)                               // Only the references are swapped; the pivot is recorded.
+        {
+            swap_rows(mat, k, piv);
+
+            i = perm[k];
+
+            perm[k] = perm[piv];
+
+            perm[piv] = i;
+
+            sign = - sign;
+        }
+
+        for (i = k + 1; i < mat->row; i++)
+        {
+            if (mat->m[i][k] == 0)
+                continue;
+
+            fctr = mat->m[i][k] /= mat->m[k][k];    // Multiplier, kept in 'L'.
+
+            for (j = k + 1; j < mat->col; j++)
+                mat->m[i][j] -= fctr * mat->m[k][j];
+        }
+    }
+
+    LA_STATS_STOP(62, 2.0 * mat->row * mat->row * mat->row / 3);
+
+    return sign;
+}
+
+void over_lu_solve(Matrix *lu, int *perm, Array *b)    // Solves a system given its LU decomposition.
+{
+    register int i;
+
+    if (lu == NULL)
+    {
+        error_message_la(63, ERRMSS04);
+
+        return;
+    }
+    else if (b == NULL)
+    {
+        error_message_la(63, ERRMSS02);
+
+        return;
+    }
+    else if (lu->row != lu->col || b->len != lu->row)  // Tests the compatibility of dimensions.
+    {
+        error_message_la(63, "incompatible dimensions to solve the system of equations!");
+
+        return;
+    }
+    else if (perm == NULL || !valid_permutation_la(perm, lu->row))
+    {
+        error_message_la(63, "invalid permutation informed!");
+
+        return;
+    }
+
+    LA_STATS_START(63);
+
+    LA_CHANGED(b);
+
+    apply_permutation_to_array(b, perm);            // The pivoting is applied to the right side only.
+
+    for (i = 0; i < lu->row; i++)                   // Forward substitution with 'L'
+        b->a[i] -= dot_la(lu->m[i], b->a, i);
+
+    for (i = lu->row - 1; i >= 0; i--)              // Back substitution with 'U'
+        b->a[i] = (b->a[i] - dot_la(lu->m[i] + i + 1, b->a + i + 1, lu->row - i - 1)) / lu->m[i][i];
+
+    LA_STATS_STOP(63, 2.0 * lu->row * lu->row);
+}
+
+// Factorization cache (see 'linalg_factor_cache'): LU decompositions of the
+// latest matrices used by 'determinant', 'inverse_matrix' and 'solve_system',
+// found by a hash of their elements and compared element by element. A matrix
+// whose version has not changed since it found its entry uses it at once.
+
+typedef struct factor_entry
+{
+	unsigned long long id;                                      // Remembered by the matrices (see 'struct matrix')
+
+	unsigned long long hash;
+
+	int n;
+
+	double *key;                                                // Copy of the matrix, 'n x n'
+
+	double *lu;                                                 // Its LU decomposition, with the rows in order
+
+	int *perm;
+
+	int sign;                                                   // '0' for singular matrices
+
+	long long bytes;
+
+	struct factor_entry *prev;                                  // List from the most to the least recently used
+
+	struct factor_entry *next;
+} FactorEntry;
+
+static pthread_mutex_t cache_lock_la = PTHREAD_MUTEX_INITIALIZER;
+
+static FactorEntry *cache_first_la = NULL, *cache_last_la = NULL;
+
+static atomic_llong cache_budget_la = 0;                       // Read without the lock by the functions that use the cache
+
+static long long cache_bytes_la = 0, cache_entries_la = 0;
+
+static long long cache_hits_la = 0, cache_misses_la = 0, cache_evictions_la = 0;
+
+static unsigned long long cache_serial_la = 0;                  // Identifier of the last entry
+
+static unsigned long long cache_hash_la(Matrix *mat, int n)    // Hash of the first 'n' columns of a matrix (FNV-1a by elements).
+{
+    register int i, j;
+    unsigned long long h = 14695981039346656037ULL ^ (unsigned long long) n, bits;
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            memcpy(&bits, &mat->m[i][j], sizeof(bits));
+
+            h = (h ^ bits) * 1099511628211ULL;
+        }
+    }
+
+    return h;
+}
+
+static int cache_same_la(FactorEntry *e, Matrix *mat, int n)   // Compares an entry with the first 'n' columns of a matrix.
+{
+    register int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (memcmp(e->key + (size_t) i * n, mat->m[i], n * sizeof(double)) != 0)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void cache_unlink_la(FactorEntry *e)     // Removes an entry from the list. The lock must be held.
+{
+    if (e->prev != NULL)
+        e->prev->next = e->next;
+    else
+        cache_first_la = e->next;
+
+    if (e->next != NULL)
+        e->next->prev = e->prev;
+    else
+        cache_last_la = e->prev;
+
+    cache_bytes_la -= e->bytes;
+
+    cache_entries_la--;
+}
+
+static void cache_push_la(FactorEntry *e)       // Puts an entry at the head of the list. The lock must be held.
+{
+    e->prev = NULL;
+
+    e->next = cache_first_la;
+
+    if (cache_first_la != NULL)
+        cache_first_la->prev = e;
+    else
+        cache_last_la = e;
+
+    cache_first_la = e;
+
+    cache_bytes_la += e->bytes;
+
+    cache_entries_la++;
+}
+
+static void cache_free_entry_la(FactorEntry *e)
+{
+    free(e->key);
+
+    free(e->lu);
+
+    free(e->perm);
+
+    free(e);
+}
+
+static void cache_trim_la(long long bytes)      // Evicts the least recently used entries until 'bytes' fit. The lock must be held.
+{
+    FactorEntry *e;
+
+    while (cache_last_la != NULL && cache_bytes_la + bytes > atomic_load(&cache_budget_la))
+    {
+        e = cache_last_la;
+
+        cache_unlink_la(e);
+
+        cache_free_entry_la(e);
+
+        cache_evictions_la++;
+    }
+}
+
+// Gives a new matrix with the LU decomposition of the first 'n' columns of a
+// matrix, as 'lu_decomposition', with a new permutation and the sign, taken from
+// the cache or calculated and saved in it. Returns NULL if the cache is disabled.
+static Matrix* cached_lu_la(int nmbr, Matrix *mat, int n, int **perm, int *sign)
+{
+    register int i;
+    unsigned long long hash, id;
+    long long bytes = sizeof(FactorEntry) + 2 * (long long) n * n * sizeof(double) + n * sizeof(int);
+
+    FactorEntry *e;
+    Matrix *lu;
+
+    if (atomic_load(&cache_budget_la) <= 0)
+        return NULL;
+
+    lu = create_matrix(n, n);
+
+    *perm = malloc(n * sizeof(int));
+
+    if (*perm == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    hash = 0;
+
+    pthread_mutex_lock(&cache_lock_la);
+
+    e = NULL;
+
+    if (atomic_load(&mat->lu_version) == mat->version)     // Not changed since its decomposition was found: no need to compare it.
+    {
+        id = atomic_load(&mat->lu_entry);
+
+        for (e = cache_first_la; e != NULL && (e->id != id || e->n != n); e = e->next);
+    }
+
+    if (e == NULL)
+    {
+        pthread_mutex_unlock(&cache_lock_la);
+
+        hash = cache_hash_la(mat, n);
+
+        pthread_mutex_lock(&cache_lock_la);
+
+        for (e = cache_first_la; e != NULL; e = e->next)
+        {
+            if (e->hash == hash && e->n == n && cache_same_la(e, mat, n))
+                break;
+        }
+    }
+
+    if (e != NULL)
+    {
+        cache_hits_la++;
+
+        atomic_store(&mat->lu_entry, e->id);
+
+        atomic_store(&mat->lu_version, mat->version);
+
+        cache_unlink_la(e);
+
+        cache_push_la(e);
+
+        for (i = 0; i < n; i++)
+            memcpy(lu->m[i], e->lu + (size_t) i * n, n * sizeof(double));
+
+        memcpy(*perm, e->perm, n * sizeof(int));
+
+        *sign = e->sign;
+
+        pthread_mutex_unlock(&cache_lock_la);
+
+        return lu;
+    }
+
+    cache_misses_la++;
+
+    pthread_mutex_unlock(&cache_lock_la);
+
+    for (i = 0; i < n; i++)
+        memcpy(lu->m[i], mat->m[i], n * sizeof(double));
+
+    *sign = lu_decomposition(lu, *perm);
+
+    if (bytes > atomic_load(&cache_budget_la))      // Larger decompositions are not kept.
+        return lu;
+
+    e = malloc(sizeof(FactorEntry));
+
+    if (e == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    e->hash = hash;
+
+    e->n = n;
+
+    e->sign = *sign;
+
+    e->bytes = bytes;
+
+    e->key = malloc((size_t) n * n * sizeof(double));
+
+    e->lu = malloc((size_t) n * n * sizeof(double));
+
+    e->perm = malloc(n * sizeof(int));
+
+    if (e->key == NULL || e->lu == NULL || e->perm == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        memcpy(e->key + (size_t) i * n, mat->m[i], n * sizeof(double));
+
+        memcpy(e->lu + (size_t) i * n, lu->m[i], n * sizeof(double));
+    }
+
+    memcpy(e->perm, *perm, n * sizeof(int));
+
+    pthread_mutex_lock(&cache_lock_la);
+
+    if (bytes <= atomic_load(&cache_budget_la))     // The cache may have been reduced meanwhile.
+    {
+        cache_trim_la(e->bytes);
+
+        e->id = ++cache_serial_la;
+
+        cache_push_la(e);
+
+        atomic_store(&mat->lu_entry, e->id);
+
+        atomic_store(&mat->lu_version, mat->version);
+
+        e = NULL;
+    }
+
+    pthread_mutex_unlock(&cache_lock_la);
+
+    if (e != NULL)
+        cache_free_entry_la(e);
+
+    return lu;
+}
+
+static Matrix* lu_inverse_la(Matrix *lu, int *perm)     // Calculates an inverse from a LU decomposition, by rows.
+{
+    register int i, j;
+    int n = lu->row;
+
+    Matrix *inv = create_matrix(n, n);
+
+    for (i = 0; i < n; i++)                         // Permutation matrix
+        inv->m[i][perm[i]] = 1;
+
+    for (i = 1; i < n; i++)                         // Forward substitution with 'L'
+    {
+        for (j = 0; j < i; j++)
+            kernels()->axpy(- lu->m[i][j], inv->m[j], inv->m[i], n);
+    }
+
+    for (i = n - 1; i >= 0; i--)                    // Back substitution with 'U'
+    {
+        for (j = i + 1; j < n; j++)
+            kernels()->axpy(- lu->m[i][j], inv->m[j], inv->m[i], n);
+
+        kernels()->scale(1 / lu->m[i][i], inv->m[i], inv->m[i], n);
+    }
+
+    return inv;
+}
+
+double determinant(Matrix *mat)         // Calculates the determinant of a square matrix.
+{
+    register i;
+    int corr, *perm;
+    double det = 1;
+    Matrix *tempmat;
+
+    if (mat == NULL)
+    {
+        error_message_la(39, ERRMSS04);
+
+        exit(39);
+    }
+    else if (mat->row != mat->col)          // Tests if the matrix is square.
+    {
+        error_message_la(39, "incompatible dimensions to calculate a determinant!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        exit(39);
+    }
+
+    LA_STATS_START(39);
+
+    if (atomic_load(&mat->det_version) == mat->version)    // Not changed since the last call
+    {
+        det = atomic_load(&mat->det);
+
+        LA_STATS_STOP(39, 0);
+
+        return det;
+    }
+
+    tempmat = cached_lu_la(39, mat, mat->row, &perm, &corr);
+
+    if (tempmat != NULL)                    // Decomposition from the factorization cache
+    {
+        for (i = 0; i < tempmat->row && corr != 0; i++)
+            det *= tempmat->m[i][i];
+
+        det *= corr;
+
+        free_matrix(tempmat);
+
+        free(perm);
+
+        atomic_store(&mat->det, det);
+
+        atomic_store(&mat->det_version, mat->version);
+
+        LA_STATS_STOP(39, mat->row);
+
+        return det;
+    }
+
+    tempmat = copy_matrix(mat);
+
+    corr = gaussian_elimination(tempmat);   // Transforms the matrix into an upper triangular one.
+
+    for (i = 0; i < tempmat->row; i++)      // Calculates the determinant.
+    {
+        det *= tempmat->m[i][i];
+
+        if (tempmat->m[i][i] == 0)
+            break;
+    }
+
+    det *= corr;                            // Corrects the signal.
+
+    free_matrix(tempmat);
+
+    atomic_store(&mat->det, det);
+
+    atomic_store(&mat->det_version, mat->version);
+
+    LA_STATS_STOP(39, 2.0 * mat->row * mat->row * mat->row / 3);
+
+    return det;
+}
+
+double over_determinant(Matrix *mat)    // Calculates the determinant of a square matrix, overwriting the operations in it.
+{
+    register i;
+    int corr;
+    double det = 1;
+
+    if (mat == NULL)
+    {
+        error_message_la(40, ERRMSS04);
+
+        exit(40);
+    }
+    else if (mat->row != mat->col)          // Tests if the matrix is square.
+    {
+        error_message_la(40, "incompatible dimensions to calculate a determinant!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        exit(40);
+    }
+
+    LA_STATS_START(40);
+
+    LA_CHANGED(mat);
+
+    corr = gaussian_elimination(mat);       // Transforms the matrix into an upper triangular one.
+
+    for (i = 0; i < mat->row; i++)          // Calculates the determinant.
+    {
+        det *= mat->m[i][i];
+
+        if (mat->m[i][i] == 0)
+            break;
+    }
+
+    det *= corr;                            // Corrects the signal.
+
+    LA_STATS_STOP(40, 2.0 * mat->row * mat->row * mat->row / 3);
+
+    return det;
+}
+
+Matrix* inverse_matrix(Matrix *mat)             // Returns the inverse of a matrix if it exists.
+{
+    register i, j, k;
+    int sign, *perm;
+    double fctr;
+
+    Matrix *tempmat, *inv;
+
+    if (mat == NULL)
+    {
+        error_message_la(41, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(41, "incompatible dimensions to do an inversion!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return NULL;
+    }
+
+    LA_STATS_START(41);
+
+    tempmat = cached_lu_la(41, mat, mat->row, &perm, &sign);
+
+    if (tempmat != NULL)                            // Decomposition from the factorization cache
+    {
+        inv = (sign != 0) ? lu_inverse_la(tempmat, perm) : NULL;
+
+        if (inv == NULL)
+            printf("\n\nThe matrix has no inverse!\n");
+
+        free_matrix(tempmat);
+
+        free(perm);
+
+        LA_STATS_STOP(41, (inv != NULL) ? 4.0 * mat->row * mat->row * mat->row / 3 : 0);
+
+        return inv;
+    }
+
+    tempmat = copy_matrix(mat);
+
+    inv = create_identity_matrix(mat->row);         // All operations made in 'tempmat' will be made equally in 'inv'.
+
+    for (i = 0; i < tempmat->row; i++)
+    {
+        if (task_checkpoint_la(task_current_la, (double) i / tempmat->row))    // Cancelled asynchronous task
+        {
+            free_matrix(tempmat);
+
+            free_matrix(inv);
+
+            LA_STATS_STOP(41, 0);
+
+            return NULL;
+        }
+
+        if (tempmat->m[i][i] == 0)                  // Tests if the element of main diagonal is null.
+        {
+            if (i < tempmat->row - 1)
+            {
+                int swap = 0;
+
+                for (k = i + 1; k < tempmat->row; k++)  // Searches for another row with no null element in that position.
+                {
+                    if (tempmat->m[k][i] != 0)              // Swaps the rows.
+                    {
+                        swap_rows(tempmat, i, k);
+
+                        swap_rows(inv, i, k);
+
+                        swap++;
+
+                        break;
+                    }
+                }
+
+                if (swap == 0)                          // This implies a matrix with null determinant, wich has no inverse.
+                {
+                    printf("\n\nThe matrix has no inverse!\n");
+
+                    free_matrix(tempmat);
+
+                    free_matrix(inv);
+
+                    LA_STATS_STOP(41, 0);
+
+                    return NULL;
+                }
+            }
+            else
+            {
+                printf("\n\nThe matrix has no inverse!\n");
+
+                free_matrix(tempmat);
+
+                free_matrix(inv);
+
+                LA_STATS_STOP(41, 0);
+
+                return NULL;
+            }
+        }
+
+        fctr = tempmat->m[i][i];
+
+        for (j = 0; j < tempmat->col; j++)          // Divides all elements by the first non-null one in the row.
+        {
+            tempmat->m[i][j] /= fctr;
+
+            inv->m[i][j] /= fctr;
+        }
+
+        for (k = 0; k < tempmat->row; k++)          // The elements that are not in the main diagonal are turned null.
+        {
+            if (k == i)
+                continue;
+
+            fctr = - tempmat->m[k][i];
+
+            for (j = 0; j < tempmat->col; j++)
+            {
+                if(tempmat->m[i][j] != 0)               // Jumps some inutile operations.
+                    tempmat->m[k][j] += fctr * tempmat->m[i][j];
+
+                inv->m[k][j] += fctr * inv->m[i][j];
+            }
+        }
+    }
+
+    free_matrix(tempmat);
+
+    LA_STATS_STOP(41, 2.0 * mat->row * mat->row * mat->row);
+
+    return inv;
+}
+
+double polynomial_function(double x, Array *coef)   // Evaluates a polynomial for a given 'x' value.
+{
+    register int i;
+    double fx;
+
+    if (coef == NULL)
+    {
+        error_message_la(42, ERRMSS02);
+
+        return 0;
+    }
+
+    LA_STATS_START(42);
+
+    if (coef->len == 1)
+    {
+        LA_STATS_STOP(42, 0);
+
+        return coef->a[0];
+    }
+                                                                // Horner's method for polynomials
+    fx = coef->a[coef->len - 1] * x + coef->a[coef->len - 2];
+
+    if (coef->len > 2)                                              // If the polynomial's degree is higher than 1
+    {
+        for (i = coef->len - 2; i >= 1; i--)
+            fx = fx * x + coef->a[i - 1];
+    }
+
+    LA_STATS_STOP(42, 2.0 * coef->len);
+
+    return fx;
+}
+
+static void poly_horner_la(double *c, int len, double *x, double *fx, double *dfx)    // Horner's method over POLY_LANES values at once, with the derivative.
+{
+    register int i, l;
+
+    for (l = 0; l < POLY_LANES; l++)
+    {
+        fx[l] = c[len - 1];
+
+        dfx[l] = 0;
+    }
+
+    for (i = len - 2; i >= 0; i--)                  // The lanes are independent, so this loop is vectorized over them.
+    {
+        for (l = 0; l < POLY_LANES; l++)
+        {
+            dfx[l] = dfx[l] * x[l] + fx[l];
+
+            fx[l] = fx[l] * x[l] + c[i];
+        }
+    }
+}
+
+static void poly_estrin_la(double *c, int len, double *x, double *fx, double *w)    // Estrin's scheme over POLY_LANES values at once.
+{
+    register int k, l;
+    int cnt;
+    double pw[POLY_LANES];
+
+    for (k = 0; k < len / 2; k++)                   // Pairs of coefficients: c[2k] + c[2k + 1] * x
+    {
+        for (l = 0; l < POLY_LANES; l++)
+            w[k * POLY_LANES + l] = c[2 * k] + c[2 * k + 1] * x[l];
+    }
+
+    if (len % 2 != 0)
+    {
+        for (l = 0; l < POLY_LANES; l++)
+            w[k * POLY_LANES + l] = c[len - 1];
+    }
+
+    for (l = 0; l < POLY_LANES; l++)
+        pw[l] = x[l];
+
+    for (cnt = (len + 1) / 2; cnt > 1; cnt = (cnt + 1) / 2)    // Each level combines pairs with the next power x^(2^level).
+    {
+        for (l = 0; l < POLY_LANES; l++)
+            pw[l] *= pw[l];
+
+        for (k = 0; k < cnt / 2; k++)
+        {
+            for (l = 0; l < POLY_LANES; l++)
+                w[k * POLY_LANES + l] = w[2 * k * POLY_LANES + l] + w[(2 * k + 1) * POLY_LANES + l] * pw[l];
+        }
+
+        if (cnt % 2 != 0)
+        {
+            for (l = 0; l < POLY_LANES; l++)
+                w[k * POLY_LANES + l] = w[(cnt - 1) * POLY_LANES + l];
+        }
+    }
+
+    for (l = 0; l < POLY_LANES; l++)
+        fx[l] = w[l];
+}
+
+void polynomial_eval_many(Array *coef, Array *xs, Array *out, Array *dout)  // Evaluates a polynomial for many 'x' values.
+{
+    int p, estrin;
+
+    if (coef == NULL || xs == NULL || out == NULL)
+    {
+        error_message_la(50, ERRMSS02);
+
+        return;
+    }
+    else if (xs->len != out->len || (dout != NULL && dout->len != xs->len))    // Tests the compatibility of dimensions.
+    {
+        error_message_la(50, "incompatible dimensions for a polynomial evaluation!");
+
+        return;
+    }
+
+    LA_STATS_START(50);
+
+    LA_CHANGED(out);
+
+    if (dout != NULL)
+        LA_CHANGED(dout);
+
+    estrin = (dout == NULL && coef->len > POLY_ESTRIN);     // Horner's method is kept when the derivative is also needed.
+
+    #pragma omp parallel if (xs->len >= tuning_la.poly_parallel)
+    {
+        register int l;
+        int cnt;
+        double x[POLY_LANES], fx[POLY_LANES], dfx[POLY_LANES];
+        double *w = NULL;
+
+        if (estrin)
+        {
+            w = malloc((coef->len + 1) / 2 * POLY_LANES * sizeof(double));
+
+            if (w == NULL)
+            {
+                error_message_la(50, ERRMSS01);
+
+                exit(50);
+            }
+        }
+
+        #pragma omp for schedule(static)
+        for (p = 0; p < xs->len; p += POLY_LANES)
+        {
+            cnt = (xs->len - p < POLY_LANES) ? xs->len - p : POLY_LANES;
+
+            for (l = 0; l < POLY_LANES; l++)        // The last block is completed with zeros.
+                x[l] = (l < cnt) ? xs->a[p + l] : 0;
+
+            if (estrin)
+                poly_estrin_la(coef->a, coef->len, x, fx, w);
+            else
+                poly_horner_la(coef->a, coef->len, x, fx, dfx);
+
+            for (l = 0; l < cnt; l++)
+                out->a[p + l] = fx[l];
+
+            if (dout != NULL)
+            {
+                for (l = 0; l < cnt; l++)
+                    dout->a[p + l] = dfx[l];
+            }
+        }
+
+        free(w);
+    }
+
+    LA_STATS_STOP(50, ((dout == NULL) ? 2.0 : 4.0) * coef->len * xs->len);
+}
+
+// Functions for systems of equations:
+
+Matrix* get_system(char *name)          // Get an augmented matrix of a system of equations from a 'txt' file.
+{
+    register int i, j;
+    int m, n;
+
+    Matrix *sys;
+    FILE *filin;
+
+    LA_STATS_START(43);
+
+    filin = fopen(name, "r");
+
+    if (filin == NULL)
+    {
+        error_message_la(43, ERRMSS03);
+
+        exit(43);
+    }
+
+    fscanf(filin, "%dx%d", &m, &n);
+
+    if (n != m + 1)                         // Tests the system dimensions.
+    {
+        error_message_la(43, "invalid system dimensions!");
+
+        printf("\nThe number of equations and variables must be the same.\n");
+
+        LA_STATS_STOP(43, 0);
+
+        return NULL;
+    }
+
+    sys = create_matrix(m, n);
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+            fscanf(filin, " %lf", &sys->m[i][j]);
+    }
+
+    fclose(filin);
+
+    LA_STATS_STOP(43, 0);
+
+    return sys;
+}
+
+int independent_system(Matrix *mat)         // Tests if the system is independent or not.
+{
+    register int i;
+
+    if (mat == NULL)
+    {
+        error_message_la(44, ERRMSS04);
+
+        exit(44);
+    }
+
+    LA_STATS_START(44);
+
+    for (i = 0; i < mat->row; i++)              // Walks through the main diagonal of the superior triangular matrix of coefficients.
+    {
+        if (mat->m[i][i] == 0)
+        {
+            LA_STATS_STOP(44, 0);
+
+            return 0;                               // Returns '0' if the product of the elements is null.
+        }
+    }
+
+    LA_STATS_STOP(44, 0);
+
+    return 1;                                       // Returns '1' otherwise.
+}
+
+Array* solve_system(Matrix *mat)                    // Solves a system of 'n' equations and 'n' variables.
+{
+    register int i, j;
+    int sign, *perm;
+
+    Array *sol;
+    Matrix *tempmat;
+
+    if (mat == NULL)
+    {
+        error_message_la(45, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->col != mat->row + 1 || mat->row < 1)  // Tests the coherence of the numbers of equations and variables.
+    {
+        error_message_la(45, "incompatible dimensions to solve the system of equations!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(45);
+
+    tempmat = cached_lu_la(45, mat, mat->row, &perm, &sign);
+
+    if (tempmat != NULL)                                // Decomposition of the coefficients from the factorization cache
+    {
+        sol = NULL;
+
+        if (sign == 0)
+            printf("\n\nNo solution!\n\nThe system of equations is dependent or inconsistent!\n\a");
+        else
+        {
+            sol = create_array(mat->row);
+
+            for (i = 0; i < sol->len; i++)
+                sol->a[i] = mat->m[i][mat->row];
+
+            over_lu_solve(tempmat, perm, sol);
+        }
+
+        free_matrix(tempmat);
+
+        free(perm);
+
+        LA_STATS_STOP(45, 0);
+
+        return sol;
+    }
+
+    tempmat = copy_matrix(mat);
+
+    gaussian_elimination(tempmat);
+
+    if (task_checkpoint_la(task_current_la, -1))        // Cancelled asynchronous task
+    {
+        free_matrix(tempmat);
+
+        LA_STATS_STOP(45, 0);
+
+        return NULL;
+    }
+
+    if (!independent_system(tempmat))                   // Tests if the system is independent.
+    {
+        printf("\n\nNo solution!\n\nThe system of equations is dependent or inconsistent!\n\a");
+
+        free_matrix(tempmat);
+
+        LA_STATS_STOP(45, 0);
+
+        return NULL;
+    }
+    else                                                    // Calculates the solution if it is independent.
+    {
+        sol = create_array(mat->row);
+
+        for (i = sol->len - 1; i >= 0; i--)                     // Solves the system by simple substitution.
+        {
+            sol->a[i] = tempmat->m[i][tempmat->col - 1];
+
+            for (j = i + 1; j < tempmat->col - 1; j++)
+                sol->a[i] -= tempmat->m[i][j] * sol->a[j];
+
+            sol->a[i] /= tempmat->m[i][i];
+        }
+    }
+
+    free_matrix(tempmat);
+
+    LA_STATS_STOP(45, 2.0 * mat->row * mat->row * mat->row / 3);
+
+    return sol;
+}
+
+// Decompositions:
+
+static Matrix row_block_view(Matrix *mat, int first, int rows)     // Gives a matrix that shares some consecutive rows of another one.
+{
+    Matrix view;
+
+    view.row = rows;
+
+    view.col = mat->col;
+
+    view.m = mat->m + first;
+
+    view.buffer = mat->buffer;                                  // Rows are moved in the same way as in 'mat'.
+
+    view.deleter = NULL;
+
+    view.version = 1;
+
+    atomic_init(&view.det_version, 0);
+
+    atomic_init(&view.norm_version, 0);
+
+    atomic_init(&view.lu_version, 0);
+
+    return view;
+}
+
+static double random_uniform_la(unsigned long long *state)      // Gives a pseudo-random number in the interval (0, 1).
+{
+    double u;
+
+    do
+    {
+        *state ^= *state << 13;                                     // xorshift64 generator
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+
+        u = (double) (*state >> 11) / 9007199254740992.0;
+    }
+    while (u == 0);
+
+    return u;
+}
+
+static double random_gaussian_la(unsigned long long *state)     // Gives a pseudo-random number with standard normal distribution.
+{
+    double u1, u2;
+
+    u1 = random_uniform_la(state);
+
+    u2 = random_uniform_la(state);
+
+    return sqrt(-2 * log(u1)) * cos(6.28318530717958647692 * u2);   // Box-Muller transform
+}
+
+static void apply_householder_la(Matrix *mat, Matrix *hh, int k, double tau, Array *w)  // Applies the reflection stored in column 'k' of 'hh' to the columns from 'k' on.
+{
+    register int i, j;
+    double fctr;
+
+    for (j = k; j < mat->col; j++)
+        w->a[j] = 0;
+
+    for (i = k; i < mat->row; i++)                  // w = transpose(v) * mat, walking the rows only once.
+    {
+        fctr = hh->m[i][k];
+
+        for (j = k; j < mat->col; j++)
+            w->a[j] += fctr * mat->m[i][j];
+    }
+
+    for (i = k; i < mat->row; i++)                  // mat = mat - tau * v * w
+    {
+        fctr = tau * hh->m[i][k];
+
+        for (j = k; j < mat->col; j++)
+            mat->m[i][j] -= fctr * w->a[j];
+    }
+}
+
+void qr_decomposition(Matrix *mat, Matrix **q, Matrix **r)  // Calculates the QR decomposition of a matrix by means of Householder reflections.
+{
+    register int i, j, k;
+    double nrm, vv;
+
+    Matrix *tempmat, *hh;
+    Array *tau, *w;
+
+    if (mat == NULL)
+    {
+        error_message_la(47, ERRMSS04);
+
+        return;
+    }
+    else if (mat->row < mat->col)                   // Tests the dimensions.
+    {
+        error_message_la(47, "incompatible dimensions for a QR decomposition!");
+
+        printf("\nThe matrix must have at least as many rows as columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(47);
+
+    tempmat = copy_matrix(mat);                     // Becomes 'r' after the reflections.
+
+    hh = create_matrix(mat->row, mat->col);         // Keeps the vector of each reflection in a column.
+
+    tau = create_array(mat->col);
+
+    w = create_array(mat->col);
+
+    for (k = 0; k < tempmat->col; k++)
+    {
+        nrm = 0;
+
+        for (i = k; i < tempmat->row; i++)
+            nrm += tempmat->m[i][k] * tempmat->m[i][k];
+
+        if (nrm == 0)                               // Nothing to reflect in this column.
+            continue;
+
+        nrm = sqrt(nrm);
+
+        if (tempmat->m[k][k] < 0)                   // Avoids cancellation in the first element of the vector.
+            nrm = - nrm;
+
+        vv = 0;
+
+        for (i = k; i < tempmat->row; i++)
+        {
+            hh->m[i][k] = tempmat->m[i][k];
+
+            if (i == k)
+                hh->m[i][k] += nrm;
+
+            vv += hh->m[i][k] * hh->m[i][k];
+        }
+
+        tau->a[k] = 2 / vv;
+
+        apply_householder_la(tempmat, hh, k, tau->a[k], w);
+
+        tempmat->m[k][k] = - nrm;
+
+        for (i = k + 1; i < tempmat->row; i++)
+            tempmat->m[i][k] = 0;
+    }
+
+    if (q != NULL)                                  // Accumulates the reflections backwards over the first columns of the identity.
+    {
+        *q = create_matrix(mat->row, mat->col);
+
+        for (i = 0; i < mat->col; i++)
+            (*q)->m[i][i] = 1;
+
+        for (k = mat->col - 1; k >= 0; k--)
+        {
+            if (tau->a[k] != 0)
+                apply_householder_la(*q, hh, k, tau->a[k], w);
+        }
+    }
+
+    if (r != NULL)
+    {
+        *r = create_matrix(mat->col, mat->col);
+
+        for (i = 0; i < mat->col; i++)
+        {
+            for (j = i; j < mat->col; j++)
+                (*r)->m[i][j] = tempmat->m[i][j];
+        }
+    }
+
+    free_matrix(tempmat);
+
+    free_matrix(hh);
+
+    free_array(tau);
+
+    free_array(w);
+
+    LA_STATS_STOP(47, 4.0 * mat->row * mat->col * mat->col);
+}
+
+Matrix* cholesky_decomposition(Matrix *mat)     // Calculates the Cholesky factor of a symmetric positive definite matrix.
+{
+    register int i, j;
+    double d;
+
+    Matrix *l;
+
+    if (mat == NULL)
+    {
+        error_message_la(97, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(97, "incompatible dimensions for a Cholesky decomposition!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return NULL;
+    }
+
+    LA_STATS_START(97);
+
+    l = create_matrix(mat->row, mat->col);
+
+    for (j = 0; j < mat->row; j++)                  // Only the lower part of the matrix is used.
+    {
+        d = mat->m[j][j] - dot_la(l->m[j], l->m[j], j);
+
+        if (d <= 0)                                 // Not positive definite
+        {
+            free_matrix(l);
+
+            LA_STATS_STOP(97, (double) j * mat->row * mat->row);
+
+            return NULL;
+        }
+
+        l->m[j][j] = d = sqrt(d);
+
+        for (i = j + 1; i < mat->row; i++)
+            l->m[i][j] = (mat->m[i][j] - dot_la(l->m[i], l->m[j], j)) / d;
+    }
+
+    LA_STATS_STOP(97, (double) mat->row * mat->row * mat->row / 3);
+
+    return l;
+}
+
+static int svd_block_la(Matrix *mat, RowBlockReader read, void *data,
+                        Matrix *block, int first, int rows, Matrix *view)   // Gives a view of some rows of the matrix being decomposed.
+{
+    if (mat != NULL)                                // A matrix in memory is used without copies.
+    {
+        *view = row_block_view(mat, first, rows);
+
+        return 0;
+    }
+
+    if (read(block, first, rows, data) != 0)
+        return 1;
+
+    *view = row_block_view(block, 0, rows);
+
+    return 0;
+}
+
+static int svd_times_la(Matrix *mat, RowBlockReader read, void *data, Matrix *block,
+                        int m, int brows, Matrix *b, Matrix *res)   // Calculates 'res = A * b', one block of rows of 'A' at a time.
+{
+    register int i, j;
+    int first, rows;
+
+    Matrix view, *prod;
+
+    for (first = 0; first < m; first += brows)
+    {
+        rows = (m - first < brows) ? m - first : brows;
+
+        if (svd_block_la(mat, read, data, block, first, rows, &view) != 0)
+            return 1;
+
+        prod = matrix_times_matrix(&view, b);
+
+        for (i = 0; i < rows; i++)
+        {
+            for (j = 0; j < prod->col; j++)
+                res->m[first + i][j] = prod->m[i][j];
+        }
+
+        free_matrix(prod);
+    }
+
+    return 0;
+}
+
+static int svd_transposed_times_la(Matrix *mat, RowBlockReader read, void *data, Matrix *block,
+                                   int m, int brows, Matrix *q, Matrix *res)    // Calculates 'res = transpose(A) * q', one block of rows of 'A' at a time.
+{
+    int first, rows;
+
+    Matrix view, qview, *blkt, *prod;
+
+    over_rnumber_times_matrix(0, res);
+
+    for (first = 0; first < m; first += brows)
+    {
+        rows = (m - first < brows) ? m - first : brows;
+
+        if (svd_block_la(mat, read, data, block, first, rows, &view) != 0)
+            return 1;
+
+        qview = row_block_view(q, first, rows);
+
+        blkt = transpose_matrix(&view);
+
+        prod = matrix_times_matrix(blkt, &qview);
+
+        over_sum_matrix(res, prod);
+
+        free_matrix(blkt);
+
+        free_matrix(prod);
+    }
+
+    return 0;
+}
+
+static int randomized_svd_la(int nmbr, Matrix *mat, int m, int n, RowBlockReader read, void *data, int brows,
+                             int rank, int oversampling, int power_iter,
+                             Matrix **u, Array **s, Matrix **v)    // Randomized range finder followed by a Jacobi SVD of the projected matrix.
+{
+    register int i, j, k;
+    int l, it, ok, sweep, conv, best;
+    unsigned long long seed = SVD_SEED;
+    double alpha, beta, gamma, zeta, t, c, sn, temp;
+
+    Matrix *block = NULL, *omega, *y, *q, *z, *b, *rot, *mt;
+    Array *sigma;
+    int *idx;
+
+    l = rank + oversampling;                        // Number of sampled directions
+
+    if (l > m)
+        l = m;
+
+    if (l > n)
+        l = n;
+
+    if (mat == NULL)
+        block = create_matrix(brows, n);
+
+    omega = create_matrix(n, l);                    // Gaussian test matrix
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < l; j++)
+            omega->m[i][j] = random_gaussian_la(&seed);
+    }
+
+    y = create_matrix(m, l);
+
+    if (svd_times_la(mat, read, data, block, m, brows, omega, y) != 0)  // Samples the range of the matrix.
+    {
+        error_message_la(nmbr, "error reading a block of rows!");
+
+        free_matrix(block);
+
+        free_matrix(omega);
+
+        free_matrix(y);
+
+        return 0;
+    }
+
+    free_matrix(omega);
+
+    qr_decomposition(y, &q, NULL);
+
+    free_matrix(y);
+
+    z = create_matrix(n, l);
+
+    for (it = 0, ok = 1; it < power_iter && ok; it++)  // Power iterations, with orthonormalization between the products.
+    {
+        ok = (svd_transposed_times_la(mat, read, data, block, m, brows, q, z) == 0);
+
+        if (!ok)
+            break;
+
+        free_matrix(q);
+
+        qr_decomposition(z, &y, NULL);
+
+        q = create_matrix(m, l);
+
+        ok = (svd_times_la(mat, read, data, block, m, brows, y, q) == 0);
+
+        free_matrix(y);
+
+        if (ok)
+        {
+            y = q;
+
+            qr_decomposition(y, &q, NULL);
+
+            free_matrix(y);
+        }
+    }
+
+    if (ok)                                         // transpose(B) = transpose(A) * q
+        ok = (svd_transposed_times_la(mat, read, data, block, m, brows, q, z) == 0);
+
+    free_matrix(block);
+
+    if (!ok)
+    {
+        error_message_la(nmbr, "error reading a block of rows!");
+
+        free_matrix(q);
+
+        free_matrix(z);
+
+        return 0;
+    }
+
+    b = transpose_matrix(z);                        // 'l x n', with the rows orthogonalized below.
+
+    free_matrix(z);
+
+    rot = create_identity_matrix(l);                // Accumulates the rotations applied to the rows of 'b'.
+
+    for (sweep = 0, conv = 0; sweep < SVD_SWEEPS && !conv; sweep++)    // One-sided Jacobi method
+    {
+        conv = 1;
+
+        for (i = 0; i < l - 1; i++)
+        {
+            for (k = i + 1; k < l; k++)
+            {
+                alpha = beta = gamma = 0;
+
+                for (j = 0; j < n; j++)
+                {
+                    alpha += b->m[i][j] * b->m[i][j];
+
+                    beta += b->m[k][j] * b->m[k][j];
+
+                    gamma += b->m[i][j] * b->m[k][j];
+                }
+
+                if (fabs(gamma) <= DBL_EPSILON * sqrt(alpha * beta))   // Rows already orthogonal
+                    continue;
+
+                conv = 0;
+
+                zeta = (beta - alpha) / (2 * gamma);
+
+                t = ((zeta >= 0) ? 1 : -1) / (fabs(zeta) + sqrt(1 + zeta * zeta));
+
+                c = 1 / sqrt(1 + t * t);
+
+                sn = c * t;
+
+                for (j = 0; j < n; j++)
+                {
+                    temp = b->m[i][j];
+
+                    b->m[i][j] = c * temp - sn * b->m[k][j];
+
+                    b->m[k][j] = sn * temp + c * b->m[k][j];
+                }
+
+                for (j = 0; j < l; j++)
+                {
+                    temp = rot->m[i][j];
+
+                    rot->m[i][j] = c * temp - sn * rot->m[k][j];
+
+                    rot->m[k][j] = sn * temp + c * rot->m[k][j];
+                }
+            }
+        }
+    }
+
+    sigma = create_array(l);                        // The singular values are the norms of the rows.
+
+    for (i = 0; i < l; i++)
+    {
+        for (j = 0; j < n; j++)
+            sigma->a[i] += b->m[i][j] * b->m[i][j];
+
+        sigma->a[i] = sqrt(sigma->a[i]);
+    }
+
+    idx = malloc(rank * sizeof(int));
+
+    if (idx == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    for (k = 0; k < rank; k++)                      // Selects the largest singular values in decreasing order.
+    {
+        best = -1;
+
+        for (i = 0; i < l; i++)
+        {
+            for (j = 0; j < k && idx[j] != i; j++)
+                ;
+
+            if (j == k && (best < 0 || sigma->a[i] > sigma->a[best]))
+                best = i;
+        }
+
+        idx[k] = best;
+    }
+
+    if (s != NULL)
+    {
+        *s = create_array(rank);
+
+        for (k = 0; k < rank; k++)
+            (*s)->a[k] = sigma->a[idx[k]];
+    }
+
+    if (v != NULL)
+    {
+        *v = create_matrix(n, rank);
+
+        for (k = 0; k < rank; k++)
+        {
+            if (sigma->a[idx[k]] == 0)
+                continue;
+
+            for (j = 0; j < n; j++)
+                (*v)->m[j][k] = b->m[idx[k]][j] / sigma->a[idx[k]];
+        }
+    }
+
+    if (u != NULL)                                  // u = q * transpose(rot), only with the selected columns.
+    {
+        mt = create_matrix(l, rank);
+
+        for (k = 0; k < rank; k++)
+        {
+            for (j = 0; j < l; j++)
+                mt->m[j][k] = rot->m[idx[k]][j];
+        }
+
+        *u = matrix_times_matrix(q, mt);
+
+        free_matrix(mt);
+    }
+
+    free(idx);
+
+    free_array(sigma);
+
+    free_matrix(rot);
+
+    free_matrix(b);
+
+    free_matrix(q);
+
+    return 1;
+}
+
+int randomized_svd(Matrix *mat, int rank, int oversampling, int power_iter,
+                   Matrix **u, Array **s, Matrix **v)      // Calculates a truncated SVD of a matrix with a randomized range finder.
+{
+    int ok;
+
+    if (mat == NULL)
+    {
+        error_message_la(48, ERRMSS04);
+
+        return 0;
+    }
+    else if (rank <= 0 || rank > mat->row || rank > mat->col)  // Tests the rank of the approximation.
+    {
+        error_message_la(48, "invalid rank for a truncated SVD!");
+
+        return 0;
+    }
+    else if (oversampling < 0 || power_iter < 0)
+    {
+        error_message_la(48, "invalid parameters for a randomized SVD!");
+
+        return 0;
+    }
+
+    LA_STATS_START(48);
+
+    ok = randomized_svd_la(48, mat, mat->row, mat->col, NULL, NULL, SVD_BLOCK,
+                            rank, oversampling, power_iter, u, s, v);
+
+    LA_STATS_STOP(48, 4.0 * mat->row * mat->col * (rank + oversampling) * (power_iter + 1));
+
+    return ok;
+}
+
+int randomized_svd_stream(int m, int n, RowBlockReader read, void *data, int block_rows,
+                          int rank, int oversampling, int power_iter,
+                          Matrix **u, Array **s, Matrix **v)   // Calculates a truncated SVD of a matrix read in blocks of rows.
+{
+    int ok;
+
+    if (read == NULL)
+    {
+        error_message_la(49, "NULL reading function informed!");
+
+        return 0;
+    }
+    else if (m <= 0 || n <= 0 || block_rows <= 0)
+    {
+        error_message_la(49, "incompatible dimensions for a matrix!");
+
+        return 0;
+    }
+    else if (rank <= 0 || rank > m || rank > n)                 // Tests the rank of the approximation.
+    {
+        error_message_la(49, "invalid rank for a truncated SVD!");
+
+        return 0;
+    }
+    else if (oversampling < 0 || power_iter < 0)
+    {
+        error_message_la(49, "invalid parameters for a randomized SVD!");
+
+        return 0;
+    }
+
+    LA_STATS_START(49);
+
+    ok = randomized_svd_la(49, NULL, m, n, read, data, block_rows,
+                            rank, oversampling, power_iter, u, s, v);
+
+    LA_STATS_STOP(49, 4.0 * m * n * (rank + oversampling) * (power_iter + 1));
+
+    return ok;
+}
+
+// Batches of three-dimensional vectors:
+
+VectorBatch* create_vector_batch(int len)       // Creates a batch of a given number of three-dimensional vectors.
+{
+    VectorBatch *vb;
+
+    if (len <= 0)
+    {
+        error_message_la(51, "incompatible dimension for a batch of vectors!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(51);
+
+    vb = malloc(sizeof(VectorBatch));
+
+    if (vb == NULL)
+    {
+        error_message_la(51, ERRMSS01);
+
+        exit(51);
+    }
+
+    vb->x = calloc(3 * (size_t) len, sizeof(double));   // The three components share one allocation.
+
+    if (vb->x == NULL)
+    {
+        error_message_la(51, ERRMSS01);
+
+        exit(51);
+    }
+
+    vb->y = vb->x + len;
+
+    vb->z = vb->y + len;
+
+    vb->len = len;
+
+    LA_STATS_BYTES(51, sizeof(VectorBatch) + 3LL * len * sizeof(double));
+
+    LA_STATS_STOP(51, 0);
+
+    return vb;
+}
+
+void free_vector_batch(VectorBatch *vb)         // Deallocates memory previously used for a batch of vectors.
+{
+    if (vb != NULL)
+    {
+        free(vb->x);
+
+        free(vb);
+    }
+}
+
+int length_of_vector_batch(VectorBatch *vb)     // Gives the number of vectors in a batch.
+{
+    if (vb == NULL)
+        return 0;
+    else
+        return vb->len;
+}
+
+void insert_in_vector_batch(double x, double y, double z, VectorBatch *vb, int pos)    // Inserts a vector in a batch in a given position.
+{
+    if (vb == NULL)
+    {
+        error_message_la(53, "NULL batch of vectors informed!");
+
+        return;
+    }
+    else if (pos < 0 || pos >= vb->len)
+    {
+        error_message_la(53, "inexistent position in the batch!");
+
+        return;
+    }
+
+    LA_STATS_COUNT(53);
+
+    vb->x[pos] = x;
+
+    vb->y[pos] = y;
+
+    vb->z[pos] = z;
+}
+
+double get_from_vector_batch(VectorBatch *vb, int pos, int comp)    // Gets a component of a vector in a batch.
+{
+    if (vb == NULL)
+    {
+        error_message_la(54, "NULL batch of vectors informed!");
+
+        return 0;
+    }
+    else if (pos < 0 || pos >= vb->len || comp < 0 || comp > 2)
+    {
+        error_message_la(54, "inexistent position in the batch!");
+
+        return 0;
+    }
+
+    LA_STATS_COUNT(54);
+
+    if (comp == 0)
+        return vb->x[pos];
+    else if (comp == 1)
+        return vb->y[pos];
+    else
+        return vb->z[pos];
+}
+
+void batch_vector_product(VectorBatch *a, VectorBatch *b, VectorBatch *out)    // Calculates the vector products of the vectors in two batches.
+{
+    register int i;
+    double cx, cy, cz;
+
+    if (a == NULL || b == NULL || out == NULL)
+    {
+        error_message_la(55, "NULL batch of vectors informed!");
+
+        return;
+    }
+    else if (a->len != b->len || a->len != out->len)    // Tests the compatibility of dimensions.
+    {
+        error_message_la(55, "incompatible dimensions for vector products!");
+
+        return;
+    }
+
+    LA_STATS_START(55);
+
+    #pragma omp parallel for private(cx, cy, cz) if (a->len >= tuning_la.batch_parallel)
+    for (i = 0; i < a->len; i++)                    // All components are read before writing, so 'out' may be 'a' or 'b'.
+    {
+        cx = a->y[i] * b->z[i] - a->z[i] * b->y[i];
+
+        cy = a->z[i] * b->x[i] - a->x[i] * b->z[i];
+
+        cz = a->x[i] * b->y[i] - a->y[i] * b->x[i];
+
+        out->x[i] = cx;
+
+        out->y[i] = cy;
+
+        out->z[i] = cz;
+    }
+
+    LA_STATS_STOP(55, 9.0 * a->len);
+}
+
+void batch_scalar_product(VectorBatch *a, VectorBatch *b, Array *out)  // Calculates the scalar products of the vectors in two batches.
+{
+    register int i;
+
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(56, "NULL batch of vectors informed!");
+
+        return;
+    }
+    else if (out == NULL)
+    {
+        error_message_la(56, ERRMSS02);
+
+        return;
+    }
+    else if (a->len != b->len || a->len != out->len)    // Tests the compatibility of dimensions.
+    {
+        error_message_la(56, "incompatible dimensions for scalar products!");
+
+        return;
+    }
+
+    LA_STATS_START(56);
+
+    LA_CHANGED(out);
+
+    #pragma omp parallel for if (a->len >= tuning_la.batch_parallel)
+    for (i = 0; i < a->len; i++)
+        out->a[i] = a->x[i] * b->x[i] + a->y[i] * b->y[i] + a->z[i] * b->z[i];
+
+    LA_STATS_STOP(56, 5.0 * a->len);
+}
+
+void batch_euclidean_norm(VectorBatch *vb, Array *out)     // Calculates the euclidean norms of the vectors in a batch.
+{
+    register int i;
+
+    if (vb == NULL)
+    {
+        error_message_la(57, "NULL batch of vectors informed!");
+
+        return;
+    }
+    else if (out == NULL)
+    {
+        error_message_la(57, ERRMSS02);
+
+        return;
+    }
+    else if (vb->len != out->len)                   // Tests the compatibility of dimensions.
+    {
+        error_message_la(57, "incompatible dimensions for euclidean norms!");
+
+        return;
+    }
+
+    LA_STATS_START(57);
+
+    LA_CHANGED(out);
+
+    #pragma omp parallel for if (vb->len >= tuning_la.batch_parallel)
+    for (i = 0; i < vb->len; i++)
+        out->a[i] = sqrt(vb->x[i] * vb->x[i] + vb->y[i] * vb->y[i] + vb->z[i] * vb->z[i]);
+
+    LA_STATS_STOP(57, 6.0 * vb->len);
+}
+
+void over_normalize_vector_batch(VectorBatch *vb)  // Normalizes all the vectors in a batch, overwriting them.
+{
+    register int i;
+    double fctr;
+
+    if (vb == NULL)
+    {
+        error_message_la(58, "NULL batch of vectors informed!");
+
+        return;
+    }
+
+    LA_STATS_START(58);
+
+    #pragma omp parallel for private(fctr) if (vb->len >= tuning_la.batch_parallel)
+    for (i = 0; i < vb->len; i++)
+    {
+        fctr = vb->x[i] * vb->x[i] + vb->y[i] * vb->y[i] + vb->z[i] * vb->z[i];
+
+        fctr = (fctr > 0) ? 1 / sqrt(fctr) : 1;     // Vectors with zero length are kept.
+
+        vb->x[i] *= fctr;
+
+        vb->y[i] *= fctr;
+
+        vb->z[i] *= fctr;
+    }
+
+    LA_STATS_STOP(58, 9.0 * vb->len);
+}
+
+// Profiling counters:
+
+int linalg_stats_enabled(void)              // Tells if the library was compiled with the profiling counters.
+{
+#ifdef LINALG_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int linalg_stats_snapshot(FunctionStats *stats, int len)   // Copies the profiling counters of all functions.
+{
+    register int i;
+
+    if (stats == NULL && len > 0)
+    {
+        error_message_la(66, "NULL statistics informed!");
+
+        return 0;
+    }
+
+    for (i = 1; i < LA_FUNCTIONS && i <= len; i++)
+    {
+        stats[i - 1].number = i;
+
+        stats[i - 1].name = function_names[i];
+
+#ifdef LINALG_STATS
+        stats[i - 1].calls = atomic_load_explicit(&stats_la[i].calls, memory_order_relaxed);
+
+        stats[i - 1].seconds = atomic_load_explicit(&stats_la[i].nanoseconds, memory_order_relaxed) * 1e-9;
+
+        stats[i - 1].bytes = atomic_load_explicit(&stats_la[i].bytes, memory_order_relaxed);
+
+        stats[i - 1].flops = (double) atomic_load_explicit(&stats_la[i].flops, memory_order_relaxed);
+#else
+        stats[i - 1].calls = 0;
+
+        stats[i - 1].seconds = 0;
+
+        stats[i - 1].bytes = 0;
+
+        stats[i - 1].flops = 0;
+#endif
+    }
+
+    return LA_FUNCTIONS - 1;
+}
+
+void linalg_stats_reset(void)               // Clears the profiling counters.
+{
+#ifdef LINALG_STATS
+    register int i;
+
+    for (i = 0; i < LA_FUNCTIONS; i++)
+    {
+        atomic_store_explicit(&stats_la[i].calls, 0, memory_order_relaxed);
+
+        atomic_store_explicit(&stats_la[i].nanoseconds, 0, memory_order_relaxed);
+
+        atomic_store_explicit(&stats_la[i].bytes, 0, memory_order_relaxed);
+
+        atomic_store_explicit(&stats_la[i].flops, 0, memory_order_relaxed);
+    }
+#endif
+}
+
+void linalg_stats_print_json(FILE *out)     // Writes the profiling counters of the called functions in JSON.
+{
+    register int i;
+    int first = 1;
+
+    FunctionStats stats[LA_FUNCTIONS - 1];
+
+    if (out == NULL)
+    {
+        error_message_la(67, "NULL file informed!");
+
+        return;
+    }
+
+    linalg_stats_snapshot(stats, LA_FUNCTIONS - 1);
+
+    fprintf(out, "{\n  \"enabled\": %s,\n  \"functions\": [", linalg_stats_enabled() ? "true" : "false");
+
+    for (i = 0; i < LA_FUNCTIONS - 1; i++)
+    {
+        if (stats[i].calls == 0)                    // Only the functions that were used
+            continue;
+
+        fprintf(out, "%s\n    {\"number\": %d, \"name\": \"%s\", \"calls\": %lld, \"seconds\": %.9f, "
+                "\"bytes_allocated\": %lld, \"flops\": %.0f}", first ? "" : ",", stats[i].number,
+                stats[i].name, stats[i].calls, stats[i].seconds, stats[i].bytes, stats[i].flops);
+
+        first = 0;
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+}
+
+// Kernels selected at run time:
+
+char* linalg_kernels_name(void)             // Gives the name of the kernels in use.
+{
+    return kernels()->name;
+}
+
+int linalg_select_kernels(char *name)       // Selects the kernels used by the library.
+{
+    const Kernels *k;
+
+    if (name == NULL)
+    {
+        error_message_la(69, "NULL name informed!");
+
+        return 0;
+    }
+
+    k = kernels_by_name_la(name);
+
+    if (k == NULL)
+    {
+        error_message_la(69, "kernels not available on this processor!");
+
+        return 0;
+    }
+
+    kernels_la = k;
+
+    return 1;
+}
+
+// Tuning parameters:
+
+int linalg_init(char *profile)      // Loads a tuning profile, or the one named by LINALG_TUNING if 'profile' is NULL.
+{
+    register int i;
+    char line[256], name[64];
+    double value;
+    int ok = 1, lnum = 0, end;
+
+    FILE *filin;
+
+    LA_STATS_COUNT(70);
+
+    kernels();
+
+    if (profile == NULL)
+        profile = getenv("LINALG_TUNING");
+
+    if (profile == NULL || profile[0] == '\0')      // Nothing to load: the defaults are kept.
+        return 1;
+
+    filin = fopen(profile, "r");
+
+    if (filin == NULL)
+    {
+        error_message_la(70, ERRMSS03);
+
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), filin) != NULL)    // Lines 'name = value'; '#' starts a comment.
+    {
+        lnum++;
+
+        for (i = 0; line[i] == ' ' || line[i] == '\t'; i++);
+
+        if (line[i] == '#' || line[i] == '\n' || line[i] == '\r' || line[i] == '\0')
+            continue;
+
+        end = 0;
+
+        if (sscanf(line + i, "%63[a-z_] = %lf%n", name, &value, &end) != 2 || line[i + end + strspn(line + i + end, " \t\r\n")] != '\0' ||
+            value != floor(value) || value < 0 || !linalg_set_parameter(name, value > TUNING_NEVER ? TUNING_NEVER : (int) value))
+        {
+            error_message_la(70, "invalid line in the tuning profile!");
+
+            printf("\nLine %d of '%s'.\n", lnum, profile);
+
+            ok = 0;
+        }
+    }
+
+    fclose(filin);
+
+    return ok;
+}
+
+int linalg_set_parameter(char *name, int value)     // Changes a tuning parameter.
+{
+    register int i;
+
+    if (name == NULL)
+    {
+        error_message_la(71, "NULL name informed!");
+
+        return 0;
+    }
+
+    for (i = 0; i < LA_PARAMETERS; i++)
+    {
+        if (strcmp(name, parameters_la[i].name) == 0)
+        {
+            if (value < parameters_la[i].min)
+            {
+                error_message_la(71, "value out of range for the parameter!");
+
+                return 0;
+            }
+
+            LA_STATS_COUNT(71);
+
+            *parameters_la[i].value = value;
+
+            return 1;
+        }
+    }
+
+    error_message_la(71, "unknown tuning parameter!");
+
+    return 0;
+}
+
+int linalg_get_parameter(char *name)        // Gives the value of a tuning parameter.
+{
+    register int i;
+
+    if (name == NULL)
+    {
+        error_message_la(72, "NULL name informed!");
+
+        return -1;
+    }
+
+    for (i = 0; i < LA_PARAMETERS; i++)
+    {
+        if (strcmp(name, parameters_la[i].name) == 0)
+        {
+            LA_STATS_COUNT(72);
+
+            return *parameters_la[i].value;
+        }
+    }
+
+    error_message_la(72, "unknown tuning parameter!");
+
+    return -1;
+}
+
+void linalg_print_tuning(FILE *filout)      // Writes the tuning parameters in use as a profile.
+{
+    register int i;
+
+    if (filout == NULL)
+    {
+        error_message_la(73, "NULL file informed!");
+
+        return;
+    }
+
+    LA_STATS_COUNT(73);
+
+    fprintf(filout, "# linalg tuning profile (kernels: %s)\n", kernels()->name);
+
+    for (i = 0; i < LA_PARAMETERS; i++)
+        fprintf(filout, "%s = %d\n", parameters_la[i].name, *parameters_la[i].value);
+}
+
+// Out-of-core matrices:
+//
+// The tiles are stored one after the other in the file, after a header, each one
+// as a square row-major block of 'tile x tile' elements (the tiles of the last row
+// and column are completed with zeros). A cache of tiles, limited by a memory
+// budget, is shared by the calls and by a thread that reads in advance the tiles
+// that the operations announce they will need next.
+
+#define TILED_HEADER 4096                                       // Bytes before the first tile, so that tiles start on pages
+#define TILED_MAGIC "LINALGTM"
+#define TILED_MIN_SLOTS 4                                       // Tiles used at once by the operations, plus one being read in advance
+
+typedef struct tile_slot
+{
+	int index;                                                  // Tile in the slot, or '-1'
+
+	int pins;                                                   // Users of the tile
+
+	int dirty;
+
+	int loading;                                                // Being read from the file
+
+	unsigned long long used;                                    // Time of the last use, for the LRU policy
+
+	double *a;
+} TileSlot;
+
+struct tiled_matrix
+{
+	int row;
+
+	int col;
+
+	int tile;
+
+	int trows;                                                  // Tiles in each column and in each row
+
+	int tcols;
+
+	int fd;
+
+	int nslots;
+
+	TileSlot *slots;
+
+	int *where;                                                 // Slot of each tile, or '-1'
+
+	unsigned long long clock;
+
+	int *queue;                                                 // Tiles to read in advance (circular)
+
+	int qhead;
+
+	int qlen;
+
+	int stop;
+
+	pthread_mutex_t lock;
+
+	pthread_cond_t ready;                                       // A tile was read or released.
+
+	pthread_cond_t request;                                     // A tile was queued.
+
+	pthread_t prefetcher;
+};
+
+static size_t tile_bytes_la(TiledMatrix *tm)
+{
+    return (size_t) tm->tile * tm->tile * sizeof(double);
+}
+
+static off_t tile_offset_la(TiledMatrix *tm, int index)
+{
+    return TILED_HEADER + (off_t) index * tile_bytes_la(tm);
+}
+
+static int tile_io_la(TiledMatrix *tm, int index, double *a, int write)    // Reads or writes a whole tile. Returns '1' on success.
+{
+    size_t done = 0, size = tile_bytes_la(tm);
+    ssize_t res;
+    char *p = (char*) a;
+
+    while (done < size)
+    {
+        if (write)
+            res = pwrite(tm->fd, p + done, size - done, tile_offset_la(tm, index) + done);
+        else
+            res = pread(tm->fd, p + done, size - done, tile_offset_la(tm, index) + done);
+
+        if (res < 0)
+            return 0;
+
+        if (res == 0)                               // Beyond the end of a sparse file: zeros
+        {
+            memset(p + done, 0, size - done);
+
+            break;
+        }
+
+        done += res;
+    }
+
+    return 1;
+}
+
+static int tile_victim_la(TiledMatrix *tm)     // Least recently used slot that is free to be replaced, or '-1'. The lock must be held.
+{
+    register int s;
+    int best = -1;
+
+    for (s = 0; s < tm->nslots; s++)
+    {
+        if (tm->slots[s].pins > 0 || tm->slots[s].loading)
+            continue;
+
+        if (tm->slots[s].index < 0)
+            return s;
+
+        if (best < 0 || tm->slots[s].used < tm->slots[best].used)
+            best = s;
+    }
+
+    return best;
+}
+
+static int tile_claim_la(int nmbr, TiledMatrix *tm, int s, int index)     // Prepares a slot for a tile, saving the old one. The lock must be held.
+{
+    TileSlot *slot = &tm->slots[s];
+
+    if (slot->index >= 0)
+    {
+        if (slot->dirty && !tile_io_la(tm, slot->index, slot->a, 1))  // Written with the lock held, so that nobody reads it before.
+        {
+            error_message_la(nmbr, "error writing the file of a tiled matrix!");
+
+            exit(nmbr);
+        }
+
+        tm->where[slot->index] = -1;
+    }
+
+    slot->index = index;
+
+    slot->dirty = 0;
+
+    slot->loading = 1;
+
+    slot->used = ++tm->clock;
+
+    tm->where[index] = s;
+
+    return s;
+}
+
+static void* tile_prefetcher_la(void *arg)     // Thread that reads the queued tiles in advance.
+{
+    TiledMatrix *tm = arg;
+    int index, s, ok;
+
+    pthread_mutex_lock(&tm->lock);
+
+    while (!tm->stop)
+    {
+        if (tm->qlen == 0)
+        {
+            pthread_cond_wait(&tm->request, &tm->lock);
+
+            continue;
+        }
+
+        index = tm->queue[tm->qhead];
+
+        tm->qhead = (tm->qhead + 1) % tm->nslots;
+
+        tm->qlen--;
+
+        if (tm->where[index] >= 0 || (s = tile_victim_la(tm)) < 0)
+            continue;
+
+        tile_claim_la(76, tm, s, index);
+
+        pthread_mutex_unlock(&tm->lock);            // The file is read without the lock.
+
+        ok = tile_io_la(tm, index, tm->slots[s].a, 0);
+
+        pthread_mutex_lock(&tm->lock);
+
+        tm->slots[s].loading = 0;
+
+        if (!ok)                                    // Left to be read, and the error reported, when it is used.
+        {
+            tm->where[index] = -1;
+
+            tm->slots[s].index = -1;
+        }
+
+        pthread_cond_broadcast(&tm->ready);
+    }
+
+    pthread_mutex_unlock(&tm->lock);
+
+    return NULL;
+}
+
+static double* tile_pin_la(int nmbr, TiledMatrix *tm, int ti, int tj, int read)    // Gives a tile in the cache, reading it if 'read' is set.
+{
+    int index = ti * tm->tcols + tj, s;
+
+    pthread_mutex_lock(&tm->lock);
+
+    for (;;)
+    {
+        s = tm->where[index];
+
+        if (s >= 0 && !tm->slots[s].loading)
+            break;
+
+        if (s < 0 && (s = tile_victim_la(tm)) >= 0)
+        {
+            tile_claim_la(nmbr, tm, s, index);
+
+            tm->slots[s].pins++;
+
+            pthread_mutex_unlock(&tm->lock);
+
+            if (read && !tile_io_la(tm, index, tm->slots[s].a, 0))
+            {
+                error_message_la(nmbr, "error reading the file of a tiled matrix!");
+
+                exit(nmbr);
+            }
+            else if (!read)
+                memset(tm->slots[s].a, 0, tile_bytes_la(tm));
+
+            pthread_mutex_lock(&tm->lock);
+
+            tm->slots[s].loading = 0;
+
+            pthread_cond_broadcast(&tm->ready);
+
+            pthread_mutex_unlock(&tm->lock);
+
+            return tm->slots[s].a;
+        }
+
+        pthread_cond_wait(&tm->ready, &tm->lock);   // Being read, or no free slot
+    }
+
+    tm->slots[s].pins++;
+
+    tm->slots[s].used = ++tm->clock;
+
+    pthread_mutex_unlock(&tm->lock);
+
+    return tm->slots[s].a;
+}
+
+static void tile_unpin_la(TiledMatrix *tm, int ti, int tj, int dirty)     // Releases a tile given by 'tile_pin_la'.
+{
+    int s;
+
+    pthread_mutex_lock(&tm->lock);
+
+    s = tm->where[ti * tm->tcols + tj];
+
+    tm->slots[s].pins--;
+
+    if (dirty)
+        tm->slots[s].dirty = 1;
+
+    pthread_cond_broadcast(&tm->ready);
+
+    pthread_mutex_unlock(&tm->lock);
+}
+
+static void tile_prefetch_la(TiledMatrix *tm, int ti, int tj)     // Asks for a tile to be read in advance.
+{
+    int index = ti * tm->tcols + tj;
+
+    if (ti >= tm->trows || tj >= tm->tcols)
+        return;
+
+    pthread_mutex_lock(&tm->lock);
+
+    if (tm->where[index] < 0 && tm->qlen < tm->nslots)
+    {
+        tm->queue[(tm->qhead + tm->qlen) % tm->nslots] = index;
+
+        tm->qlen++;
+
+        pthread_cond_signal(&tm->request);
+    }
+
+    pthread_mutex_unlock(&tm->lock);
+}
+
+static void tile_flush_la(int nmbr, TiledMatrix *tm)   // Writes the modified tiles in the cache.
+{
+    register int s;
+
+    pthread_mutex_lock(&tm->lock);
+
+    for (s = 0; s < tm->nslots; s++)
+    {
+        if (tm->slots[s].index >= 0 && tm->slots[s].dirty && !tm->slots[s].loading)
+        {
+            if (!tile_io_la(tm, tm->slots[s].index, tm->slots[s].a, 1))
+            {
+                error_message_la(nmbr, "error writing the file of a tiled matrix!");
+
+                exit(nmbr);
+            }
+
+            tm->slots[s].dirty = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&tm->lock);
+}
+
+static TiledMatrix* tiled_setup_la(int nmbr, int fd, int m, int n, int tile, long long budget)  // Creates the structure and the cache of a tiled matrix.
+{
+    register int s;
+    TiledMatrix *tm;
+    double *mem;
+
+    tm = calloc(1, sizeof(TiledMatrix));
+
+    if (tm == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    tm->row = m;
+
+    tm->col = n;
+
+    tm->tile = tile;
+
+    tm->trows = (m + tile - 1) / tile;
+
+    tm->tcols = (n + tile - 1) / tile;
+
+    tm->fd = fd;
+
+    tm->nslots = (int) (budget / (long long) tile_bytes_la(tm));
+
+    if (tm->nslots < TILED_MIN_SLOTS)
+        tm->nslots = TILED_MIN_SLOTS;
+
+    if ((long long) tm->nslots > (long long) tm->trows * tm->tcols + TILED_MIN_SLOTS)  // More slots than tiles are useless.
+        tm->nslots = tm->trows * tm->tcols + TILED_MIN_SLOTS;
+
+    tm->slots = calloc(tm->nslots, sizeof(TileSlot));
+
+    tm->where = malloc((size_t) tm->trows * tm->tcols * sizeof(int));
+
+    tm->queue = malloc(tm->nslots * sizeof(int));
+
+    mem = malloc(tm->nslots * tile_bytes_la(tm));
+
+    if (tm->slots == NULL || tm->where == NULL || tm->queue == NULL || mem == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    LA_STATS_BYTES(nmbr, (long long) tm->nslots * tile_bytes_la(tm));
+
+    for (s = 0; s < tm->nslots; s++)
+    {
+        tm->slots[s].index = -1;
+
+        tm->slots[s].a = mem + (size_t) s * tm->tile * tm->tile;
+    }
+
+    for (s = 0; s < tm->trows * tm->tcols; s++)
+        tm->where[s] = -1;
+
+    pthread_mutex_init(&tm->lock, NULL);
+
+    pthread_cond_init(&tm->ready, NULL);
+
+    pthread_cond_init(&tm->request, NULL);
+
+    if (pthread_create(&tm->prefetcher, NULL, tile_prefetcher_la, tm) != 0)
+    {
+        error_message_la(nmbr, "error creating the thread of a tiled matrix!");
+
+        exit(nmbr);
+    }
+
+    return tm;
+}
+
+// c = c + alpha * a * b, for blocks in contiguous buffers
+static void block_gemm_acc_la(int m, int k, int n, double alpha, double *a, int lda, double *b, int ldb, double *c, int ldc)
+{
+    register int i, l;
     double fctr;
 
+    #pragma omp parallel for private(l, fctr) if ((double) m * k * n >= tuning_la.gemm_parallel)
+    for (i = 0; i < m; i++)
+    {
+        for (l = 0; l < k; l++)
+        {
+            fctr = alpha * a[(size_t) i * lda + l];
+
+            kernels()->axpy(fctr, b + (size_t) l * ldb, c + (size_t) i * ldc, n);
+        }
+    }
+}
+
+TiledMatrix* create_tiled_matrix(char *path, int m, int n, int tile, long long budget)  // Creates a matrix of zeros stored by tiles in a file.
+{
+    char header[TILED_HEADER] = TILED_MAGIC;
+    int fd, dims[3];
+
+    TiledMatrix *tm;
+
+    if (path == NULL)
+    {
+        error_message_la(74, "NULL file name informed!");
+
+        return NULL;
+    }
+    else if (m <= 0 || n <= 0 || tile <= 0)
+    {
+        error_message_la(74, "incompatible dimensions for a tiled matrix!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(74);
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+    {
+        error_message_la(74, ERRMSS03);
+
+        LA_STATS_STOP(74, 0);
+
+        return NULL;
+    }
+
+    dims[0] = m;
+
+    dims[1] = n;
+
+    dims[2] = tile;
+
+    memcpy(header + 8, dims, sizeof(dims));
+
+    tm = tiled_setup_la(74, fd, m, n, tile, budget);
+
+    if (pwrite(fd, header, TILED_HEADER, 0) != TILED_HEADER ||               // The tiles are left as a hole of zeros.
+        ftruncate(fd, tile_offset_la(tm, tm->trows * tm->tcols)) != 0)
+    {
+        error_message_la(74, "error writing the file of a tiled matrix!");
+
+        exit(74);
+    }
+
+    LA_STATS_STOP(74, 0);
+
+    return tm;
+}
+
+TiledMatrix* open_tiled_matrix(char *path, long long budget)   // Opens a matrix saved by tiles in a file.
+{
+    char header[TILED_HEADER];
+    int fd, dims[3];
+
+    TiledMatrix *tm;
+
+    if (path == NULL)
+    {
+        error_message_la(75, "NULL file name informed!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(75);
+
+    fd = open(path, O_RDWR);
+
+    if (fd < 0)
+    {
+        error_message_la(75, ERRMSS03);
+
+        LA_STATS_STOP(75, 0);
+
+        return NULL;
+    }
+
+    if (pread(fd, header, TILED_HEADER, 0) != TILED_HEADER || memcmp(header, TILED_MAGIC, 8) != 0)
+    {
+        error_message_la(75, "the file does not hold a tiled matrix!");
+
+        close(fd);
+
+        LA_STATS_STOP(75, 0);
+
+        return NULL;
+    }
+
+    memcpy(dims, header + 8, sizeof(dims));
+
+    if (dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0)
+    {
+        error_message_la(75, "the file does not hold a tiled matrix!");
+
+        close(fd);
+
+        LA_STATS_STOP(75, 0);
+
+        return NULL;
+    }
+
+    tm = tiled_setup_la(75, fd, dims[0], dims[1], dims[2], budget);
+
+    LA_STATS_STOP(75, 0);
+
+    return tm;
+}
+
+void free_tiled_matrix(TiledMatrix *tm)     // Saves the changes of a tiled matrix and frees its memory. The file is kept.
+{
+    if (tm == NULL)
+        return;
+
+    LA_STATS_START(76);
+
+    pthread_mutex_lock(&tm->lock);
+
+    tm->stop = 1;
+
+    pthread_cond_signal(&tm->request);
+
+    pthread_mutex_unlock(&tm->lock);
+
+    pthread_join(tm->prefetcher, NULL);
+
+    tile_flush_la(76, tm);
+
+    close(tm->fd);
+
+    pthread_mutex_destroy(&tm->lock);
+
+    pthread_cond_destroy(&tm->ready);
+
+    pthread_cond_destroy(&tm->request);
+
+    free(tm->slots[0].a);
+
+    free(tm->slots);
+
+    free(tm->where);
+
+    free(tm->queue);
+
+    free(tm);
+
+    LA_STATS_STOP(76, 0);
+}
+
+void insert_in_tiled_matrix(double a, TiledMatrix *tm, int i, int j)     // Inserts a value in a tiled matrix in a given position.
+{
+    double *t;
+
+    if (tm == NULL)
+    {
+        error_message_la(77, ERRMSS04);
+
+        return;
+    }
+    else if (i < 0 || i >= tm->row || j < 0 || j >= tm->col)
+    {
+        error_message_la(77, "inexistent position in the matrix!");
+
+        return;
+    }
+
+    LA_STATS_START(77);
+
+    t = tile_pin_la(77, tm, i / tm->tile, j / tm->tile, 1);
+
+    t[(i % tm->tile) * tm->tile + j % tm->tile] = a;
+
+    tile_unpin_la(tm, i / tm->tile, j / tm->tile, 1);
+
+    LA_STATS_STOP(77, 0);
+}
+
+double get_from_tiled_matrix(TiledMatrix *tm, int i, int j)     // Gets a value in a tiled matrix from a given position.
+{
+    double a, *t;
+
+    if (tm == NULL)
+    {
+        error_message_la(78, ERRMSS04);
+
+        return 0;
+    }
+    else if (i < 0 || i >= tm->row || j < 0 || j >= tm->col)
+    {
+        error_message_la(78, "inexistent position in the matrix!");
+
+        return 0;
+    }
+
+    LA_STATS_START(78);
+
+    t = tile_pin_la(78, tm, i / tm->tile, j / tm->tile, 1);
+
+    a = t[(i % tm->tile) * tm->tile + j % tm->tile];
+
+    tile_unpin_la(tm, i / tm->tile, j / tm->tile, 0);
+
+    LA_STATS_STOP(78, 0);
+
+    return a;
+}
+
+TiledMatrix* matrix_to_tiled_matrix(Matrix *mat, char *path, int tile, long long budget)     // Saves a matrix as a tiled matrix.
+{
+    register int i, ti, tj;
+    int rows, cols;
+    double *t;
+
+    TiledMatrix *tm;
+
+    if (mat == NULL)
+    {
+        error_message_la(79, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(79);
+
+    tm = create_tiled_matrix(path, mat->row, mat->col, tile, budget);
+
+    if (tm == NULL)
+    {
+        LA_STATS_STOP(79, 0);
+
+        return NULL;
+    }
+
+    for (ti = 0; ti < tm->trows; ti++)
+    {
+        rows = (mat->row - ti * tile < tile) ? mat->row - ti * tile : tile;
+
+        for (tj = 0; tj < tm->tcols; tj++)
+        {
+            cols = (mat->col - tj * tile < tile) ? mat->col - tj * tile : tile;
+
+            t = tile_pin_la(79, tm, ti, tj, 0);
+
+            for (i = 0; i < rows; i++)
+                memcpy(t + (size_t) i * tile, mat->m[ti * tile + i] + tj * tile, cols * sizeof(double));
+
+            tile_unpin_la(tm, ti, tj, 1);
+        }
+    }
+
+    LA_STATS_STOP(79, 0);
+
+    return tm;
+}
+
+Matrix* tiled_matrix_to_matrix(TiledMatrix *tm)     // Loads a tiled matrix in memory.
+{
+    register int i, ti, tj;
+    int rows, cols, tile;
+    double *t;
+
+    Matrix *mat;
+
+    if (tm == NULL)
+    {
+        error_message_la(80, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(80);
+
+    tile = tm->tile;
+
+    mat = create_matrix(tm->row, tm->col);
+
+    for (ti = 0; ti < tm->trows; ti++)
+    {
+        rows = (tm->row - ti * tile < tile) ? tm->row - ti * tile : tile;
+
+        for (tj = 0; tj < tm->tcols; tj++)
+        {
+            cols = (tm->col - tj * tile < tile) ? tm->col - tj * tile : tile;
+
+            tile_prefetch_la(tm, ti, tj + 1);
+
+            t = tile_pin_la(80, tm, ti, tj, 1);
+
+            for (i = 0; i < rows; i++)
+                memcpy(mat->m[ti * tile + i] + tj * tile, t + (size_t) i * tile, cols * sizeof(double));
+
+            tile_unpin_la(tm, ti, tj, 0);
+        }
+    }
+
+    LA_STATS_STOP(80, 0);
+
+    return mat;
+}
+
+int tiled_matrix_times_matrix(TiledMatrix *a, TiledMatrix *b, TiledMatrix *c)      // Multiplies two tiled matrixes and saves the result in a third one.
+{
+    register int ti, tj, tk;
+    int t;
+    double *ct, *at, *bt;
+
+    if (a == NULL || b == NULL || c == NULL)
+    {
+        error_message_la(81, ERRMSS04);
+
+        return 0;
+    }
+
+    if (a->col != b->row || c->row != a->row || c->col != b->col)     // Tests the compatibility of dimensions.
+    {
+        error_message_la(81, "incompatible dimensions for a matrix multiplication!");
+
+        return 0;
+    }
+    else if (a->tile != b->tile || a->tile != c->tile)
+    {
+        error_message_la(81, "the tiled matrices must have the same tile size!");
+
+        return 0;
+    }
+    else if (c == a || c == b)
+    {
+        error_message_la(81, "the result must be a different matrix!");
+
+        return 0;
+    }
+
+    LA_STATS_START(81);
+
+    t = a->tile;
+
+    for (ti = 0; ti < c->trows; ti++)
+    {
+        for (tj = 0; tj < c->tcols; tj++)
+        {
+            ct = tile_pin_la(81, c, ti, tj, 0);
+
+            memset(ct, 0, tile_bytes_la(c));
+
+            for (tk = 0; tk < a->tcols; tk++)
+            {
+                if (tk + 1 < a->tcols)              // The next tiles are read while this product is calculated.
+                {
+                    tile_prefetch_la(a, ti, tk + 1);
+
+                    tile_prefetch_la(b, tk + 1, tj);
+                }
+                else
+                {
+                    tile_prefetch_la(a, ti + (tj + 1 == c->tcols), 0);
+
+                    tile_prefetch_la(b, 0, (tj + 1) % c->tcols);
+                }
+
+                at = tile_pin_la(81, a, ti, tk, 1);
+
+                bt = tile_pin_la(81, b, tk, tj, 1);
+
+                block_gemm_acc_la(t, t, t, 1, at, t, bt, t, ct, t);
+
+                tile_unpin_la(a, ti, tk, 0);
+
+                tile_unpin_la(b, tk, tj, 0);
+            }
+
+            tile_unpin_la(c, ti, tj, 1);
+        }
+    }
+
+    LA_STATS_STOP(81, 2.0 * a->row * a->col * b->col);
+
+    return 1;
+}
+
+int tiled_transpose_matrix(TiledMatrix *mat, TiledMatrix *tr)      // Transposes a tiled matrix and saves the result in another one.
+{
+    register int i, j, ti, tj;
+    int t;
+    double *src, *dst;
+
+    if (mat == NULL || tr == NULL)
+    {
+        error_message_la(82, ERRMSS04);
+
+        return 0;
+    }
+
+    if (mat->row != tr->col || mat->col != tr->row || mat->tile != tr->tile)     // Tests the compatibility of dimensions.
+    {
+        error_message_la(82, "incompatible dimensions for a transposition!");
+
+        return 0;
+    }
+    else if (mat == tr)
+    {
+        error_message_la(82, "the result must be a different matrix!");
+
+        return 0;
+    }
+
+    LA_STATS_START(82);
+
+    t = mat->tile;
+
+    for (ti = 0; ti < mat->trows; ti++)
+    {
+        for (tj = 0; tj < mat->tcols; tj++)
+        {
+            tile_prefetch_la(mat, ti + (tj + 1 == mat->tcols), (tj + 1) % mat->tcols);
+
+            src = tile_pin_la(82, mat, ti, tj, 1);
+
+            dst = tile_pin_la(82, tr, tj, ti, 0);
+
+            for (i = 0; i < t; i++)
+            {
+                for (j = 0; j < t; j++)
+                    dst[(size_t) j * t + i] = src[(size_t) i * t + j];
+            }
+
+            tile_unpin_la(mat, ti, tj, 0);
+
+            tile_unpin_la(tr, tj, ti, 1);
+        }
+    }
+
+    LA_STATS_STOP(82, 0);
+
+    return 1;
+}
+
+static void tiled_swap_rows_la(TiledMatrix *tm, int r1, int r2, int tj)    // Swaps two rows in a column of tiles.
+{
+    int t = tm->tile;
+    double *a, *b, temp;
+    register int j;
+
+    a = tile_pin_la(83, tm, r1 / t, tj, 1);
+
+    b = tile_pin_la(83, tm, r2 / t, tj, 1);
+
+    a += (size_t) (r1 % t) * t;
+
+    b += (size_t) (r2 % t) * t;
+
+    for (j = 0; j < t; j++)
+    {
+        temp = a[j];
+
+        a[j] = b[j];
+
+        b[j] = temp;
+    }
+
+    tile_unpin_la(tm, r1 / t, tj, 1);
+
+    tile_unpin_la(tm, r2 / t, tj, 1);
+}
+
+int tiled_lu_decomposition(TiledMatrix *tm, int *perm)     // Transforms a square tiled matrix into its LU decomposition with partial pivoting.
+{
+    register int i, j, c;
+    int t, n, k, k0, w, rows, ti, tj, piv, sign = 1, rv, *swaps;
+    double *panel, *tl, *u, fctr, temp;
+
+    if (tm == NULL)
+    {
+        error_message_la(83, ERRMSS04);
+
+        return 0;
+    }
+    else if (perm == NULL)
+    {
+        error_message_la(83, "NULL permutation informed!");
+
+        return 0;
+    }
+    else if (tm->row != tm->col)                    // Tests if the matrix is square.
+    {
+        error_message_la(83, "incompatible dimensions for a LU decomposition!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return 0;
+    }
+
+    LA_STATS_START(83);
+
+    t = tm->tile;
+
+    n = tm->row;
+
+    panel = malloc((size_t) n * t * sizeof(double));  // Column of tiles being factored, kept in memory
+
+    swaps = malloc(t * sizeof(int));
+
+    if (panel == NULL || swaps == NULL)
+    {
+        error_message_la(83, ERRMSS01);
+
+        exit(83);
+    }
+
+    LA_STATS_BYTES(83, (long long) n * t * sizeof(double));
+
+    for (i = 0; i < n; i++)
+        perm[i] = i;
+
+    for (k = 0; k < tm->tcols; k++)
+    {
+        k0 = k * t;
+
+        w = (n - k0 < t) ? n - k0 : t;
+
+        rows = n - k0;
+
+        for (ti = k; ti < tm->trows; ti++)          // Loads the panel.
+        {
+            tile_prefetch_la(tm, ti + 1, k);
+
+            tl = tile_pin_la(83, tm, ti, k, 1);
+
+            rv = (n - ti * t < t) ? n - ti * t : t;
+
+            memcpy(panel + (size_t) (ti * t - k0) * t, tl, (size_t) rv * t * sizeof(double));
+
+            tile_unpin_la(tm, ti, k, 0);
+        }
+
+        for (c = 0; c < w; c++)                     // Factors the panel, with the pivots searched in all of its rows.
+        {
+            piv = c;
+
+            for (i = c + 1; i < rows; i++)
+            {
+                if (fabs(panel[(size_t) i * t + c]) > fabs(panel[(size_t) piv * t + c]))
+                    piv = i;
+            }
+
+            if (panel[(size_t) piv * t + c] == 0)   // Singular matrix
+            {
+                free(panel);
+
+                free(swaps);
+
+                LA_STATS_STOP(83, 2.0 * k0 * n * n);
+
+                return 0;
+            }
+
+            swaps[c] = piv;
+
+            if (piv != c)
+            {
+                for (j = 0; j < t; j++)
+                {
+                    temp = panel[(size_t) c * t + j];
+
+                    panel[(size_t) c * t + j] = panel[(size_t) piv * t + j];
+
+                    panel[(size_t) piv * t + j] = temp;
+                }
+
+                i = perm[k0 + c];
+
+                perm[k0 + c] = perm[k0 + piv];
+
+                perm[k0 + piv] = i;
+
+                sign = - sign;
+            }
+
+            for (i = c + 1; i < rows; i++)
+            {
+                if (panel[(size_t) i * t + c] == 0)
+                    continue;
+
+                fctr = panel[(size_t) i * t + c] /= panel[(size_t) c * t + c];   // Multiplier, kept in 'L'.
+
+                for (j = c + 1; j < w; j++)
+                    panel[(size_t) i * t + j] -= fctr * panel[(size_t) c * t + j];
+            }
+        }
+
+        for (ti = k; ti < tm->trows; ti++)          // Saves the panel.
+        {
+            tl = tile_pin_la(83, tm, ti, k, 1);
+
+            rv = (n - ti * t < t) ? n - ti * t : t;
+
+            memcpy(tl, panel + (size_t) (ti * t - k0) * t, (size_t) rv * t * sizeof(double));
+
+            tile_unpin_la(tm, ti, k, 1);
+        }
+
+        for (tj = 0; tj < tm->tcols; tj++)          // Applies the row swaps to the other columns of tiles.
+        {
+            if (tj == k)
+                continue;
+
+            for (c = 0; c < w; c++)
+            {
+                if (swaps[c] != c)
+                    tiled_swap_rows_la(tm, k0 + c, k0 + swaps[c], tj);
+            }
+        }
+
+        for (tj = k + 1; tj < tm->tcols; tj++)      // Row of tiles of 'U': solves 'L11 * U12 = A12'.
+        {
+            tile_prefetch_la(tm, k, tj + 1);
+
+            u = tile_pin_la(83, tm, k, tj, 1);
+
+            for (c = 0; c < w; c++)
+            {
+                for (i = c + 1; i < w; i++)
+                    kernels()->axpy(- panel[(size_t) i * t + c], u + (size_t) c * t, u + (size_t) i * t, t);
+            }
+
+            tile_unpin_la(tm, k, tj, 1);
+        }
+
+        for (tj = k + 1; tj < tm->tcols; tj++)      // Updates the rest of the matrix: 'A22 = A22 - L21 * U12'.
+        {
+            u = tile_pin_la(83, tm, k, tj, 1);
+
+            for (ti = k + 1; ti < tm->trows; ti++)
+            {
+                tile_prefetch_la(tm, ti + 1, tj);
+
+                tl = tile_pin_la(83, tm, ti, tj, 1);
+
+                rv = (n - ti * t < t) ? n - ti * t : t;
+
+                block_gemm_acc_la(rv, w, t, -1, panel + (size_t) (ti * t - k0) * t, t, u, t, tl, t);
+
+                tile_unpin_la(tm, ti, tj, 1);
+            }
+
+            tile_unpin_la(tm, k, tj, 0);
+        }
+    }
+
+    free(panel);
+
+    free(swaps);
+
+    LA_STATS_STOP(83, 2.0 * n * n * n / 3);
+
+    return sign;
+}
+
+void sync_tiled_matrix(TiledMatrix *tm)     // Writes the modified tiles of a tiled matrix to its file.
+{
+    if (tm == NULL)
+    {
+        error_message_la(84, ERRMSS04);
+
+        return;
+    }
+
+    LA_STATS_START(84);
+
+    tile_flush_la(84, tm);
+
+    LA_STATS_STOP(84, 0);
+}
+
+int tiled_matrix_row_number(TiledMatrix *tm)       // Gives the number of rows of a tiled matrix.
+{
+    if (tm == NULL)
+        return 0;
+
+    LA_STATS_COUNT(85);
+
+    return tm->row;
+}
+
+int tiled_matrix_column_number(TiledMatrix *tm)    // Gives the number of columns of a tiled matrix.
+{
+    if (tm == NULL)
+        return 0;
+
+    LA_STATS_COUNT(86);
+
+    return tm->col;
+}
+
+// Asynchronous tasks:
+//
+// A pool of worker threads, started on the first task, runs the tasks in the
+// order they were submitted. The long loops of the operations check, through
+// 'task_current_la', whether their task was cancelled, and record its progress.
+
+static pthread_mutex_t pool_lock_la = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t pool_work_la = PTHREAD_COND_INITIALIZER;  // A task was queued, or the workers must stop.
+
+static pthread_cond_t pool_done_la = PTHREAD_COND_INITIALIZER;  // A task finished.
+
+static AsyncTask *pool_head_la = NULL, *pool_tail_la = NULL;    // Queue of pending tasks
+
+static pthread_t *pool_workers_la = NULL;
+
+static int pool_size_la = 0, pool_stop_la = 0;
+
+static void task_free_result_la(AsyncTask *task, void *result)
+{
+    if (task->array)
+        free_array(result);
+    else
+        free_matrix(result);
+}
+
+static void task_release_la(AsyncTask *task)   // Frees a finished task, and its result if the caller never got it.
+{
+    if (!task->taken)
+        task_free_result_la(task, task->result);
+
+    free_matrix(task->a);
+
+    free_matrix(task->b);
+
+    free(task);
+}
+
+static void task_finish_la(AsyncTask *task, int status, void *result)     // Records the end of a task and calls its callback.
+{
+    pthread_mutex_lock(&pool_lock_la);
+
+    task->status = status;
+
+    task->result = result;
+
+    if (status == TASK_DONE)
+        atomic_store(&task->progress, 1000000);
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    if (task->done != NULL)
+        task->done(task, task->data);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    task->finished = 1;
+
+    pthread_cond_broadcast(&pool_done_la);
+
+    if (task->released)
+        task_release_la(task);
+
+    pthread_mutex_unlock(&pool_lock_la);
+}
+
+static void* pool_worker_la(void *arg)          // Runs the queued tasks until the pool is stopped.
+{
+    AsyncTask *task;
+    void *result;
+
+    (void) arg;
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    for (;;)
+    {
+        while (pool_head_la == NULL && !pool_stop_la)
+            pthread_cond_wait(&pool_work_la, &pool_lock_la);
+
+        if (pool_head_la == NULL)
+            break;
+
+        task = pool_head_la;
+
+        pool_head_la = task->next;
+
+        if (pool_head_la == NULL)
+            pool_tail_la = NULL;
+
+        task->status = TASK_RUNNING;
+
+        pthread_mutex_unlock(&pool_lock_la);
+
+        task_current_la = task;
+
+        result = task->run(task);
+
+        task_current_la = NULL;
+
+        if (atomic_load(&task->cancel))             // A result found after the cancellation is discarded.
+        {
+            task_free_result_la(task, result);
+
+            task_finish_la(task, TASK_CANCELLED, NULL);
+        }
+        else
+            task_finish_la(task, result != NULL ? TASK_DONE : TASK_FAILED, result);
+
+        pthread_mutex_lock(&pool_lock_la);
+    }
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    return NULL;
+}
+
+static int pool_start_la(int nmbr, int workers)     // Starts the workers, if they are not running. The lock must be held.
+{
+    register int i;
+    long cpus;
+
+    if (pool_size_la > 0)
+        return pool_size_la;
+
+    if (workers <= 0)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        workers = (cpus > 0) ? (int) cpus : 1;
+    }
+
+    pool_workers_la = malloc(workers * sizeof(pthread_t));
+
+    if (pool_workers_la == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    pool_stop_la = 0;
+
+    for (i = 0; i < workers; i++)
+    {
+        if (pthread_create(&pool_workers_la[i], NULL, pool_worker_la, NULL) != 0)
+        {
+            error_message_la(nmbr, "error creating the worker threads!");
+
+            exit(nmbr);
+        }
+    }
+
+    pool_size_la = workers;
+
+    return workers;
+}
+
+static void* run_inverse_la(AsyncTask *task)
+{
+    return inverse_matrix(task->a);
+}
+
+static void* run_product_la(AsyncTask *task)
+{
+    return matrix_times_matrix(task->a, task->b);
+}
+
+static void* run_solve_la(AsyncTask *task)
+{
+    return solve_system(task->a);
+}
+
+static AsyncTask* task_submit_la(int nmbr, void* (*run)(AsyncTask *task), Matrix *a, Matrix *b, TaskCallback done, void *data)  // Queues a task.
+{
+    AsyncTask *task = calloc(1, sizeof(AsyncTask));
+
+    if (task == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    task->run = run;
+
+    task->array = (run == run_solve_la);
+
+    task->a = copy_matrix(a);                       // The caller may change or free the arguments at once.
+
+    task->b = (b != NULL) ? copy_matrix(b) : NULL;
+
+    task->status = TASK_PENDING;
+
+    task->done = done;
+
+    task->data = data;
+
+    atomic_init(&task->cancel, 0);
+
+    atomic_init(&task->progress, 0);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    pool_start_la(nmbr, 0);
+
+    if (pool_tail_la != NULL)
+        pool_tail_la->next = task;
+    else
+        pool_head_la = task;
+
+    pool_tail_la = task;
+
+    pthread_cond_signal(&pool_work_la);
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    return task;
+}
+
+AsyncTask* inverse_matrix_async(Matrix *mat, TaskCallback done, void *data)    // Calculates the inverse of a matrix in the worker threads.
+{
+    if (mat == NULL)
+    {
+        error_message_la(87, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(87, "incompatible dimensions to do an inversion!");
+
+        return NULL;
+    }
+
+    LA_STATS_COUNT(87);
+
+    return task_submit_la(87, run_inverse_la, mat, NULL, done, data);
+}
+
+AsyncTask* matrix_times_matrix_async(Matrix *a, Matrix *b, TaskCallback done, void *data)     // Multiplies two matrixes in the worker threads.
+{
+    if (a == NULL || b == NULL)
+    {
+        error_message_la(88, ERRMSS04);
+
+        return NULL;
+    }
+    else if (a->col != b->row)                      // Tests the compatibility of dimensions.
+    {
+        error_message_la(88, "incompatible dimensions for a matrix multiplication!");
+
+        return NULL;
+    }
+
+    LA_STATS_COUNT(88);
+
+    return task_submit_la(88, run_product_la, a, b, done, data);
+}
+
+AsyncTask* solve_system_async(Matrix *mat, TaskCallback done, void *data)      // Solves a system of equations in the worker threads.
+{
+    if (mat == NULL)
+    {
+        error_message_la(89, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->col != mat->row + 1 || mat->row < 1)  // Tests the coherence of the numbers of equations and variables.
+    {
+        error_message_la(89, "incompatible dimensions to solve the system of equations!");
+
+        return NULL;
+    }
+
+    LA_STATS_COUNT(89);
+
+    return task_submit_la(89, run_solve_la, mat, NULL, done, data);
+}
+
+int task_status(AsyncTask *task)        // Gives the state of a task.
+{
+    int status;
+
+    if (task == NULL)
+    {
+        error_message_la(90, "NULL task informed!");
+
+        return TASK_FAILED;
+    }
+
+    LA_STATS_COUNT(90);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    status = task->status;
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    return status;
+}
+
+double task_progress(AsyncTask *task)   // Gives the fraction of the work of a task already done.
+{
+    if (task == NULL)
+    {
+        error_message_la(91, "NULL task informed!");
+
+        return 0;
+    }
+
+    LA_STATS_COUNT(91);
+
+    return fmin(1, atomic_load(&task->progress) / 1e6);
+}
+
+int task_cancel(AsyncTask *task)        // Asks a task to stop.
+{
+    AsyncTask **p;
+    int pending = 0;
+
+    if (task == NULL)
+    {
+        error_message_la(92, "NULL task informed!");
+
+        return 0;
+    }
+
+    LA_STATS_COUNT(92);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    if (task->status != TASK_PENDING && task->status != TASK_RUNNING)
+    {
+        pthread_mutex_unlock(&pool_lock_la);
+
+        return 0;
+    }
+
+    atomic_store(&task->cancel, 1);
+
+    if (task->status == TASK_PENDING)               // Not started: it leaves the queue at once.
+    {
+        for (p = &pool_head_la; *p != task; p = &(*p)->next);
+
+        *p = task->next;
+
+        if (pool_tail_la == task)
+        {
+            pool_tail_la = NULL;
+
+            for (p = &pool_head_la; *p != NULL; p = &(*p)->next)
+                pool_tail_la = *p;
+        }
+
+        task->status = TASK_RUNNING;                // Until the callback has run
+
+        pending = 1;
+    }
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    if (pending)
+        task_finish_la(task, TASK_CANCELLED, NULL);
+
+    return 1;
+}
+
+void* task_wait(AsyncTask *task)        // Waits for the end of a task and gives its result.
+{
+    void *result;
+
+    if (task == NULL)
+    {
+        error_message_la(93, "NULL task informed!");
+
+        return NULL;
+    }
+
+    LA_STATS_COUNT(93);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    while (!task->finished)
+        pthread_cond_wait(&pool_done_la, &pool_lock_la);
+
+    result = task->result;
+
+    task->taken = 1;
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    return result;
+}
+
+void free_task(AsyncTask *task)         // Frees a task, at once or when it finishes.
+{
+    if (task == NULL)
+        return;
+
+    LA_STATS_COUNT(94);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    if (task->finished)
+        task_release_la(task);
+    else
+        task->released = 1;
+
+    pthread_mutex_unlock(&pool_lock_la);
+}
+
+int linalg_start_workers(int workers)   // Starts the worker threads of the asynchronous functions.
+{
+    int res;
+
+    LA_STATS_COUNT(95);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    res = pool_start_la(95, workers);
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    return res;
+}
+
+void linalg_stop_workers(void)          // Stops the worker threads after the queued tasks.
+{
+    register int i;
+    int workers;
+    pthread_t *threads;
+
+    LA_STATS_COUNT(96);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    workers = pool_size_la;
+
+    threads = pool_workers_la;
+
+    pool_stop_la = 1;
+
+    pthread_cond_broadcast(&pool_work_la);
+
+    pthread_mutex_unlock(&pool_lock_la);
+
+    for (i = 0; i < workers; i++)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_lock(&pool_lock_la);
+
+    if (pool_workers_la == threads)
+    {
+        free(pool_workers_la);
+
+        pool_workers_la = NULL;
+
+        pool_size_la = 0;
+    }
+
+    pthread_mutex_unlock(&pool_lock_la);
+}
+
+// Task-graph factorizations:
+//
+// The matrix is copied to square tiles and each factorization is described as
+// a graph of tasks, each one applying a kernel to a few tiles. The dependencies
+// are found from the tiles that each task reads and writes, in the order of the
+// sequential algorithm, so the graph runs the same operations on the same data.
+// Each thread keeps a deque of ready tasks: it runs the newest of its own and,
+// when it has none, steals the oldest of another thread. The tasks that finish
+// a step release the next ones in the same thread, the factorization of the
+// next panel last, so that it runs first and overlaps the rest of the update.
+
+#define DAG_READ 1                                              // Accesses of the tasks to the tiles
+#define DAG_WRITE 2
+
+#define DAG_PANEL 2                                             // Priorities of the tasks
+#define DAG_NEXT 1                                              // Update of the next panel
+#define DAG_UPDATE 0
+
+typedef struct dag_graph DagGraph;
+
+typedef struct dag_task
+{
+	void (*kernel)(DagGraph *g, int k, int i, int j, double *work);
+
+	int k;                                                      // Step of the factorization
+
+	int i;                                                      // Tile written by the task
+
+	int j;
+
+	int priority;
+
+	atomic_int waiting;                                         // Unfinished tasks it depends on
+
+	int *next;                                                  // Tasks that depend on it
+
+	int nnext;
+
+	int maxnext;
+} DagTask;
+
+typedef struct dag_deque                                        // Ready tasks of a thread
+{
+	pthread_mutex_t lock;
+
+	int *item;
+
+	int top;                                                    // The other threads steal from the top.
+
+	int bottom;                                                 // The owner pushes and takes at the bottom.
+} DagDeque;
+
+struct dag_graph
+{
+	int t;                                                      // Order of the tiles
+
+	int mt;                                                     // Rows and columns of tiles
+
+	int nt;
+
+	double *a;                                                  // Tiles of the matrix, each one contiguous by rows
+
+	double *q;                                                  // Tiles of 'Q' (QR only)
+
+	double *tau;                                                // Factors of the reflections (QR), 't' for each tile
+
+	int *ipiv;                                                  // Rows of the pivots (LU), counted in the whole matrix
+
+	atomic_int failed;                                          // A kernel found a singular or not positive definite matrix.
+
+	DagTask *task;
+
+	int ntask;
+
+	int maxtask;
+
+	int nres;                                                   // Tiles of 'a' and 'q' and pivots of the panels, whose accesses are followed
+
+	int *writer;                                                // Last task that wrote each one, or '-1'
+
+	int **readers;                                              // Tasks that read each one after it was last written
+
+	int *nreaders;
+
+	int *maxreaders;
+
+	DagDeque *deque;
+
+	int nthreads;
+
+	atomic_int remaining;                                       // Tasks not finished
+};
+
+typedef struct dag_worker
+{
+	DagGraph *g;
+
+	int self;                                                   // Index of its deque
+
+	double *work;                                               // 't' elements
+} DagWorker;
+
+#define DAG_TILE_OF(g, base, i, j) ((base) + ((size_t) (i) * (g)->nt + (j)) * (g)->t * (g)->t)
+#define DAG_RES_A(g, i, j) ((i) * (g)->nt + (j))
+#define DAG_RES_Q(g, i, j) ((g)->mt * (g)->nt + (i) * (g)->nt + (j))
+#define DAG_RES_PIV(g, k) (2 * (g)->mt * (g)->nt + (k))
+
+static void* dag_alloc_la(int nmbr, size_t size)
+{
+    void *p = calloc(size > 0 ? size : 1, 1);
+
+    if (p == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    return p;
+}
+
+static void* dag_grow_la(int nmbr, void *p, int *max, size_t elem)     // Doubles an array of '*max' elements.
+{
+    *max = (*max > 0) ? 2 * *max : 8;
+
+    p = realloc(p, *max * elem);
+
+    if (p == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    return p;
+}
+
+// Copies a matrix to tiles of 'tile x tile' elements. The tiles beyond the matrix
+// are filled with the identity if 'pad' is not zero, or with zeros.
+static DagGraph* dag_create_la(int nmbr, Matrix *mat, int tile, int pad, int qr)
+{
+    register int i, j;
+    int n;
+
+    DagGraph *g = dag_alloc_la(nmbr, sizeof(DagGraph));
+
+    g->t = tile;
+
+    g->mt = (mat->row + tile - 1) / tile;
+
+    g->nt = (mat->col + tile - 1) / tile;
+
+    g->a = dag_alloc_la(nmbr, (size_t) g->mt * g->nt * tile * tile * sizeof(double));
+
+    for (i = 0; i < mat->row; i++)
+    {
+        for (j = 0; j < mat->col; j++)
+            DAG_TILE_OF(g, g->a, i / tile, j / tile)[(i % tile) * tile + j % tile] = mat->m[i][j];
+    }
+
+    n = (g->mt < g->nt ? g->mt : g->nt) * tile;
+
+    for (i = (mat->row > mat->col ? mat->row : mat->col); pad && i < n; i++)
+        DAG_TILE_OF(g, g->a, i / tile, i / tile)[(i % tile) * (tile + 1)] = 1;
+
+    if (qr)
+        g->tau = dag_alloc_la(nmbr, (size_t) g->mt * g->nt * tile * sizeof(double));
+    else
+        g->ipiv = dag_alloc_la(nmbr, (size_t) g->nt * tile * sizeof(int));
+
+    atomic_init(&g->failed, 0);
+
+    g->nres = 2 * g->mt * g->nt + g->nt;
+
+    g->writer = dag_alloc_la(nmbr, g->nres * sizeof(int));
+
+    for (i = 0; i < g->nres; i++)
+        g->writer[i] = -1;
+
+    g->readers = dag_alloc_la(nmbr, g->nres * sizeof(int*));
+
+    g->nreaders = dag_alloc_la(nmbr, g->nres * sizeof(int));
+
+    g->maxreaders = dag_alloc_la(nmbr, g->nres * sizeof(int));
+
+    return g;
+}
+
+static void dag_free_la(DagGraph *g)
+{
+    register int i;
+
+    for (i = 0; i < g->ntask; i++)
+        free(g->task[i].next);
+
+    for (i = 0; i < g->nres; i++)
+        free(g->readers[i]);
+
+    free(g->task);
+    free(g->writer);
+    free(g->readers);
+    free(g->nreaders);
+    free(g->maxreaders);
+    free(g->a);
+    free(g->q);
+    free(g->tau);
+    free(g->ipiv);
+    free(g);
+}
+
+static void dag_edge_la(int nmbr, DagGraph *g, int from, int to)  // Makes task 'to' depend on task 'from'.
+{
+    DagTask *f = &g->task[from];
+
+    if (from == to || (f->nnext > 0 && f->next[f->nnext - 1] == to))  // Repeated while adding 'to'
+        return;
+
+    if (f->nnext == f->maxnext)
+        f->next = dag_grow_la(nmbr, f->next, &f->maxnext, sizeof(int));
+
+    f->next[f->nnext++] = to;
+
+    atomic_fetch_add_explicit(&g->task[to].waiting, 1, memory_order_relaxed);
+}
+
+// Adds a task to the graph. Its accesses must be given next by 'dag_access_la'.
+static void dag_task_la(int nmbr, DagGraph *g, void (*kernel)(DagGraph *g, int k, int i, int j, double *work),
+                        int k, int i, int j, int priority)
+{
+    DagTask *task;
+
+    if (g->ntask == g->maxtask)
+        g->task = dag_grow_la(nmbr, g->task, &g->maxtask, sizeof(DagTask));
+
+    task = &g->task[g->ntask++];
+
+    task->kernel = kernel;
+
+    task->k = k;
+
+    task->i = i;
+
+    task->j = j;
+
+    task->priority = priority;
+
+    atomic_init(&task->waiting, 0);
+
+    task->next = NULL;
+
+    task->nnext = task->maxnext = 0;
+}
+
+static void dag_access_la(int nmbr, DagGraph *g, int res, int mode)     // Records an access of the last task added.
+{
+    register int i;
+    int last = g->ntask - 1;
+
+    if (g->writer[res] >= 0)                        // Reads and writes wait for the last writer.
+        dag_edge_la(nmbr, g, g->writer[res], last);
+
+    if (mode == DAG_WRITE)                          // Writes also wait for the readers since then.
+    {
+        for (i = 0; i < g->nreaders[res]; i++)
+            dag_edge_la(nmbr, g, g->readers[res][i], last);
+
+        g->nreaders[res] = 0;
+
+        g->writer[res] = last;
+    }
+    else
+    {
+        if (g->nreaders[res] == g->maxreaders[res])
+            g->readers[res] = dag_grow_la(nmbr, g->readers[res], &g->maxreaders[res], sizeof(int));
+
+        g->readers[res][g->nreaders[res]++] = last;
+    }
+}
+
+static void dag_push_la(DagDeque *d, int id)
+{
+    pthread_mutex_lock(&d->lock);
+
+    d->item[d->bottom++] = id;
+
+    pthread_mutex_unlock(&d->lock);
+}
+
+static int dag_take_la(DagDeque *d, int steal)  // Takes the newest task of a deque, or the oldest if it is stolen; '-1' if empty.
+{
+    int id = -1;
+
+    pthread_mutex_lock(&d->lock);
+
+    if (d->bottom > d->top)
+        id = steal ? d->item[d->top++] : d->item[--d->bottom];
+
+    pthread_mutex_unlock(&d->lock);
+
+    return id;
+}
+
+static void* dag_worker_la(void *arg)           // Runs tasks until all of them have finished.
+{
+    register int i, v;
+    int id, p;
+
+    DagWorker *w = arg;
+    DagGraph *g = w->g;
+    DagTask *task, *next;
+
+    for (;;)
+    {
+        id = dag_take_la(&g->deque[w->self], 0);
+
+        for (v = 1; id < 0 && v < g->nthreads; v++)    // Steals from the others.
+            id = dag_take_la(&g->deque[(w->self + v) % g->nthreads], 1);
+
+        if (id < 0)
+        {
+            if (atomic_load(&g->remaining) == 0)
+                break;
+
+            sched_yield();
+
+            continue;
+        }
+
+        task = &g->task[id];
+
+        if (!atomic_load_explicit(&g->failed, memory_order_relaxed))   // After a failure, the tasks only release the next ones.
+            task->kernel(g, task->k, task->i, task->j, w->work);
+
+        for (p = DAG_UPDATE; p <= DAG_PANEL; p++)  // The most urgent tasks are pushed last, to be taken first.
+        {
+            for (i = 0; i < task->nnext; i++)
+            {
+                next = &g->task[task->next[i]];
+
+                if (next->priority == p && atomic_fetch_sub(&next->waiting, 1) == 1)
+                    dag_push_la(&g->deque[w->self], task->next[i]);
+            }
+        }
+
+        atomic_fetch_sub(&g->remaining, 1);
+    }
+
+    return NULL;
+}
+
+static void dag_run_la(int nmbr, DagGraph *g)   // Runs the tasks of a graph.
+{
+    register int i;
+    int nthreads = tuning_la.dag_workers;
+    long cpus;
+
+    DagWorker *workers;
+    pthread_t *threads;
+
+    if (nthreads <= 0)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        nthreads = (cpus > 0) ? (int) cpus : 1;
+    }
+
+    if (nthreads > g->ntask)
+        nthreads = (g->ntask > 0) ? g->ntask : 1;
+
+    g->nthreads = nthreads;
+
+    g->deque = dag_alloc_la(nmbr, nthreads * sizeof(DagDeque));
+
+    workers = dag_alloc_la(nmbr, nthreads * sizeof(DagWorker));
+
+    threads = dag_alloc_la(nmbr, nthreads * sizeof(pthread_t));
+
+    for (i = 0; i < nthreads; i++)
+    {
+        pthread_mutex_init(&g->deque[i].lock, NULL);
+
+        g->deque[i].item = dag_alloc_la(nmbr, (g->ntask > 0 ? g->ntask : 1) * sizeof(int));
+
+        workers[i].g = g;
+
+        workers[i].self = i;
+
+        workers[i].work = dag_alloc_la(nmbr, g->t * sizeof(double));
+    }
+
+    for (i = g->ntask - 1; i >= 0; i--)             // Initial tasks, the first ones on top
+    {
+        if (atomic_load(&g->task[i].waiting) == 0)
+            g->deque[0].item[g->deque[0].bottom++] = i;
+    }
+
+    atomic_init(&g->remaining, g->ntask);
+
+    for (i = 1; i < nthreads; i++)                  // This thread is the first worker.
+    {
+        if (pthread_create(&threads[i], NULL, dag_worker_la, &workers[i]) != 0)
+        {
+            error_message_la(nmbr, "error creating the worker threads!");
+
+            exit(nmbr);
+        }
+    }
+
+    dag_worker_la(&workers[0]);
+
+    for (i = 1; i < nthreads; i++)
+        pthread_join(threads[i], NULL);
+
+    for (i = 0; i < nthreads; i++)
+    {
+        pthread_mutex_destroy(&g->deque[i].lock);
+
+        free(g->deque[i].item);
+
+        free(workers[i].work);
+    }
+
+    free(g->deque);
+
+    free(workers);
+
+    free(threads);
+}
+
+// Kernels of the Cholesky decomposition, on the lower part:
+
+static void dag_potrf_la(DagGraph *g, int k, int i, int j, double *work)  // Factors a diagonal tile.
+{
+    register int r, c;
+    int t = g->t;
+    double d, *a = DAG_TILE_OF(g, g->a, k, k);
+
+    (void) i; (void) j; (void) work;
+
+    for (c = 0; c < t; c++)
+    {
+        d = a[c * t + c] - dot_la(a + c * t, a + c * t, c);
+
+        if (d <= 0)
+        {
+            atomic_store(&g->failed, 1);
+
+            return;
+        }
+
+        a[c * t + c] = d = sqrt(d);
+
+        for (r = c + 1; r < t; r++)
+            a[r * t + c] = (a[r * t + c] - dot_la(a + r * t, a + c * t, c)) / d;
+    }
+}
+
+static void dag_trsm_la(DagGraph *g, int k, int i, int j, double *work)   // A(i,k) = A(i,k) * inverse(transpose(L(k,k)))
+{
+    register int r, c;
+    int t = g->t;
+    double *l = DAG_TILE_OF(g, g->a, k, k), *x;
+
+    (void) j; (void) work;
+
+    for (r = 0; r < t; r++)
+    {
+        x = DAG_TILE_OF(g, g->a, i, k) + r * t;
+
+        for (c = 0; c < t; c++)
+            x[c] = (x[c] - dot_la(x, l + c * t, c)) / l[c * t + c];
+    }
+}
+
+static void dag_syrk_la(DagGraph *g, int k, int i, int j, double *work)   // A(i,i) = A(i,i) - A(i,k) * transpose(A(i,k))
+{
+    register int r, c;
+    int t = g->t;
+    double *a = DAG_TILE_OF(g, g->a, i, k), *b = DAG_TILE_OF(g, g->a, i, i);
+
+    (void) j; (void) work;
+
+    for (r = 0; r < t; r++)
+    {
+        for (c = 0; c <= r; c++)
+            b[r * t + c] -= dot_la(a + r * t, a + c * t, t);
+    }
+}
+
+static void dag_gemm_nt_la(DagGraph *g, int k, int i, int j, double *work)    // A(i,j) = A(i,j) - A(i,k) * transpose(A(j,k))
+{
+    register int r, c;
+    int t = g->t;
+    double *a = DAG_TILE_OF(g, g->a, i, k), *b = DAG_TILE_OF(g, g->a, j, k), *d = DAG_TILE_OF(g, g->a, i, j);
+
+    (void) work;
+
+    for (r = 0; r < t; r++)
+    {
+        for (c = 0; c < t; c++)
+            d[r * t + c] -= dot_la(a + r * t, b + c * t, t);
+    }
+}
+
+// Kernels of the LU decomposition with partial pivoting:
+
+static void dag_panel_la(DagGraph *g, int k, int i, int j, double *work)  // Factors the column of tiles 'k', from the diagonal down.
+{
+    register int r, c;
+    int t = g->t, n = g->mt * t, row, piv;
+    double fctr, *pr, *rr;
+
+    (void) i; (void) j; (void) work;
+
+    for (c = 0; c < t; c++)
+    {
+        row = k * t + c;
+
+        piv = row;
+
+        for (r = row + 1; r < n; r++)               // Searches for the largest element in all the tiles below.
+        {
+            if (fabs(DAG_TILE_OF(g, g->a, r / t, k)[(r % t) * t + c]) > fabs(DAG_TILE_OF(g, g->a, piv / t, k)[(piv % t) * t + c]))
+                piv = r;
+        }
+
+        g->ipiv[row] = piv;
+
+        pr = DAG_TILE_OF(g, g->a, piv / t, k) + (piv % t) * t;
+
+        if (pr[c] == 0)                             // Singular matrix
+        {
+            atomic_store(&g->failed, 1);
+
+            return;
+        }
+
+        rr = DAG_TILE_OF(g, g->a, k, k) + c * t;
+
+        if (piv != row)
+        {
+            for (r = 0; r < t; r++)
+            {
+                fctr = rr[r];
+
+                rr[r] = pr[r];
+
+                pr[r] = fctr;
+            }
+        }
+
+        for (r = row + 1; r < n; r++)
+        {
+            pr = DAG_TILE_OF(g, g->a, r / t, k) + (r % t) * t;
+
+            if (pr[c] == 0)
+                continue;
+
+            fctr = pr[c] /= rr[c];                  // Multiplier, kept in 'L'.
+
+            kernels()->axpy(- fctr, rr + c + 1, pr + c + 1, t - c - 1);
+        }
+    }
+}
+
+static void dag_swap_la(DagGraph *g, int k, int j)     // Applies the row swaps of panel 'k' to the column of tiles 'j'.
+{
+    register int r, c;
+    int t = g->t, row, piv;
+    double tmp, *a, *b;
+
+    for (c = 0; c < t; c++)
+    {
+        row = k * t + c;
+
+        piv = g->ipiv[row];
+
+        if (piv == row)
+            continue;
+
+        a = DAG_TILE_OF(g, g->a, row / t, j) + (row % t) * t;
+
+        b = DAG_TILE_OF(g, g->a, piv / t, j) + (piv % t) * t;
+
+        for (r = 0; r < t; r++)
+        {
+            tmp = a[r];
+
+            a[r] = b[r];
+
+            b[r] = tmp;
+        }
+    }
+}
+
+static void dag_laswp_la(DagGraph *g, int k, int i, int j, double *work)  // Swaps the rows of a column of tiles on the left of panel 'k'.
+{
+    (void) i; (void) work;
+
+    dag_swap_la(g, k, j);
+}
+
+static void dag_swptrsm_la(DagGraph *g, int k, int i, int j, double *work)    // Swaps the rows of a column on the right and solves A(k,j) with 'L(k,k)'.
+{
+    register int r, c;
+    int t = g->t;
+    double *l = DAG_TILE_OF(g, g->a, k, k), *u = DAG_TILE_OF(g, g->a, k, j);
+
+    (void) i; (void) work;
+
+    dag_swap_la(g, k, j);
+
+    for (r = 1; r < t; r++)
+    {
+        for (c = 0; c < r; c++)
+            kernels()->axpy(- l[r * t + c], u + c * t, u + r * t, t);
+    }
+}
+
+static void dag_gemm_nn_la(DagGraph *g, int k, int i, int j, double *work)    // A(i,j) = A(i,j) - A(i,k) * A(k,j)
+{
+    register int r, c;
+    int t = g->t;
+    double *a = DAG_TILE_OF(g, g->a, i, k), *b = DAG_TILE_OF(g, g->a, k, j), *d = DAG_TILE_OF(g, g->a, i, j);
+
+    (void) work;
+
+    for (r = 0; r < t; r++)
+    {
+        for (c = 0; c < t; c++)
+            kernels()->axpy(- a[r * t + c], b + c * t, d + r * t, t);
+    }
+}
+
+// Kernels of the QR decomposition. The reflections of a diagonal tile are kept
+// below its diagonal, with a unit first element not stored, and those that join
+// 'R' to a tile below, in that tile. 'tau' keeps their factors: I - tau * v * v'.
+
+static double dag_reflect_la(double *alpha, double sigma, double *scale)   // Reflection that takes (alpha, x) to (beta, 0), where 'sigma' is |x|^2.
+{
+    double beta;
+
+    if (sigma == 0)                                 // Nothing to reflect
+    {
+        *scale = 0;
+
+        return 0;
+    }
+
+    beta = sqrt(*alpha * *alpha + sigma);
+
+    if (*alpha > 0)                                 // Avoids cancellation in the first element of the vector.
+        beta = - beta;
+
+    *scale = 1 / (*alpha - beta);
+
+    sigma = (beta - *alpha) / beta;
+
+    *alpha = beta;
+
+    return sigma;
+}
+
+static void dag_geqrt_la(DagGraph *g, int k, int i, int j, double *work)  // Factors a diagonal tile.
+{
+    register int r, c;
+    int t = g->t;
+    double sigma, scale, tau, *a = DAG_TILE_OF(g, g->a, k, k), *taus = g->tau + ((size_t) k * g->nt + k) * t;
+
+    (void) i; (void) j;
+
+    for (c = 0; c < t; c++)
+    {
+        sigma = 0;
+
+        for (r = c + 1; r < t; r++)
+            sigma += a[r * t + c] * a[r * t + c];
+
+        taus[c] = tau = dag_reflect_la(a + c * t + c, sigma, &scale);
+
+        if (tau == 0)
+            continue;
+
+        for (r = c + 1; r < t; r++)
+            a[r * t + c] *= scale;
+
+        memcpy(work, a + c * t + c + 1, (t - c - 1) * sizeof(double));     // w = v' * A, by rows
+
+        for (r = c + 1; r < t; r++)
+            kernels()->axpy(a[r * t + c], a + r * t + c + 1, work, t - c - 1);
+
+        kernels()->axpy(- tau, work, a + c * t + c + 1, t - c - 1);
+
+        for (r = c + 1; r < t; r++)
+            kernels()->axpy(- tau * a[r * t + c], work, a + r * t + c + 1, t - c - 1);
+    }
+}
+
+// Applies the reflections of diagonal tile 'k' to tile 'b': from the first one
+// for the product by transpose(Q) and from the last one for the product by 'Q'.
+static void dag_apply_diag_la(DagGraph *g, int k, double *b, int forward, double *work)
+{
+    register int r, s;
+    int c, t = g->t;
+    double tau, *v = DAG_TILE_OF(g, g->a, k, k), *taus = g->tau + ((size_t) k * g->nt + k) * t;
+
+    for (s = 0; s < t; s++)
+    {
+        c = forward ? s : t - 1 - s;
+
+        tau = taus[c];
+
+        if (tau == 0)
+            continue;
+
+        memcpy(work, b + c * t, t * sizeof(double));
+
+        for (r = c + 1; r < t; r++)
+            kernels()->axpy(v[r * t + c], b + r * t, work, t);
+
+        kernels()->axpy(- tau, work, b + c * t, t);
+
+        for (r = c + 1; r < t; r++)
+            kernels()->axpy(- tau * v[r * t + c], work, b + r * t, t);
+    }
+}
+
+static void dag_tsqrt_la(DagGraph *g, int k, int i, int j, double *work)  // Joins tile A(i,k) to the triangle 'R' of A(k,k).
+{
+    register int r, c;
+    int t = g->t;
+    double sigma, scale, tau, *a = DAG_TILE_OF(g, g->a, k, k), *v = DAG_TILE_OF(g, g->a, i, k);
+    double *taus = g->tau + ((size_t) i * g->nt + k) * t;
+
+    (void) j;
+
+    for (c = 0; c < t; c++)
+    {
+        sigma = 0;
+
+        for (r = 0; r < t; r++)
+            sigma += v[r * t + c] * v[r * t + c];
+
+        taus[c] = tau = dag_reflect_la(a + c * t + c, sigma, &scale);
+
+        if (tau == 0)
+            continue;
+
+        for (r = 0; r < t; r++)
+            v[r * t + c] *= scale;
+
+        memcpy(work, a + c * t + c + 1, (t - c - 1) * sizeof(double));
+
+        for (r = 0; r < t; r++)
+            kernels()->axpy(v[r * t + c], v + r * t + c + 1, work, t - c - 1);
+
+        kernels()->axpy(- tau, work, a + c * t + c + 1, t - c - 1);
+
+        for (r = 0; r < t; r++)
+            kernels()->axpy(- tau * v[r * t + c], work, v + r * t + c + 1, t - c - 1);
+    }
+}
+
+// Applies the reflections kept in tile (i,k) to the pair of tiles 'b1' (row 'k')
+// and 'b2' (row 'i'), in the order given as in 'dag_apply_diag_la'.
+static void dag_apply_pair_la(DagGraph *g, int k, int i, double *b1, double *b2, int forward, double *work)
+{
+    register int r, s;
+    int c, t = g->t;
+    double tau, *v = DAG_TILE_OF(g, g->a, i, k), *taus = g->tau + ((size_t) i * g->nt + k) * t;
+
+    for (s = 0; s < t; s++)
+    {
+        c = forward ? s : t - 1 - s;
+
+        tau = taus[c];
+
+        if (tau == 0)
+            continue;
+
+        memcpy(work, b1 + c * t, t * sizeof(double));
+
+        for (r = 0; r < t; r++)
+            kernels()->axpy(v[r * t + c], b2 + r * t, work, t);
+
+        kernels()->axpy(- tau, work, b1 + c * t, t);
+
+        for (r = 0; r < t; r++)
+            kernels()->axpy(- tau * v[r * t + c], work, b2 + r * t, t);
+    }
+}
+
+static void dag_unmqr_la(DagGraph *g, int k, int i, int j, double *work)  // A(k,j) = transpose(Q(k,k)) * A(k,j)
+{
+    (void) i;
+
+    dag_apply_diag_la(g, k, DAG_TILE_OF(g, g->a, k, j), 1, work);
+}
+
+static void dag_tsmqr_la(DagGraph *g, int k, int i, int j, double *work)  // Applies the reflections of A(i,k) to A(k,j) and A(i,j).
+{
+    dag_apply_pair_la(g, k, i, DAG_TILE_OF(g, g->a, k, j), DAG_TILE_OF(g, g->a, i, j), 1, work);
+}
+
+static void dag_ungqr_la(DagGraph *g, int k, int i, int j, double *work)  // Q(k,j) = Q(k,k) * Q(k,j)
+{
+    (void) i;
+
+    dag_apply_diag_la(g, k, DAG_TILE_OF(g, g->q, k, j), 0, work);
+}
+
+static void dag_tsmq_la(DagGraph *g, int k, int i, int j, double *work)   // Applies the reflections of A(i,k) to Q(k,j) and Q(i,j), backwards.
+{
+    dag_apply_pair_la(g, k, i, DAG_TILE_OF(g, g->q, k, j), DAG_TILE_OF(g, g->q, i, j), 0, work);
+}
+
+static int dag_tile_order_la(Matrix *mat)       // Order of the tiles for a matrix.
+{
+    int n = (mat->row < mat->col) ? mat->row : mat->col;
+
+    return (tuning_la.dag_tile < n) ? tuning_la.dag_tile : n;
+}
+
+Matrix* dag_cholesky_decomposition(Matrix *mat)     // Calculates the Cholesky factor of a matrix with a graph of tile tasks.
+{
+    register int i, j, k;
+
+    DagGraph *g;
+    Matrix *l;
+
+    if (mat == NULL)
+    {
+        error_message_la(98, ERRMSS04);
+
+        return NULL;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(98, "incompatible dimensions for a Cholesky decomposition!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return NULL;
+    }
+
+    LA_STATS_START(98);
+
+    g = dag_create_la(98, mat, dag_tile_order_la(mat), 1, 0);
+
+    for (k = 0; k < g->nt; k++)
+    {
+        dag_task_la(98, g, dag_potrf_la, k, k, k, DAG_PANEL);
+        dag_access_la(98, g, DAG_RES_A(g, k, k), DAG_WRITE);
+
+        for (i = k + 1; i < g->nt; i++)
+        {
+            dag_task_la(98, g, dag_trsm_la, k, i, k, DAG_NEXT);
+            dag_access_la(98, g, DAG_RES_A(g, k, k), DAG_READ);
+            dag_access_la(98, g, DAG_RES_A(g, i, k), DAG_WRITE);
+        }
+
+        for (i = k + 1; i < g->nt; i++)
+        {
+            dag_task_la(98, g, dag_syrk_la, k, i, i, (i == k + 1) ? DAG_NEXT : DAG_UPDATE);
+            dag_access_la(98, g, DAG_RES_A(g, i, k), DAG_READ);
+            dag_access_la(98, g, DAG_RES_A(g, i, i), DAG_WRITE);
+
+            for (j = k + 1; j < i; j++)
+            {
+                dag_task_la(98, g, dag_gemm_nt_la, k, i, j, (j == k + 1) ? DAG_NEXT : DAG_UPDATE);
+                dag_access_la(98, g, DAG_RES_A(g, i, k), DAG_READ);
+                dag_access_la(98, g, DAG_RES_A(g, j, k), DAG_READ);
+                dag_access_la(98, g, DAG_RES_A(g, i, j), DAG_WRITE);
+            }
+        }
+    }
+
+    dag_run_la(98, g);
+
+    l = NULL;
+
+    if (!atomic_load(&g->failed))
+    {
+        l = create_matrix(mat->row, mat->col);
+
+        for (i = 0; i < mat->row; i++)
+        {
+            for (j = 0; j <= i; j++)
+                l->m[i][j] = DAG_TILE_OF(g, g->a, i / g->t, j / g->t)[(i % g->t) * g->t + j % g->t];
+        }
+    }
+
+    dag_free_la(g);
+
+    LA_STATS_STOP(98, (double) mat->row * mat->row * mat->row / 3);
+
+    return l;
+}
+
+int dag_lu_decomposition(Matrix *mat, int *perm)    // Calculates the LU decomposition of a matrix with a graph of tile tasks.
+{
+    register int i, j, k;
+    int sign = 1, n;
+
+    DagGraph *g;
+
+    if (mat == NULL)
+    {
+        error_message_la(99, ERRMSS04);
+
+        return 0;
+    }
+    else if (perm == NULL)
+    {
+        error_message_la(99, "NULL permutation informed!");
+
+        return 0;
+    }
+    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    {
+        error_message_la(99, "incompatible dimensions for a LU decomposition!");
+
+        printf("\nThe matrix must have the same number of rows and columns.\n");
+
+        return 0;
+    }
+
+    LA_STATS_START(99);
+
+    LA_CHANGED(mat);
+
+    g = dag_create_la(99, mat, dag_tile_order_la(mat), 1, 0);
+
+    for (k = 0; k < g->nt; k++)
+    {
+        dag_task_la(99, g, dag_panel_la, k, k, k, DAG_PANEL);
+
+        for (i = k; i < g->nt; i++)
+            dag_access_la(99, g, DAG_RES_A(g, i, k), DAG_WRITE);
+
+        dag_access_la(99, g, DAG_RES_PIV(g, k), DAG_WRITE);
+
+        for (j = 0; j < g->nt; j++)                 // The swaps of the panel reach all the columns.
+        {
+            if (j == k)
+                continue;
+
+            if (j < k)
+                dag_task_la(99, g, dag_laswp_la, k, k, j, DAG_UPDATE);
+            else
+                dag_task_la(99, g, dag_swptrsm_la, k, k, j, (j == k + 1) ? DAG_NEXT : DAG_UPDATE);
+
+            dag_access_la(99, g, DAG_RES_PIV(g, k), DAG_READ);
+
+            if (j > k)
+                dag_access_la(99, g, DAG_RES_A(g, k, k), DAG_READ);
+
+            for (i = k; i < g->nt; i++)
+                dag_access_la(99, g, DAG_RES_A(g, i, j), DAG_WRITE);
+        }
+
+        for (j = k + 1; j < g->nt; j++)
+        {
+            for (i = k + 1; i < g->nt; i++)
+            {
+                dag_task_la(99, g, dag_gemm_nn_la, k, i, j, (j == k + 1) ? DAG_NEXT : DAG_UPDATE);
+                dag_access_la(99, g, DAG_RES_A(g, i, k), DAG_READ);
+                dag_access_la(99, g, DAG_RES_A(g, k, j), DAG_READ);
+                dag_access_la(99, g, DAG_RES_A(g, i, j), DAG_WRITE);
+            }
+        }
+    }
+
+    dag_run_la(99, g);
+
+    if (atomic_load(&g->failed))
+    {
+        dag_free_la(g);
+
+        LA_STATS_STOP(99, 0);
+
+        return 0;
+    }
+
+    n = mat->row;
+
+    for (i = 0; i < n; i++)
+        perm[i] = i;
+
+    for (k = 0; k < n; k++)                         // The pivots of the columns of the matrix are in its rows.
+    {
+        if (g->ipiv[k] != k)
+        {
+            i = perm[k];
+
+            perm[k] = perm[g->ipiv[k]];
+
+            perm[g->ipiv[k]] = i;
+
+            sign = - sign;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            mat->m[i][j] = DAG_TILE_OF(g, g->a, i / g->t, j / g->t)[(i % g->t) * g->t + j % g->t];
+    }
+
+    dag_free_la(g);
+
+    LA_STATS_STOP(99, 2.0 * n * n * n / 3);
+
+    return sign;
+}
+
+void dag_qr_decomposition(Matrix *mat, Matrix **q, Matrix **r)    // Calculates the QR decomposition of a matrix with a graph of tile tasks.
+{
+    register int i, j, k;
+
+    DagGraph *g;
+
+    if (mat == NULL)
+    {
+        error_message_la(100, ERRMSS04);
+
+        return;
+    }
+    else if (mat->row < mat->col)                   // Tests the dimensions.
+    {
+        error_message_la(100, "incompatible dimensions for a QR decomposition!");
+
+        printf("\nThe matrix must have at least as many rows as columns.\n");
+
+        return;
+    }
+
+    LA_STATS_START(100);
+
+    g = dag_create_la(100, mat, dag_tile_order_la(mat), 0, 1);
+
+    for (k = 0; k < g->nt; k++)
+    {
+        dag_task_la(100, g, dag_geqrt_la, k, k, k, DAG_PANEL);
+        dag_access_la(100, g, DAG_RES_A(g, k, k), DAG_WRITE);
+
+        for (j = k + 1; j < g->nt; j++)
+        {
+            dag_task_la(100, g, dag_unmqr_la, k, k, j, (j == k + 1) ? DAG_NEXT : DAG_UPDATE);
+            dag_access_la(100, g, DAG_RES_A(g, k, k), DAG_READ);
+            dag_access_la(100, g, DAG_RES_A(g, k, j), DAG_WRITE);
+        }
+
+        for (i = k + 1; i < g->mt; i++)
+        {
+            dag_task_la(100, g, dag_tsqrt_la, k, i, k, DAG_PANEL);
+            dag_access_la(100, g, DAG_RES_A(g, k, k), DAG_WRITE);
+            dag_access_la(100, g, DAG_RES_A(g, i, k), DAG_WRITE);
+
+            for (j = k + 1; j < g->nt; j++)
+            {
+                dag_task_la(100, g, dag_tsmqr_la, k, i, j, (j == k + 1) ? DAG_NEXT : DAG_UPDATE);
+                dag_access_la(100, g, DAG_RES_A(g, i, k), DAG_READ);
+                dag_access_la(100, g, DAG_RES_A(g, k, j), DAG_WRITE);
+                dag_access_la(100, g, DAG_RES_A(g, i, j), DAG_WRITE);
+            }
+        }
+    }
+
+    if (q != NULL)                                  // Accumulates the reflections backwards over the first columns of the identity.
+    {
+        g->q = dag_alloc_la(100, (size_t) g->mt * g->nt * g->t * g->t * sizeof(double));
+
+        for (i = 0; i < g->nt * g->t; i++)
+            DAG_TILE_OF(g, g->q, i / g->t, i / g->t)[(i % g->t) * (g->t + 1)] = 1;
+
+        for (k = g->nt - 1; k >= 0; k--)
+        {
+            for (i = g->mt - 1; i > k; i--)
+            {
+                for (j = k; j < g->nt; j++)
+                {
+                    dag_task_la(100, g, dag_tsmq_la, k, i, j, DAG_UPDATE);
+                    dag_access_la(100, g, DAG_RES_A(g, i, k), DAG_READ);
+                    dag_access_la(100, g, DAG_RES_Q(g, k, j), DAG_WRITE);
+                    dag_access_la(100, g, DAG_RES_Q(g, i, j), DAG_WRITE);
+                }
+            }
+
+            for (j = k; j < g->nt; j++)
+            {
+                dag_task_la(100, g, dag_ungqr_la, k, k, j, DAG_UPDATE);
+                dag_access_la(100, g, DAG_RES_A(g, k, k), DAG_READ);
+                dag_access_la(100, g, DAG_RES_Q(g, k, j), DAG_WRITE);
+            }
+        }
+    }
+
+    dag_run_la(100, g);
+
+    if (q != NULL)
+    {
+        *q = create_matrix(mat->row, mat->col);
+
+        for (i = 0; i < mat->row; i++)
+        {
+            for (j = 0; j < mat->col; j++)
+                (*q)->m[i][j] = DAG_TILE_OF(g, g->q, i / g->t, j / g->t)[(i % g->t) * g->t + j % g->t];
+        }
+    }
+
+    if (r != NULL)
+    {
+        *r = create_matrix(mat->col, mat->col);
+
+        for (i = 0; i < mat->col; i++)
+        {
+            for (j = i; j < mat->col; j++)
+                (*r)->m[i][j] = DAG_TILE_OF(g, g->a, i / g->t, j / g->t)[(i % g->t) * g->t + j % g->t];
+        }
+    }
+
+    dag_free_la(g);
+
+    LA_STATS_STOP(100, 4.0 * mat->row * mat->col * mat->col);
+}
+
+// Updates of factorizations:
+//
+// Each update of rank 'k' costs O(k * n^2) operations, instead of the O(n^3)
+// of a new factorization. Those of rank 'k' are applied as 'k' updates of rank 1,
+// one for each column of the factors.
+
+static int update_check_la(int nmbr, Matrix *a, Matrix *b, Matrix *u, Matrix *v)   // Checks the arguments of an update.
+{
+    if (a == NULL || b == NULL || u == NULL || v == NULL)
+    {
+        error_message_la(nmbr, ERRMSS04);
+
+        return 0;
+    }
+    else if (a->row != a->col || b->row != a->row || b->col != a->col ||
+             u->row != a->row || v->row != a->row || v->col != u->col)
+    {
+        error_message_la(nmbr, "incompatible dimensions for the update!");
+
+        return 0;
+    }
+
+    return 1;
+}
+
+int over_inverse_update(Matrix *inv, Matrix *u, Matrix *v)  // Updates an inverse by the Sherman-Morrison-Woodbury formula.
+{
+    register int i, j, c;
+    int n, k, *perm;
+
+    Matrix *x, *y, *cap;
+
+    if (!update_check_la(101, inv, inv, u, v))
+        return 0;
+
+    LA_STATS_START(101);
+
+    LA_CHANGED(inv);
+
+    n = inv->row;
+
+    k = u->col;
+
+    x = create_matrix(n, k);                        // inv * u
+
+    y = create_matrix(k, n);                        // transpose(v) * inv
+
+    cap = create_identity_matrix(k);                // Capacitance matrix: I + transpose(v) * inv * u
+
+    perm = malloc(k * sizeof(int));
+
+    if (perm == NULL)
+    {
+        error_message_la(101, ERRMSS01);
+
+        exit(101);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            kernels()->axpy(inv->m[i][j], u->m[j], x->m[i], k);
+    }
+
+    for (j = 0; j < n; j++)
+    {
+        for (c = 0; c < k; c++)
+        {
+            kernels()->axpy(v->m[j][c], inv->m[j], y->m[c], n);
+
+            kernels()->axpy(v->m[j][c], x->m[j], cap->m[c], k);
+        }
+    }
+
+    if (lu_decomposition(cap, perm) == 0)          // The updated matrix is singular.
+    {
+        free_matrix(x);
+        free_matrix(y);
+        free_matrix(cap);
+        free(perm);
+
+        LA_STATS_STOP(101, 4.0 * n * n * k);
+
+        return 0;
+    }
+
+    apply_permutation_to_matrix(y, perm);          // y = inverse(cap) * y, by rows
+
+    for (i = 1; i < k; i++)
+    {
+        for (j = 0; j < i; j++)
+            kernels()->axpy(- cap->m[i][j], y->m[j], y->m[i], n);
+    }
+
+    for (i = k - 1; i >= 0; i--)
+    {
+        for (j = i + 1; j < k; j++)
+            kernels()->axpy(- cap->m[i][j], y->m[j], y->m[i], n);
+
+        kernels()->scale(1 / cap->m[i][i], y->m[i], y->m[i], n);
+    }
+
+    for (i = 0; i < n; i++)                         // inv = inv - x * y
+    {
+        for (c = 0; c < k; c++)
+            kernels()->axpy(- x->m[i][c], y->m[c], inv->m[i], n);
+    }
+
+    free_matrix(x);
+    free_matrix(y);
+    free_matrix(cap);
+    free(perm);
+
+    LA_STATS_STOP(101, 6.0 * n * n * k);
+
+    return 1;
+}
+
+int over_lu_update(Matrix *lu, int *perm, Matrix *u, Matrix *v)    // Updates a LU decomposition by Bennett's algorithm.
+{
+    register int i, j, c, l;
+    int n;
+    double d, dn, x1, y1, old, *x, *y;
+
+    if (!update_check_la(102, lu, lu, u, v))
+        return 0;
+    else if (perm == NULL || !valid_permutation_la(perm, lu->row))
+    {
+        error_message_la(102, "invalid permutation informed!");
+
+        return 0;
+    }
+
+    LA_STATS_START(102);
+
+    LA_CHANGED(lu);
+
+    n = lu->row;
+
+    x = malloc(2 * n * sizeof(double));
+
+    if (x == NULL)
+    {
+        error_message_la(102, ERRMSS01);
+
+        exit(102);
+    }
+
+    y = x + n;
+
+    for (c = 0; c < u->col; c++)
+    {
+        for (i = 0; i < n; i++)                     // The rows of 'u' follow the pivoting.
+        {
+            x[i] = u->m[perm[i]][c];
+
+            y[i] = v->m[i][c];
+        }
+
+        for (l = 0; l < n; l++)                     // L * U + x * y' is reduced to L2 * U2 + x2 * y2' at each step.
+        {
+            d = lu->m[l][l];
+
+            x1 = x[l];
+
+            y1 = y[l];
+
+            dn = d + x1 * y1;
+
+            if (dn == 0)                            // A pivot would be needed.
+            {
+                free(x);
+
+                LA_STATS_STOP(102, 4.0 * n * n * c);
+
+                return 0;
+            }
+
+            lu->m[l][l] = dn;
+
+            for (j = l + 1; j < n; j++)
+            {
+                old = lu->m[l][j];
+
+                lu->m[l][j] = old + x1 * y[j];
+
+                y[j] = (d * y[j] - y1 * old) / dn;
+            }
+
+            for (i = l + 1; i < n; i++)
+            {
+                old = lu->m[i][l];
+
+                lu->m[i][l] = (d * old + y1 * x[i]) / dn;
+
+                x[i] -= x1 * old;
+            }
+        }
+    }
+
+    free(x);
+
+    LA_STATS_STOP(102, 4.0 * n * n * u->col);
+
+    return 1;
+}
+
+static int cholesky_rank1_la(int nmbr, Matrix *l, Matrix *x, int down)     // Updates or downdates a Cholesky factor with each column of 'x'.
+{
+    register int i, k, c;
+    int n = l->row;
+    double r, cs, sn, *w;
+
+    w = malloc(n * sizeof(double));
+
+    if (w == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    for (c = 0; c < x->col; c++)
+    {
+        for (i = 0; i < n; i++)
+            w[i] = x->m[i][c];
+
+        for (k = 0; k < n; k++)                     // Rotations that join 'w' to the columns of 'L'
+        {
+            r = down ? (l->m[k][k] - w[k]) * (l->m[k][k] + w[k]) : l->m[k][k] * l->m[k][k] + w[k] * w[k];
+
+            if (r <= 0)                             // Not positive definite
+            {
+                free(w);
+
+                return 0;
+            }
+
+            r = sqrt(r);
+
+            cs = r / l->m[k][k];
+
+            sn = w[k] / l->m[k][k];
+
+            l->m[k][k] = r;
+
+            for (i = k + 1; i < n; i++)
+            {
+                l->m[i][k] = down ? (l->m[i][k] - sn * w[i]) / cs : (l->m[i][k] + sn * w[i]) / cs;
+
+                w[i] = cs * w[i] - sn * l->m[i][k];
+            }
+        }
+    }
+
+    free(w);
+
+    return 1;
+}
+
+int over_cholesky_update(Matrix *l, Matrix *x)      // Updates a Cholesky factor for the sum of 'x * transpose(x)'.
+{
+    int res;
+
+    if (!update_check_la(103, l, l, x, x))
+        return 0;
+
+    LA_STATS_START(103);
+
+    LA_CHANGED(l);
+
+    res = cholesky_rank1_la(103, l, x, 0);
+
+    LA_STATS_STOP(103, 4.0 * l->row * l->row * x->col);
+
+    return res;
+}
+
+int over_cholesky_downdate(Matrix *l, Matrix *x)    // Updates a Cholesky factor for the subtraction of 'x * transpose(x)'.
+{
+    int res;
+
+    if (!update_check_la(104, l, l, x, x))
+        return 0;
+
+    LA_STATS_START(104);
+
+    LA_CHANGED(l);
+
+    res = cholesky_rank1_la(104, l, x, 1);
+
+    LA_STATS_STOP(104, 4.0 * l->row * l->row * x->col);
+
+    return res;
+}
+
+static void givens_la(double a, double b, double *c, double *s)    // Rotation that takes (a, b) to (r, 0).
+{
+    double r = hypot(a, b);
+
+    if (r == 0)
+    {
+        *c = 1;
+
+        *s = 0;
+    }
+    else
+    {
+        *c = a / r;
+
+        *s = b / r;
+    }
+}
+
+static void rotate_rows_la(Matrix *r, int i, int from, double c, double s)     // Applies a rotation to rows 'i' and 'i + 1'.
+{
+    register int j;
+    double a, b;
+
+    for (j = from; j < r->col; j++)
+    {
+        a = r->m[i][j];
+
+        b = r->m[i + 1][j];
+
+        r->m[i][j] = c * a + s * b;
+
+        r->m[i + 1][j] = c * b - s * a;
+    }
+}
+
+static void rotate_columns_la(Matrix *q, int i, double c, double s)    // Applies a rotation to columns 'i' and 'i + 1'.
+{
+    register int j;
+    double a, b;
+
+    for (j = 0; j < q->row; j++)
+    {
+        a = q->m[j][i];
+
+        b = q->m[j][i + 1];
+
+        q->m[j][i] = c * a + s * b;
+
+        q->m[j][i + 1] = c * b - s * a;
+    }
+}
+
+int over_qr_update(Matrix *q, Matrix *r, Matrix *u, Matrix *v)     // Updates a QR decomposition by Givens rotations.
+{
+    register int i, j, c;
+    int n;
+    double cs, sn, *w;
+
+    if (!update_check_la(105, q, r, u, v))
+        return 0;
+
+    LA_STATS_START(105);
+
+    LA_CHANGED(q);
+
+    LA_CHANGED(r);
+
+    n = q->row;
+
+    w = malloc(n * sizeof(double));
+
+    if (w == NULL)
+    {
+        error_message_la(105, ERRMSS01);
+
+        exit(105);
+    }
+
+    for (c = 0; c < u->col; c++)
+    {
+        for (i = 0; i < n; i++)                     // w = transpose(Q) * u
+            w[i] = 0;
+
+        for (j = 0; j < n; j++)
+            kernels()->axpy(u->m[j][c], q->m[j], w, n);
+
+        for (i = n - 2; i >= 0; i--)                // Reduces 'w' to its first element; 'R' becomes upper Hessenberg.
+        {
+            givens_la(w[i], w[i + 1], &cs, &sn);
+
+            w[i] = cs * w[i] + sn * w[i + 1];
+
+            rotate_rows_la(r, i, i, cs, sn);
+
+            rotate_columns_la(q, i, cs, sn);
+        }
+
+        for (j = 0; j < n; j++)
+            r->m[0][j] += w[0] * v->m[j][c];
+
+        for (i = 0; i < n - 1; i++)                 // Makes 'R' triangular again.
+        {
+            givens_la(r->m[i][i], r->m[i + 1][i], &cs, &sn);
+
+            rotate_rows_la(r, i, i, cs, sn);
+
+            r->m[i + 1][i] = 0;
+
+            rotate_columns_la(q, i, cs, sn);
+        }
+    }
+
+    free(w);
+
+    LA_STATS_STOP(105, 12.0 * n * n * u->col);
+
+    return 1;
+}
+
+// Factorization cache:
+
+void linalg_factor_cache(long long budget)  // Enables the factorization cache with a limit of memory, or disables it.
+{
+    LA_STATS_COUNT(106);
+
+    pthread_mutex_lock(&cache_lock_la);
+
+    atomic_store(&cache_budget_la, (budget > 0) ? budget : 0);
+
+    cache_trim_la(0);
+
+    pthread_mutex_unlock(&cache_lock_la);
+}
+
+void factor_cache_stats(FactorCacheStats *stats)    // Gives the counters of the factorization cache.
+{
+    if (stats == NULL)
+    {
+        error_message_la(107, "NULL statistics informed!");
+
+        return;
+    }
+
+    LA_STATS_COUNT(107);
+
+    pthread_mutex_lock(&cache_lock_la);
+
+    stats->hits = cache_hits_la;
+
+    stats->misses = cache_misses_la;
+
+    stats->evictions = cache_evictions_la;
+
+    stats->entries = cache_entries_la;
+
+    stats->bytes = cache_bytes_la;
+
+    stats->budget = atomic_load(&cache_budget_la);
+
+    pthread_mutex_unlock(&cache_lock_la);
+}
+
+void factor_cache_clear(void)           // Removes the decompositions of the factorization cache and clears its counters.
+{
+    FactorEntry *e;
+
+    LA_STATS_COUNT(108);
+
+    pthread_mutex_lock(&cache_lock_la);
+
+    while (cache_first_la != NULL)
+    {
+        e = cache_first_la;
+
+        cache_unlink_la(e);
+
+        cache_free_entry_la(e);
+    }
+
+    cache_hits_la = cache_misses_la = cache_evictions_la = 0;
+
+    pthread_mutex_unlock(&cache_lock_la);
+}
+
+// Streaming input and output:
+//
+// Text files have the format of 'get_matrix': the dimensions as "MxN" and the
+// elements by rows, written with 17 significant digits so that they are read back
+// exactly. Binary files have a header with the magic "LINALGRB" and the
+// dimensions as two 'int', followed by the rows of doubles in the byte order of
+// the machine. The first byte tells the formats apart when reading.
+
+#define STREAM_MAGIC "LINALGRB"
+#define STREAM_BUFFER 65536                                     // Bytes of text kept by a writer before writing them
+
+struct matrix_reader
+{
+	FILE *file;
+
+	int row;
+
+	int col;
+
+	int binary;
+
+	int next;                                                   // Next row to be read
+
+	long start;                                                 // Position of the first row, or '-1' if the file cannot be repositioned
+};
+
+struct matrix_writer
+{
+	FILE *file;
+
+	int row;
+
+	int col;
+
+	int binary;
+
+	int written;                                                // Rows written
+
+	int failed;
+
+	size_t len;                                                 // Bytes in 'buf'
+
+	char buf[STREAM_BUFFER];
+};
+
+static int reader_row_la(MatrixReader *rd, double *row)       // Reads the next row; returns '0' if it fails.
+{
+    register int j;
+
+    if (rd->binary)
+        return fread(row, sizeof(double), rd->col, rd->file) == (size_t) rd->col;
+
+    for (j = 0; j < rd->col; j++)
+    {
+        if (fscanf(rd->file, " %lf", &row[j]) != 1)
+            return 0;
+    }
+
+    return 1;
+}
+
+MatrixReader* open_matrix_reader(FILE *filin)       // Starts reading a matrix, in text or binary, from a file.
+{
+    char magic[8];
+    int c, dims[2];
+
+    MatrixReader *rd;
+
+    if (filin == NULL)
+    {
+        error_message_la(131, "NULL file informed!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(131);
+
+    c = getc(filin);
+
+    if (c == STREAM_MAGIC[0])                       // Binary
+    {
+        magic[0] = c;
+
+        if (fread(magic + 1, 1, 7, filin) != 7 || memcmp(magic, STREAM_MAGIC, 8) != 0 || fread(dims, sizeof(int), 2, filin) != 2)
+            dims[0] = 0;
+    }
+    else
+    {
+        if (c == EOF || ungetc(c, filin) == EOF || fscanf(filin, "%dx%d", &dims[0], &dims[1]) != 2)
+            dims[0] = 0;
+    }
+
+    if (dims[0] <= 0 || dims[1] <= 0)
+    {
+        error_message_la(131, "the file does not hold a matrix!");
+
+        LA_STATS_STOP(131, 0);
+
+        return NULL;
+    }
+
+    rd = malloc(sizeof(MatrixReader));
+
+    if (rd == NULL)
+    {
+        error_message_la(131, ERRMSS01);
+
+        exit(131);
+    }
+
+    rd->file = filin;
+
+    rd->row = dims[0];
+
+    rd->col = dims[1];
+
+    rd->binary = (c == STREAM_MAGIC[0]);
+
+    rd->next = 0;
+
+    rd->start = ftell(filin);
+
+    LA_STATS_STOP(131, 0);
+
+    return rd;
+}
+
+int matrix_reader_row_number(MatrixReader *rd)     // Gives the number of rows of the matrix being read.
+{
+    if (rd == NULL)
+        return 0;
+
+    LA_STATS_COUNT(132);
+
+    return rd->row;
+}
+
+int matrix_reader_column_number(MatrixReader *rd)  // Gives the number of columns of the matrix being read.
+{
+    if (rd == NULL)
+        return 0;
+
+    LA_STATS_COUNT(133);
+
+    return rd->col;
+}
+
+int read_matrix_rows(MatrixReader *rd, Matrix *block)  // Reads the next rows of a matrix into a block.
+{
+    register int i;
+    int rows;
+
+    if (rd == NULL)
+    {
+        error_message_la(134, "NULL reader informed!");
+
+        return -1;
+    }
+    else if (block == NULL)
+    {
+        error_message_la(134, ERRMSS04);
+
+        return -1;
+    }
+    else if (block->col != rd->col)
+    {
+        error_message_la(134, "the block must have the columns of the matrix!");
+
+        return -1;
+    }
+
+    LA_STATS_START(134);
+
+    rows = rd->row - rd->next;
+
+    if (rows > block->row)
+        rows = block->row;
+
+    for (i = 0; i < rows; i++)
+    {
+        if (!reader_row_la(rd, block->m[i]))
+        {
+            error_message_la(134, "error reading the file!");
+
+            LA_STATS_STOP(134, 0);
+
+            return -1;
+        }
+
+        rd->next++;
+    }
+
+    if (rows > 0)
+        LA_CHANGED(block);
+
+    LA_STATS_STOP(134, 0);
+
+    return rows;
+}
+
+int stream_matrix(MatrixReader *rd, int block_rows, RowBlockVisitor visit, void *data)     // Reads the rest of a matrix by blocks of rows.
+{
+    int rows;
+
+    Matrix *block;
+
+    if (rd == NULL || visit == NULL)
+    {
+        error_message_la(135, "NULL reader or function informed!");
+
+        return 0;
+    }
+    else if (block_rows <= 0)
+    {
+        error_message_la(135, "invalid number of rows for the blocks!");
+
+        return 0;
+    }
+
+    LA_STATS_START(135);
+
+    block = create_matrix_uninitialized((block_rows < rd->row) ? block_rows : rd->row, rd->col);
+
+    while ((rows = read_matrix_rows(rd, block)) > 0)
+    {
+        if (visit(block, rd->next - rows, rows, data) != 0)
+            break;
+    }
+
+    free_matrix(block);
+
+    LA_STATS_STOP(135, 0);
+
+    return rows == 0;
+}
+
+int matrix_reader_block(Matrix *block, int first, int rows, void *data)    // Reads rows of a matrix, as a 'RowBlockReader'.
+{
+    MatrixReader *rd = data;
+    Matrix part;
+
+    if (rd == NULL || block == NULL || first < 0 || rows <= 0 || rows > block->row || first + rows > rd->row)
+    {
+        error_message_la(136, "invalid rows or reader informed!");
+
+        return 1;
+    }
+
+    LA_STATS_START(136);
+
+    if (first < rd->next)                           // Starts again from the first row.
+    {
+        if (rd->start < 0 || fseek(rd->file, rd->start, SEEK_SET) != 0)
+        {
+            error_message_la(136, "the file cannot be read again!");
+
+            LA_STATS_STOP(136, 0);
+
+            return 1;
+        }
+
+        rd->next = 0;
+    }
+
+    while (rd->next < first)                        // Skips the rows before 'first'.
+    {
+        if (!reader_row_la(rd, block->m[0]))
+        {
+            error_message_la(136, "error reading the file!");
+
+            LA_STATS_STOP(136, 0);
+
+            return 1;
+        }
+
+        rd->next++;
+    }
+
+    part = row_block_view(block, 0, rows);
+
+    LA_CHANGED(block);
+
+    LA_STATS_STOP(136, 0);
+
+    return read_matrix_rows(rd, &part) != rows;
+}
+
+void free_matrix_reader(MatrixReader *rd)           // Deallocates memory previously used for a reader.
+{
+    free(rd);
+}
+
+static int writer_flush_la(MatrixWriter *wr)        // Writes the text kept by a writer.
+{
+    if (wr->len > 0 && fwrite(wr->buf, 1, wr->len, wr->file) != wr->len)
+        wr->failed = 1;
+
+    wr->len = 0;
+
+    return !wr->failed;
+}
+
+MatrixWriter* open_matrix_writer(FILE *filout, int m, int n, int binary)   // Starts writing a matrix, in text or binary, to a file.
+{
+    int dims[2];
+
+    MatrixWriter *wr;
+
+    if (filout == NULL)
+    {
+        error_message_la(138, "NULL file informed!");
+
+        return NULL;
+    }
+    else if (m <= 0 || n <= 0)
+    {
+        error_message_la(138, "incompatible dimensions for a matrix!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(138);
+
+    wr = malloc(sizeof(MatrixWriter));
+
+    if (wr == NULL)
+    {
+        error_message_la(138, ERRMSS01);
+
+        exit(138);
+    }
+
+    wr->file = filout;
+
+    wr->row = m;
+
+    wr->col = n;
+
+    wr->binary = (binary != 0);
+
+    wr->written = 0;
+
+    wr->failed = 0;
+
+    wr->len = 0;
+
+    if (wr->binary)
+    {
+        dims[0] = m;
+
+        dims[1] = n;
+
+        if (fwrite(STREAM_MAGIC, 1, 8, filout) != 8 || fwrite(dims, sizeof(int), 2, filout) != 2)
+            wr->failed = 1;
+    }
+    else
+        wr->len = sprintf(wr->buf, "%dx%d\n", m, n);
+
+    LA_STATS_STOP(138, 0);
+
+    return wr;
+}
+
+int write_matrix_rows(MatrixWriter *wr, Matrix *block, int rows)   // Writes the first rows of a block as the next rows of a matrix.
+{
+    register int i, j;
+
+    if (wr == NULL)
+    {
+        error_message_la(139, "NULL writer informed!");
+
+        return 0;
+    }
+    else if (block == NULL)
+    {
+        error_message_la(139, ERRMSS04);
+
+        return 0;
+    }
+    else if (block->col != wr->col || rows < 0 || rows > block->row || wr->written + rows > wr->row)
+    {
+        error_message_la(139, "the rows do not fit in the matrix!");
+
+        return 0;
+    }
+
+    LA_STATS_START(139);
+
+    for (i = 0; i < rows && !wr->failed; i++)
+    {
+        if (wr->binary)
+        {
+            if (fwrite(block->m[i], sizeof(double), wr->col, wr->file) != (size_t) wr->col)
+                wr->failed = 1;
+
+            continue;
+        }
+
+        for (j = 0; j < wr->col; j++)
+        {
+            if (STREAM_BUFFER - wr->len < 32)       // Room for one element
+                writer_flush_la(wr);
+
+            wr->len += sprintf(wr->buf + wr->len, (j < wr->col - 1) ? "%.17g\t" : "%.17g\n", block->m[i][j]);
+        }
+    }
+
+    wr->written += rows;
+
+    LA_STATS_STOP(139, 0);
+
+    return !wr->failed;
+}
+
+int free_matrix_writer(MatrixWriter *wr)            // Finishes writing a matrix and deallocates the writer.
+{
+    int ok;
+
+    if (wr == NULL)
+        return 0;
+
+    LA_STATS_START(140);
+
+    ok = writer_flush_la(wr) && fflush(wr->file) == 0;
+
+    if (wr->written != wr->row)
+    {
+        error_message_la(140, "the matrix was not written entirely!");
+
+        ok = 0;
+    }
+    else if (!ok)
+        error_message_la(140, "error writing the file!");
+
+    free(wr);
+
+    LA_STATS_STOP(140, 0);
+
+    return ok;
+}
+
+int save_matrix(Matrix *mat, char *name, int binary)   // Saves a matrix in a file, in text or binary.
+{
+    int ok;
+
+    FILE *filout;
+    MatrixWriter *wr;
+
+    if (mat == NULL)
+    {
+        error_message_la(141, ERRMSS04);
+
+        return 0;
+    }
+    else if (name == NULL)
+    {
+        error_message_la(141, "NULL file name informed!");
+
+        return 0;
+    }
+
+    LA_STATS_START(141);
+
+    filout = fopen(name, binary ? "wb" : "w");
+
+    if (filout == NULL)
+    {
+        error_message_la(141, ERRMSS03);
+
+        LA_STATS_STOP(141, 0);
+
+        return 0;
+    }
+
+    wr = open_matrix_writer(filout, mat->row, mat->col, binary);
+
+    write_matrix_rows(wr, mat, mat->row);
+
+    ok = free_matrix_writer(wr);
+
+    if (fclose(filout) != 0)
+        ok = 0;
+
+    LA_STATS_STOP(141, 0);
+
+    return ok;
+}
+
+// Compressed matrices:
+//
+// The file has a header, the chunks of 'chunk_rows' rows one after the other, and
+// an index with the position, size and codec of each chunk. The bytes of the
+// doubles of a chunk are shuffled (all first bytes, then all second bytes, ...),
+// which groups the signs and exponents, and then compressed with zlib ('deflate');
+// a chunk that does not get smaller is kept only shuffled. The chunks are
+// compressed and decompressed in parallel, in batches, so memory use is bounded.
+
+#define COMPRESSED_HEADER 32                                    // Magic, 4 'int' and the position of the index
+#define COMPRESSED_BATCH 4                                      // Chunks of each batch, per thread
+#define CODEC_SHUFFLE 0
+#define CODEC_DEFLATE 1
+
+struct compressed_matrix
+{
+	int fd;
+
+	int row;
+
+	int col;
+
+	int chunk_rows;
+
+	int nchunks;
+
+	long long *index;                                           // Position, size and codec of each chunk
+
+	int cached;                                                 // Chunk in 'cache', or '-1'
+
+	double *cache;                                              // Rows of that chunk, contiguous
+
+	unsigned char *packed;                                      // Buffer for a chunk read from the file
+};
+
+static void shuffle_la(unsigned char *out, double *in, size_t count)   // Groups the bytes of each position of the doubles.
+{
+    register size_t k, b;
+    unsigned char *bytes = (unsigned char*) in;
+
+    for (b = 0; b < sizeof(double); b++)
+    {
+        for (k = 0; k < count; k++)
+            out[b * count + k] = bytes[k * sizeof(double) + b];
+    }
+}
+
+static void unshuffle_la(double *out, unsigned char *in, size_t count)
+{
+    register size_t k, b;
+    unsigned char *bytes = (unsigned char*) out;
+
+    for (b = 0; b < sizeof(double); b++)
+    {
+        for (k = 0; k < count; k++)
+            bytes[k * sizeof(double) + b] = in[b * count + k];
+    }
+}
+
+static size_t compress_bound_la(size_t raw)         // Largest size of a compressed chunk
+{
+#ifdef LINALG_ZLIB
+    return compressBound(raw);
+#else
+    return raw;
+#endif
+}
+
+// Shuffles and compresses 'count' doubles into 'out', with room for
+// 'compress_bound_la'; 'work' has room for the shuffled bytes. Gives the size
+// and sets the codec.
+static size_t pack_chunk_la(double *in, size_t count, int level, unsigned char *work, unsigned char *out, int *codec)
+{
+    size_t raw = count * sizeof(double);
+
+    shuffle_la(work, in, count);
+
+#ifdef LINALG_ZLIB
+    if (level > 0)
+    {
+        uLongf size = compressBound(raw);
+
+        if (compress2(out, &size, work, raw, level) == Z_OK && size < raw)
+        {
+            *codec = CODEC_DEFLATE;
+
+            return size;
+        }
+    }
+#else
+    (void) level;
+#endif
+
+    memcpy(out, work, raw);
+
+    *codec = CODEC_SHUFFLE;
+
+    return raw;
+}
+
+// Decompresses a chunk of 'count' doubles into 'out'; 'work' has room for the
+// shuffled bytes. Returns '0' if the chunk is invalid.
+static int unpack_chunk_la(unsigned char *in, size_t size, int codec, size_t count, unsigned char *work, double *out)
+{
+    size_t raw = count * sizeof(double);
+
+    if (codec == CODEC_SHUFFLE)
+    {
+        if (size != raw)
+            return 0;
+
+        unshuffle_la(out, in, count);
+
+        return 1;
+    }
+
+#ifdef LINALG_ZLIB
+    if (codec == CODEC_DEFLATE)
+    {
+        uLongf len = raw;
+
+        if (uncompress(work, &len, in, size) != Z_OK || len != raw)
+            return 0;
+
+        unshuffle_la(out, work, count);
+
+        return 1;
+    }
+#else
+    (void) work;
+#endif
+
+    return 0;
+}
+
+static int write_all_la(int fd, void *buf, size_t size, long long offset)  // 'pwrite' of the whole buffer
+{
+    size_t done = 0;
+    ssize_t res;
+
+    while (done < size)
+    {
+        res = pwrite(fd, (char*) buf + done, size - done, offset + done);
+
+        if (res <= 0)
+            return 0;
+
+        done += res;
+    }
+
+    return 1;
+}
+
+static int read_all_la(int fd, void *buf, size_t size, long long offset)   // 'pread' of the whole buffer
+{
+    size_t done = 0;
+    ssize_t res;
+
+    while (done < size)
+    {
+        res = pread(fd, (char*) buf + done, size - done, offset + done);
+
+        if (res <= 0)
+            return 0;
+
+        done += res;
+    }
+
+    return 1;
+}
+
+// Writes a compressed matrix with the rows of 'mat' or, if it is NULL, those read
+// by 'rd'. Returns '1' on success.
+static int compressed_save_la(int nmbr, Matrix *mat, MatrixReader *rd, char *name, int chunk_rows, int level)
+{
+    register int c, i;
+    int m, n, nchunks, batch, first, rows, ok = 1, header[4];
+    long long pos = COMPRESSED_HEADER, *index;
+    size_t bound;
+    char head[COMPRESSED_HEADER] = COMPRESSED_MAGIC;
+    int fd;
+
+    Matrix *block = NULL, view;
+    unsigned char *work, *out;
+    size_t *sizes;
+    int *codecs;
+
+    m = (mat != NULL) ? mat->row : matrix_reader_row_number(rd);
+
+    n = (mat != NULL) ? mat->col : matrix_reader_column_number(rd);
+
+    if (chunk_rows > m)
+        chunk_rows = m;
+
+    nchunks = (m + chunk_rows - 1) / chunk_rows;
+
+    batch = COMPRESSED_BATCH * ((sysconf(_SC_NPROCESSORS_ONLN) > 1) ? sysconf(_SC_NPROCESSORS_ONLN) : 1);
+
+    if (batch > nchunks)
+        batch = nchunks;
+
+    fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+    {
+        error_message_la(nmbr, ERRMSS03);
+
+        return 0;
+    }
+
+    bound = compress_bound_la((size_t) chunk_rows * n * sizeof(double));
+
+    index = malloc(3 * nchunks * sizeof(long long));
+
+    work = malloc(batch * (size_t) chunk_rows * n * sizeof(double));
+
+    out = malloc(batch * bound);
+
+    sizes = malloc(batch * sizeof(size_t));
+
+    codecs = malloc(batch * sizeof(int));
+
+    if (index == NULL || work == NULL || out == NULL || sizes == NULL || codecs == NULL)
+    {
+        error_message_la(nmbr, ERRMSS01);
+
+        exit(nmbr);
+    }
+
+    if (mat == NULL)
+        block = create_matrix_uninitialized(batch * chunk_rows, n);
+
+    for (first = 0; first < nchunks && ok; first += batch)     // Each batch is read, compressed in parallel and written in order.
+    {
+        int count = (first + batch <= nchunks) ? batch : nchunks - first;
+        int batch_rows = ((first + count) * chunk_rows < m ? (first + count) * chunk_rows : m) - first * chunk_rows;
+
+        if (mat != NULL)
+            view = row_block_view(mat, first * chunk_rows, batch_rows);
+        else if (read_matrix_rows(rd, block) != batch_rows)
+        {
+            error_message_la(nmbr, "error reading the file!");
+
+            ok = 0;
+
+            break;
+        }
+        else
+            view = row_block_view(block, 0, batch_rows);
+
+        #pragma omp parallel for private(i, rows) schedule(dynamic, 1) if (count > 1)
+        for (c = 0; c < count; c++)
+        {
+            double *rowbuf = malloc((size_t) chunk_rows * n * sizeof(double));
+
+            rows = (c + 1) * chunk_rows <= batch_rows ? chunk_rows : batch_rows - c * chunk_rows;
+
+            if (rowbuf == NULL)
+            {
+                error_message_la(nmbr, ERRMSS01);
+
+                exit(nmbr);
+            }
+
+            for (i = 0; i < rows; i++)                  // The rows of a matrix are not contiguous with each other.
+                memcpy(rowbuf + (size_t) i * n, view.m[c * chunk_rows + i], n * sizeof(double));
+
+            sizes[c] = pack_chunk_la(rowbuf, (size_t) rows * n, level, work + (size_t) c * chunk_rows * n * sizeof(double),
+                                     out + c * bound, &codecs[c]);
+
+            free(rowbuf);
+        }
+
+        for (c = 0; c < count && ok; c++)
+        {
+            ok = write_all_la(fd, out + c * bound, sizes[c], pos);
+
+            index[3 * (first + c)] = pos;
+
+            index[3 * (first + c) + 1] = sizes[c];
+
+            index[3 * (first + c) + 2] = codecs[c];
+
+            pos += sizes[c];
+        }
+    }
+
+    header[0] = m;
+
+    header[1] = n;
+
+    header[2] = chunk_rows;
+
+    header[3] = nchunks;
+
+    memcpy(head + 8, header, sizeof(header));
+
+    memcpy(head + 24, &pos, sizeof(pos));                       // Position of the index
+
+    if (ok)
+        ok = write_all_la(fd, index, 3 * nchunks * sizeof(long long), pos) && write_all_la(fd, head, COMPRESSED_HEADER, 0);
+
+    if (close(fd) != 0)
+        ok = 0;
+
+    if (!ok)
+        error_message_la(nmbr, "error writing the file!");
+
+    free_matrix(block);
+
+    free(index);
+
+    free(work);
+
+    free(out);
+
+    free(sizes);
+
+    free(codecs);
+
+    return ok;
+}
+
+int save_compressed_matrix(Matrix *mat, char *name, int chunk_rows, int level)    // Saves a matrix in a compressed file.
+{
+    int ok;
+
+    if (mat == NULL)
+    {
+        error_message_la(142, ERRMSS04);
+
+        return 0;
+    }
+    else if (name == NULL)
+    {
+        error_message_la(142, "NULL file name informed!");
+
+        return 0;
+    }
+    else if (chunk_rows <= 0 || level < 0 || level > 9)
+    {
+        error_message_la(142, "invalid size of chunks or level of compression!");
+
+        return 0;
+    }
+
+    LA_STATS_START(142);
+
+    ok = compressed_save_la(142, mat, NULL, name, chunk_rows, level);
+
+    LA_STATS_STOP(142, 0);
+
+    return ok;
+}
+
+int compress_matrix_file(char *src, char *dst, int chunk_rows, int level)     // Converts a matrix file into a compressed one.
+{
+    int ok;
+
+    FILE *filin;
+    MatrixReader *rd;
+
+    if (src == NULL || dst == NULL)
+    {
+        error_message_la(143, "NULL file name informed!");
+
+        return 0;
+    }
+    else if (chunk_rows <= 0 || level < 0 || level > 9)
+    {
+        error_message_la(143, "invalid size of chunks or level of compression!");
+
+        return 0;
+    }
+
+    LA_STATS_START(143);
+
+    filin = fopen(src, "r");
+
+    if (filin == NULL)
+    {
+        error_message_la(143, ERRMSS03);
+
+        LA_STATS_STOP(143, 0);
+
+        return 0;
+    }
+
+    rd = open_matrix_reader(filin);
+
+    ok = (rd != NULL) && compressed_save_la(143, NULL, rd, dst, chunk_rows, level);
+
+    free_matrix_reader(rd);
+
+    fclose(filin);
+
+    LA_STATS_STOP(143, 0);
+
+    return ok;
+}
+
+CompressedMatrix* open_compressed_matrix(char *name)    // Opens a compressed matrix for reading its rows.
+{
+    char head[COMPRESSED_HEADER];
+    int fd, header[4];
+    long long pos;
+
+    CompressedMatrix *cm;
+
+    if (name == NULL)
+    {
+        error_message_la(144, "NULL file name informed!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(144);
+
+    fd = open(name, O_RDONLY);
+
+    if (fd < 0)
+    {
+        error_message_la(144, ERRMSS03);
+
+        LA_STATS_STOP(144, 0);
+
+        return NULL;
+    }
+
+    if (!read_all_la(fd, head, COMPRESSED_HEADER, 0) || memcmp(head, COMPRESSED_MAGIC, 8) != 0)
+        header[0] = 0;
+    else
+    {
+        memcpy(header, head + 8, sizeof(header));
+
+        memcpy(&pos, head + 24, sizeof(pos));
+    }
+
+    if (header[0] <= 0 || header[1] <= 0 || header[2] <= 0 || header[3] != (header[0] + header[2] - 1) / header[2])
+    {
+        error_message_la(144, "the file does not hold a compressed matrix!");
+
+        close(fd);
+
+        LA_STATS_STOP(144, 0);
+
+        return NULL;
+    }
+
+    cm = malloc(sizeof(CompressedMatrix));
+
+    if (cm == NULL)
+    {
+        error_message_la(144, ERRMSS01);
+
+        exit(144);
+    }
+
+    cm->fd = fd;
+
+    cm->row = header[0];
+
+    cm->col = header[1];
+
+    cm->chunk_rows = header[2];
+
+    cm->nchunks = header[3];
+
+    cm->cached = -1;
+
+    cm->index = malloc(3 * cm->nchunks * sizeof(long long));
+
+    cm->cache = malloc((size_t) cm->chunk_rows * cm->col * sizeof(double));
+
+    cm->packed = malloc(compress_bound_la((size_t) cm->chunk_rows * cm->col * sizeof(double)));
+
+    if (cm->index == NULL || cm->cache == NULL || cm->packed == NULL)
+    {
+        error_message_la(144, ERRMSS01);
+
+        exit(144);
+    }
+
+    if (!read_all_la(fd, cm->index, 3 * cm->nchunks * sizeof(long long), pos))
+    {
+        error_message_la(144, "the file does not hold a compressed matrix!");
+
+        free_compressed_matrix(cm);
+
+        LA_STATS_STOP(144, 0);
+
+        return NULL;
+    }
+
+    LA_STATS_STOP(144, 0);
+
+    return cm;
+}
+
+// Reads and decompresses a chunk into 'rows', with the buffers given.
+// Returns '0' if it fails.
+static int compressed_chunk_la(CompressedMatrix *cm, int c, unsigned char *packed, unsigned char *work, double *rows)
+{
+    long long size = cm->index[3 * c + 1];
+    int nrows = (c < cm->nchunks - 1) ? cm->chunk_rows : cm->row - c * cm->chunk_rows;
+
+    if (size < 0 || (size_t) size > compress_bound_la((size_t) cm->chunk_rows * cm->col * sizeof(double)))
+        return 0;
+
+    return read_all_la(cm->fd, packed, size, cm->index[3 * c]) &&
+           unpack_chunk_la(packed, size, (int) cm->index[3 * c + 2], (size_t) nrows * cm->col, work, rows);
+}
+
+Matrix* get_compressed_matrix(char *name)           // Loads a compressed matrix in memory.
+{
+    register int c, i;
+    int nrows;
+    atomic_int ok = 1;
+    size_t raw, bound;
+
+    CompressedMatrix *cm;
+    Matrix *mat;
+
+    LA_STATS_START(145);
+
+    cm = open_compressed_matrix(name);
+
+    if (cm == NULL)
+    {
+        LA_STATS_STOP(145, 0);
+
+        return NULL;
+    }
+
+    mat = create_matrix_uninitialized(cm->row, cm->col);
+
+    raw = (size_t) cm->chunk_rows * cm->col * sizeof(double);
+
+    bound = compress_bound_la(raw);
+
+    #pragma omp parallel private(c, i, nrows) if (cm->nchunks > 1)
+    {
+        unsigned char *packed = malloc(bound), *work = malloc(raw);
+        double *rows = malloc(raw);
+
+        if (packed == NULL || work == NULL || rows == NULL)
+        {
+            error_message_la(145, ERRMSS01);
+
+            exit(145);
+        }
+
+        #pragma omp for schedule(dynamic, 1)
+        for (c = 0; c < cm->nchunks; c++)
+        {
+            nrows = (c < cm->nchunks - 1) ? cm->chunk_rows : cm->row - c * cm->chunk_rows;
+
+            if (!compressed_chunk_la(cm, c, packed, work, rows))
+            {
+                atomic_store(&ok, 0);
+
+                continue;
+            }
+
+            for (i = 0; i < nrows; i++)
+                memcpy(mat->m[c * cm->chunk_rows + i], rows + (size_t) i * cm->col, cm->col * sizeof(double));
+        }
+
+        free(packed);
+
+        free(work);
+
+        free(rows);
+    }
+
+    free_compressed_matrix(cm);
+
+    if (!ok)
+    {
+        error_message_la(145, "invalid chunk in the compressed matrix!");
+
+        free_matrix(mat);
+
+        mat = NULL;
+    }
+
+    LA_STATS_STOP(145, 0);
+
+    return mat;
+}
+
+int compressed_matrix_block(Matrix *block, int first, int rows, void *data)   // Reads rows of a compressed matrix, as a 'RowBlockReader'.
+{
+    register int i;
+    int c, r;
+
+    CompressedMatrix *cm = data;
+    unsigned char *work;
+
+    if (cm == NULL || block == NULL || block->col != cm->col || first < 0 || rows <= 0 || rows > block->row ||
+        first + rows > cm->row)
+    {
+        error_message_la(146, "invalid rows or compressed matrix informed!");
+
+        return 1;
+    }
+
+    LA_STATS_START(146);
+
+    work = malloc((size_t) cm->chunk_rows * cm->col * sizeof(double));
+
+    if (work == NULL)
+    {
+        error_message_la(146, ERRMSS01);
+
+        exit(146);
+    }
+
+    for (i = 0; i < rows; i++)
+    {
+        r = first + i;
+
+        c = r / cm->chunk_rows;
+
+        if (c != cm->cached)                        // Only the chunks of the rows asked are decompressed.
+        {
+            cm->cached = -1;
+
+            if (!compressed_chunk_la(cm, c, cm->packed, work, cm->cache))
+            {
+                error_message_la(146, "invalid chunk in the compressed matrix!");
+
+                free(work);
+
+                LA_STATS_STOP(146, 0);
+
+                return 1;
+            }
+
+            cm->cached = c;
+        }
+
+        memcpy(block->m[i], cm->cache + (size_t) (r - c * cm->chunk_rows) * cm->col, cm->col * sizeof(double));
+    }
+
+    LA_CHANGED(block);
+
+    free(work);
+
+    LA_STATS_STOP(146, 0);
+
+    return 0;
+}
+
+int compressed_matrix_row_number(CompressedMatrix *cm)     // Gives the number of rows of a compressed matrix.
+{
+    if (cm == NULL)
+        return 0;
+
+    LA_STATS_COUNT(147);
+
+    return cm->row;
+}
+
+int compressed_matrix_column_number(CompressedMatrix *cm)  // Gives the number of columns of a compressed matrix.
+{
+    if (cm == NULL)
+        return 0;
+
+    LA_STATS_COUNT(148);
+
+    return cm->col;
+}
+
+void free_compressed_matrix(CompressedMatrix *cm)   // Closes a compressed matrix and deallocates its memory.
+{
+    if (cm != NULL)
+    {
+        close(cm->fd);
+
+        free(cm->index);
+
+        free(cm->cache);
+
+        free(cm->packed);
+
+        free(cm);
+    }
+}
+
+// Banded and tridiagonal systems:
+//
+// The band is kept by rows: the row 'i' holds the columns 'i - kl' to
+// 'i + ku + kl', so the element (i, j) is at 'a[i * ld + j - i + kl]'. The last
+// 'kl' positions of each row are zero until the LU decomposition fills them, as
+// the row swaps of the pivoting widen the upper band of 'U' to 'ku + kl'.
+
+struct band_matrix
+{
+	int n;
+
+	int kl;                                                     // Diagonals below and above the main one
+
+	int ku;
+
+	int ld;                                                     // Elements kept for each row, '2 * kl + ku + 1'
+
+	double *a;
+};
+
+#define BAND(band, i, j) ((band)->a[(size_t) (i) * (band)->ld + (j) - (i) + (band)->kl])
+
+BandMatrix* create_band_matrix(int n, int kl, int ku)   // Creates a band matrix of zeros.
+{
+    BandMatrix *band;
+
+    if (n <= 0 || kl < 0 || ku < 0 || kl >= n || ku >= n)
+    {
+        error_message_la(150, "incompatible dimensions for a band matrix!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(150);
+
+    band = malloc(sizeof(BandMatrix));
+
+    if (band == NULL)
+    {
+        error_message_la(150, ERRMSS01);
+
+        exit(150);
+    }
+
+    band->n = n;
+
+    band->kl = kl;
+
+    band->ku = ku;
+
+    band->ld = 2 * kl + ku + 1;
+
+    band->a = calloc((size_t) n * band->ld, sizeof(double));
+
+    if (band->a == NULL)
+    {
+        error_message_la(150, ERRMSS01);
+
+        exit(150);
+    }
+
+    LA_STATS_BYTES(150, sizeof(BandMatrix) + (long long) n * band->ld * sizeof(double));
+
+    LA_STATS_STOP(150, 0);
+
+    return band;
+}
+
+void free_band_matrix(BandMatrix *band)             // Deallocates memory previously used for a band matrix.
+{
+    if (band != NULL)
+    {
+        free(band->a);
+
+        free(band);
+    }
+}
+
+void insert_in_band_matrix(double a, BandMatrix *band, int i, int j)  // Inserts a value in a band matrix in a given position.
+{
+    if (band == NULL)
+    {
+        error_message_la(152, ERRMSS04);
+
+        return;
+    }
+    else if (i < 0 || j < 0 || i >= band->n || j >= band->n || j - i > band->ku || i - j > band->kl)
+    {
+        error_message_la(152, "position outside the band of the matrix!");
+
+        return;
+    }
+
+    LA_STATS_COUNT(152);
+
+    BAND(band, i, j) = a;
+}
+
+double get_from_band_matrix(BandMatrix *band, int i, int j)    // Gets a value in a band matrix from a given position.
+{
+    if (band == NULL)
+    {
+        error_message_la(153, ERRMSS04);
+
+        return 0;
+    }
+    else if (i < 0 || j < 0 || i >= band->n || j >= band->n)
+    {
+        error_message_la(153, "inexistent position in the matrix!");
+
+        return 0;
+    }
+
+    LA_STATS_COUNT(153);
+
+    if (j - i > band->ku + band->kl || i - j > band->kl)   // Outside the band, including the part filled by 'band_lu_decomposition'
+        return 0;
+
+    return BAND(band, i, j);
+}
+
+BandMatrix* matrix_to_band_matrix(Matrix *mat, int kl, int ku)   // Copies the band of a square matrix.
+{
+    register int i, j;
+
+    BandMatrix *band;
+
     if (mat == NULL)
     {
-        error_message_la(38, ERRMSS04);
+        error_message_la(154, ERRMSS04);
 
         return NULL;
     }
+    else if (mat->row != mat->col)
+    {
+        error_message_la(154, "the matrix must have the same number of rows and columns!");
 
-    for (i = 0; i < mat->row; i++)
+        return NULL;
+    }
+
+    band = create_band_matrix(mat->row, kl, ku);
+
+    if (band == NULL)
+        return NULL;
+
+    LA_STATS_START(154);
+
+    for (i = 0; i < band->n; i++)
     {
-        if (mat->m[i][i] == 0 && i < mat->row - 1)  // Swaps rows, if necessary, to better organize the matrix.
+        for (j = (i - kl > 0) ? i - kl : 0; j <= i + ku && j < band->n; j++)
+            BAND(band, i, j) = mat->m[i][j];
+    }
+
+    LA_STATS_STOP(154, 0);
+
+    return band;
+}
+
+Matrix* band_matrix_to_matrix(BandMatrix *band)     // Copies a band matrix as a usual matrix.
+{
+    register int i, j;
+
+    Matrix *mat;
+
+    if (band == NULL)
+    {
+        error_message_la(155, ERRMSS04);
+
+        return NULL;
+    }
+
+    LA_STATS_START(155);
+
+    mat = create_matrix(band->n, band->n);
+
+    for (i = 0; i < band->n; i++)
+    {
+        for (j = (i - band->kl > 0) ? i - band->kl : 0; j <= i + band->ku + band->kl && j < band->n; j++)
+            mat->m[i][j] = BAND(band, i, j);
+    }
+
+    LA_STATS_STOP(155, 0);
+
+    return mat;
+}
+
+Array* band_matrix_times_array(BandMatrix *band, Array *arr)   // Multiplies a band matrix by an array.
+{
+    register int i;
+    int first, last;
+
+    Array *prod;
+
+    if (band == NULL)
+    {
+        error_message_la(156, ERRMSS04);
+
+        return NULL;
+    }
+    else if (arr == NULL)
+    {
+        error_message_la(156, ERRMSS02);
+
+        return NULL;
+    }
+    else if (arr->len != band->n)
+    {
+        error_message_la(156, "incompatible dimensions for a matrix-array multiplication!");
+
+        return NULL;
+    }
+
+    LA_STATS_START(156);
+
+    prod = create_array(band->n);
+
+    for (i = 0; i < band->n; i++)                   // The band of each row is contiguous.
+    {
+        first = (i - band->kl > 0) ? i - band->kl : 0;
+
+        last = (i + band->ku < band->n - 1) ? i + band->ku : band->n - 1;
+
+        prod->a[i] = dot_la(&BAND(band, i, first), arr->a + first, last - first + 1);
+    }
+
+    LA_STATS_STOP(156, 2.0 * band->n * (band->kl + band->ku + 1));
+
+    return prod;
+}
+
+int band_lu_decomposition(BandMatrix *band, int *piv)  // Transforms a band matrix into its LU decomposition with partial pivoting.
+{
+    register int i, j, k;
+    int p, last, right, sign = 1;
+    double fctr, tmp;
+
+    if (band == NULL)
+    {
+        error_message_la(157, ERRMSS04);
+
+        return 0;
+    }
+    else if (piv == NULL)
+    {
+        error_message_la(157, "NULL pivots informed!");
+
+        return 0;
+    }
+
+    LA_STATS_START(157);
+
+    for (k = 0; k < band->n; k++)
+    {
+        last = (k + band->kl < band->n - 1) ? k + band->kl : band->n - 1;      // Last row with an element in column 'k'
+
+        right = (k + band->ku + band->kl < band->n - 1) ? k + band->ku + band->kl : band->n - 1;
+
+        p = k;                                      // Searches for the largest element of the column within the band.
+
+        for (i = k + 1; i <= last; i++)
         {
-            for (k = i + 1; k < mat->row; k++)
+            if (fabs(BAND(band, i, k)) > fabs(BAND(band, p, k)))
+                p = i;
+        }
+
+        piv[k] = p;
+
+        if (BAND(band, p, k) == 0)                  // Singular matrix
+        {
+            LA_STATS_STOP(157, 0);
+
+            return 0;
+        }
+
+        if (p != k)                                 // The rows are swapped from column 'k' on; 'L' keeps its order.
+        {
+            for (j = k; j <= right; j++)
             {
-                if (mat->m[k][i] != 0)
-                {
-                    swap_rows(mat, i, k);
+                tmp = BAND(band, k, j);
 
-                    correction = - correction;
+                BAND(band, k, j) = BAND(band, p, j);
 
-                    break;
-                }
+                BAND(band, p, j) = tmp;
             }
+
+            sign = - sign;
         }
 
-        if (mat->m[i][i] != 0 && i < mat->row - 1)
+        for (i = k + 1; i <= last; i++)
         {
-            for (k = i + 1; k < mat->row; k++)      // Transforms into a triangular matrix.
-            {
-                if (mat->m[k][i] == 0)
-                    continue;
-                
-                fctr = - mat->m[k][i] / mat->m[i][i];
-                
-                for (j = i + 1; j < mat->col; j++)
-                    mat->m[k][j] += fctr * mat->m[i][j];
+            if (BAND(band, i, k) == 0)
+                continue;
 
-                mat->m[k][i] = 0;
-            }
+            fctr = BAND(band, i, k) /= BAND(band, k, k);   // Multiplier, kept in 'L'.
+
+            kernels()->axpy(- fctr, &BAND(band, k, k + 1), &BAND(band, i, k + 1), right - k);
         }
     }
 
-    return correction;
+    LA_STATS_STOP(157, 2.0 * band->n * band->kl * (band->ku + band->kl + 1));
+
+    return sign;
 }
 
-double determinant(Matrix *mat)         // Calculates the determinant of a square matrix.
+void over_band_lu_solve(BandMatrix *lu, int *piv, Array *b)   // Solves a system given the LU decomposition of its band matrix.
 {
-    register i;
-    int corr;
-    double det = 1;
-    Matrix *tempmat;
+    register int i, k;
+    int last, right;
+    double tmp;
 
-    if (mat == NULL)
+    if (lu == NULL)
     {
-        error_message_la(39, ERRMSS04);
+        error_message_la(158, ERRMSS04);
 
-        exit(39);
+        return;
     }
-    else if (mat->row != mat->col)          // Tests if the matrix is square.
+    else if (b == NULL)
     {
-        error_message_la(39, "incompatible dimensions to calculate a determinant!");
-
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+        error_message_la(158, ERRMSS02);
 
-        exit(39);
+        return;
     }
-
-    tempmat = copy_matrix(mat);
-
-    corr = gaussian_elimination(tempmat);   // Transforms the matrix into an upper triangular one.
-
-    for (i = 0; i < tempmat->row; i++)      // Calculates the determinant.
+    else if (piv == NULL || b->len != lu->n)
     {
-        det *= tempmat->m[i][i];
+        error_message_la(158, "incompatible dimensions to solve the system of equations!");
 
-        if (tempmat->m[i][i] == 0)
-            break;
+        return;
     }
 
-    det *= corr;                            // Corrects the signal.
-
-    free_matrix(tempmat);
-
-    return det;
-}
+    LA_STATS_START(158);
 
-double over_determinant(Matrix *mat)    // Calculates the determinant of a square matrix, overwriting the operations in it.
-{
-    register i;
-    int corr;
-    double det = 1;
+    LA_CHANGED(b);
 
-    if (mat == NULL)
+    for (k = 0; k < lu->n; k++)                     // Forward substitution with 'L', with the swaps in the same order
     {
-        error_message_la(40, ERRMSS04);
+        if (piv[k] != k)
+        {
+            tmp = b->a[k];
 
-        exit(40);
-    }
-    else if (mat->row != mat->col)          // Tests if the matrix is square.
-    {
-        error_message_la(40, "incompatible dimensions to calculate a determinant!");
+            b->a[k] = b->a[piv[k]];
 
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+            b->a[piv[k]] = tmp;
+        }
 
-        exit(40);
-    }
+        last = (k + lu->kl < lu->n - 1) ? k + lu->kl : lu->n - 1;
 
-    corr = gaussian_elimination(mat);       // Transforms the matrix into an upper triangular one.
+        for (i = k + 1; i <= last; i++)
+            b->a[i] -= BAND(lu, i, k) * b->a[k];
+    }
 
-    for (i = 0; i < mat->row; i++)          // Calculates the determinant.
+    for (i = lu->n - 1; i >= 0; i--)                // Back substitution with 'U', whose rows are contiguous
     {
-        det *= mat->m[i][i];
+        right = (i + lu->ku + lu->kl < lu->n - 1) ? i + lu->ku + lu->kl : lu->n - 1;
 
-        if (mat->m[i][i] == 0)
-            break;
+        b->a[i] = (b->a[i] - dot_la(&BAND(lu, i, i + 1), b->a + i + 1, right - i)) / BAND(lu, i, i);
     }
 
-    det *= corr;                            // Corrects the signal.
-
-    return det;
+    LA_STATS_STOP(158, 2.0 * lu->n * (2 * lu->kl + lu->ku + 1));
 }
 
-Matrix* inverse_matrix(Matrix *mat)             // Returns the inverse of a matrix if it exists.
+Array* solve_band_system(BandMatrix *band, Array *b)   // Solves a system with a band matrix.
 {
-    register i, j, k;
-    double fctr;
+    int *piv;
 
-    Matrix *tempmat, *inv;
+    BandMatrix *lu;
+    Array *x;
 
-    if (mat == NULL)
+    if (band == NULL)
     {
-        error_message_la(41, ERRMSS04);
+        error_message_la(159, ERRMSS04);
 
         return NULL;
     }
-    else if (mat->row != mat->col)                  // Tests if the matrix is square.
+    else if (b == NULL)
     {
-        error_message_la(41, "incompatible dimensions to do an inversion!");
-
-        printf("\nThe matrix must have the same number of rows and columns.\n");
+        error_message_la(159, ERRMSS02);
 
         return NULL;
     }
-
-    tempmat = copy_matrix(mat);
-
-    inv = create_identity_matrix(mat->row);         // All operations made in 'tempmat' will be made equally in 'inv'.
-
-    for (i = 0; i < tempmat->row; i++)
+    else if (b->len != band->n)
     {
-        if (tempmat->m[i][i] == 0)                  // Tests if the element of main diagonal is null.
-        {
-            if (i < tempmat->row - 1)
-            {
-                int swap = 0;
-
-                for (k = i + 1; k < tempmat->row; k++)  // Searches for another row with no null element in that position.
-                {
-                    if (tempmat->m[k][i] != 0)              // Swaps the rows.
-                    {
-                        swap_rows(tempmat, i, k);
+        error_message_la(159, "incompatible dimensions to solve the system of equations!");
 
-                        swap_rows(inv, i, k);
-
-                        swap++;
+        return NULL;
+    }
 
-                        break;
-                    }
-                }
+    LA_STATS_START(159);
 
-                if (swap == 0)                          // This implies a matrix with null determinant, wich has no inverse.
-                {
-                    printf("\n\nThe matrix has no inverse!\n");
+    lu = create_band_matrix(band->n, band->kl, band->ku);
 
-                    return NULL;
-                }
-            }
-            else
-            {
-                printf("\n\nThe matrix has no inverse!\n");
+    memcpy(lu->a, band->a, (size_t) band->n * band->ld * sizeof(double));
 
-                return NULL;
-            }
-        }
+    piv = malloc(band->n * sizeof(int));
 
-        fctr = tempmat->m[i][i];
+    if (piv == NULL)
+    {
+        error_message_la(159, ERRMSS01);
 
-        for (j = 0; j < tempmat->col; j++)          // Divides all elements by the first non-null one in the row.
-        {
-            tempmat->m[i][j] /= fctr;
+        exit(159);
+    }
 
-            inv->m[i][j] /= fctr;
-        }
+    if (band_lu_decomposition(lu, piv) == 0)
+    {
+        printf("\n\nThe system has no single solution!\n");
 
-        for (k = 0; k < tempmat->row; k++)          // The elements that are not in the main diagonal are turned null.
-        {
-            if (k == i)
-                continue;
+        x = NULL;
+    }
+    else
+    {
+        x = copy_array(b);
 
-            fctr = - tempmat->m[k][i];
+        over_band_lu_solve(lu, piv, x);
+    }
 
-            for (j = 0; j < tempmat->col; j++)
-            {
-                if(tempmat->m[i][j] != 0)               // Jumps some inutile operations.
-                    tempmat->m[k][j] += fctr * tempmat->m[i][j];
+    free_band_matrix(lu);
 
-                inv->m[k][j] += fctr * inv->m[i][j];
-            }
-        }
-    }
+    free(piv);
 
-    free_matrix(tempmat);
+    LA_STATS_STOP(159, 0);
 
-    return inv;
+    return x;
 }
 
-double polynomial_function(double x, Array *coef)   // Evaluates a polynomial for a given 'x' value.
+Array* tridiagonal_solve(Array *sub, Array *diag, Array *sup, Array *b)   // Solves a tridiagonal system by the Thomas algorithm.
 {
     register int i;
-    double fx;
+    int n;
+    double w, *cp;
 
-    if (coef == NULL)
+    Array *x;
+
+    if (sub == NULL || diag == NULL || sup == NULL || b == NULL)
     {
-        error_message_la(42, ERRMSS02);
+        error_message_la(160, ERRMSS02);
 
-        return 0;
+        return NULL;
     }
 
-    if (coef->len == 1)
-        return coef->a[0];
-                                                                // Horner's method for polynomials
-    fx = coef->a[coef->len - 1] * x + coef->a[coef->len - 2];
+    n = diag->len;
 
-    if (coef->len > 2)                                              // If the polynomial's degree is higher than 1
+    if (sub->len != n || sup->len != n || b->len != n)
     {
-        for (i = coef->len - 2; i >= 1; i--)
-            fx = fx * x + coef->a[i - 1];
+        error_message_la(160, "incompatible dimensions to solve the system of equations!");
+
+        return NULL;
     }
 
-    return fx;
-}
+    LA_STATS_START(160);
 
-// Functions for systems of equations:
+    x = create_array(n);
 
-Matrix* get_system(char *name)          // Get an augmented matrix of a system of equations from a 'txt' file.
-{
-    register int i, j;
-    int m, n;
+    cp = malloc(n * sizeof(double));                // Upper diagonal of the eliminated system
 
-    Matrix *sys;
-    FILE *filin;
+    if (cp == NULL)
+    {
+        error_message_la(160, ERRMSS01);
 
-    filin = fopen(name, "r");
+        exit(160);
+    }
 
-    if (filin == NULL)
+    for (i = 0; i < n; i++)                         // Elimination of the lower diagonal
     {
-        error_message_la(43, ERRMSS03);
+        w = diag->a[i] - ((i > 0) ? sub->a[i] * cp[i - 1] : 0);
 
-        exit(43);
-    }
+        if (w == 0)
+        {
+            printf("\n\nZero pivot in the tridiagonal system!\n");
 
-    fscanf(filin, "%dx%d", &m, &n);
+            free_array(x);
 
-    if (n != m + 1)                         // Tests the system dimensions.
-    {
-        error_message_la(43, "invalid system dimensions!");
+            free(cp);
 
-        printf("\nThe number of equations and variables must be the same.\n");
+            LA_STATS_STOP(160, 0);
 
-        return NULL;
-    }
+            return NULL;
+        }
 
-    sys = create_matrix(m, n);
+        cp[i] = (i < n - 1) ? sup->a[i] / w : 0;
 
-    for (i = 0; i < m; i++)
-    {
-        for (j = 0; j < n; j++)
-            fscanf(filin, " %lf", &sys->m[i][j]);
+        x->a[i] = (b->a[i] - ((i > 0) ? sub->a[i] * x->a[i - 1] : 0)) / w;
     }
 
-    fclose(filin);
+    for (i = n - 2; i >= 0; i--)                    // Back substitution
+        x->a[i] -= cp[i] * x->a[i + 1];
 
-    return sys;
+    free(cp);
+
+    LA_STATS_STOP(160, 8.0 * n);
+
+    return x;
 }
 
-int independent_system(Matrix *mat)         // Tests if the system is independent or not.
+int batch_tridiagonal_solve(Matrix *sub, Matrix *diag, Matrix *sup, Matrix *b)    // Solves many tridiagonal systems, one in each column.
 {
-    register int i;
+    register int i, s;
+    int n, count, first, last, bad = 0;
+    double w, *cp;
 
-    if (mat == NULL)
+    if (sub == NULL || diag == NULL || sup == NULL || b == NULL)
     {
-        error_message_la(44, ERRMSS04);
+        error_message_la(161, ERRMSS04);
 
-        exit(44);
+        return 0;
     }
 
-    for (i = 0; i < mat->row; i++)              // Walks through the main diagonal of the superior triangular matrix of coefficients.
+    n = diag->row;
+
+    count = diag->col;
+
+    if (sub->row != n || sup->row != n || b->row != n || sub->col != count || sup->col != count || b->col != count)
     {
-        if (mat->m[i][i] == 0)
-            return 0;                               // Returns '0' if the product of the elements is null.
+        error_message_la(161, "incompatible dimensions to solve the systems of equations!");
+
+        return 0;
     }
 
-    return 1;                                       // Returns '1' otherwise.
-}
+    LA_STATS_START(161);
 
-Array* solve_system(Matrix *mat)                    // Solves a system of 'n' equations and 'n' variables.
-{
-    register int i, j;
+    LA_CHANGED(b);
 
-    Array *sol;
-    Matrix *tempmat;
+    cp = malloc((size_t) n * count * sizeof(double));  // Upper diagonals of the eliminated systems, by rows
 
-    if (mat == NULL)
+    if (cp == NULL)
     {
-        error_message_la(45, ERRMSS04);
+        error_message_la(161, ERRMSS01);
 
-        return NULL;
+        exit(161);
     }
-    else if (mat->col != mat->row + 1 || mat->row < 1)  // Tests the coherence of the numbers of equations and variables.
-    {
-        error_message_la(45, "incompatible dimensions to solve the system of equations!");
 
-        return NULL;
-    }
+    // Each step works on the same row of all the systems, so the inner loops run
+    // over contiguous elements and are vectorized; threads take blocks of systems.
+    #pragma omp parallel for private(i, s, last, w) reduction(|:bad) if ((long long) n * count >= tuning_la.batch_parallel)
+    for (first = 0; first < count; first += 256)
+    {
+        last = (first + 256 < count) ? first + 256 : count;
 
-    tempmat = copy_matrix(mat);
+        for (s = first; s < last; s++)
+        {
+            w = diag->m[0][s];
 
-    gaussian_elimination(tempmat);
+            bad |= (w == 0);
 
-    if (!independent_system(tempmat))                   // Tests if the system is independent.
-    {
-        printf("\n\nNo solution!\n\nThe system of equations is dependent or inconsistent!\n\a");
+            cp[s] = sup->m[0][s] / w;
 
-        return NULL;
-    }
-    else                                                    // Calculates the solution if it is independent.
-    {
-        sol = create_array(mat->row);
+            b->m[0][s] /= w;
+        }
 
-        for (i = sol->len - 1; i >= 0; i--)                     // Solves the system by simple substitution.
+        for (i = 1; i < n; i++)
         {
-            sol->a[i] = tempmat->m[i][tempmat->col - 1];
+            double *cpi = cp + (size_t) i * count, *cpp = cpi - count;
 
-            for (j = i + 1; j < tempmat->col - 1; j++)
-                sol->a[i] -= tempmat->m[i][j] * sol->a[j];
+            for (s = first; s < last; s++)
+            {
+                w = diag->m[i][s] - sub->m[i][s] * cpp[s];
 
-            sol->a[i] /= tempmat->m[i][i];
+                bad |= (w == 0);
+
+                cpi[s] = sup->m[i][s] / w;
+
+                b->m[i][s] = (b->m[i][s] - sub->m[i][s] * b->m[i - 1][s]) / w;
+            }
+        }
+
+        for (i = n - 2; i >= 0; i--)
+        {
+            double *cpi = cp + (size_t) i * count;
+
+            for (s = first; s < last; s++)
+                b->m[i][s] -= cpi[s] * b->m[i + 1][s];
         }
     }
 
-    free_matrix(tempmat);
+    free(cp);
 
-    return sol;
+    if (bad)
+        printf("\n\nZero pivot in a tridiagonal system!\n");
+
+    LA_STATS_STOP(161, 8.0 * n * count);
+
+    return !bad;
 }
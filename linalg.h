@@ -2,6 +2,13 @@
 //
 
 
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
 // Type exported for arrays
 //
 typedef struct array Array;
@@ -10,6 +17,28 @@ typedef struct array Array;
 //
 typedef struct matrix Matrix;
 
+// Type exported for batches of three-dimensional vectors
+//
+typedef struct vector_batch VectorBatch;
+
+// Type exported for matrixes stored by tiles in a file
+//
+typedef struct tiled_matrix TiledMatrix;
+
+// Types exported for matrices read and written by rows
+//
+typedef struct matrix_reader MatrixReader;
+
+typedef struct matrix_writer MatrixWriter;
+
+// Type exported for compressed matrices in a file
+//
+typedef struct compressed_matrix CompressedMatrix;
+
+// Type exported for band matrices
+//
+typedef struct band_matrix BandMatrix;
+
 
 //
 // In-Out functions:
@@ -21,6 +50,22 @@ typedef struct matrix Matrix;
 //
 Array* create_array(int len);
 
+// Creates an array whose elements are those of a given buffer of 'len' doubles,
+// without copying them. If 'deleter' is not NULL, the array owns the buffer and
+// 'free_array' calls 'deleter(buffer)' ('free' for a buffer from 'malloc');
+// otherwise the caller keeps it, and it must remain valid while the array is used.
+// Writes made directly to the buffer must be followed by 'array_changed' (see
+// 'array_pointer').
+// Returns NULL if 'buffer' is NULL or 'len' is equal zero or negative.
+//
+Array* wrap_array(double *buffer, int len, void (*deleter)(void *buffer));
+
+// Creates an array with a given length without setting its elements, for when
+// all of them will be written next.
+// Returns NULL if 'len' is equal zero or negative.
+//
+Array* create_array_uninitialized(int len);
+
 // Deallocates memory previously used for an array.
 //
 void free_array(Array *arr);
@@ -30,6 +75,17 @@ void free_array(Array *arr);
 //
 int length_of_array(Array *arr);
 
+// Gives the counter of changes of an array. It starts at '1' and every function
+// that changes the elements of the array (the 'over_' functions, 'insert_in_array'
+// and those that write their results in a given array) increases it, so a value
+// calculated from the array is still valid while the counter is the same.
+// Functions like 'euclidean_norm' use it to return their last result at once.
+// Changes made directly to the elements of the array are only counted when they
+// are reported with 'array_changed'.
+// A NULL array returns '0'.
+//
+unsigned long long array_version(Array *arr);
+
 // Inserts a value in an array in a given position.
 //
 void insert_in_array(double a, Array *arr, int pos);
@@ -40,6 +96,27 @@ void insert_in_array(double a, Array *arr, int pos);
 //
 double get_from_array(Array *arr, int pos);
 
+// Copies a buffer of 'length_of_array(arr)' elements to an array, or all the
+// elements of an array to a buffer of that size, much faster than element by
+// element with 'insert_in_array' and 'get_from_array'.
+//
+void set_array_buffer(Array *arr, double *values);
+
+void get_array_buffer(Array *arr, double *values);
+
+// Gives the elements of an array, so that they can be read and written directly
+// (a pointer checked once instead of each element). Changes made this way must
+// be followed by 'array_changed', or the values saved with 'array_version' (as
+// by 'euclidean_norm') are still used. It is valid until the array is freed or
+// its length changes. Returns NULL if 'arr' is NULL.
+//
+double* array_pointer(Array *arr);
+
+// Records a change made directly to the elements of an array, through
+// 'array_pointer' or the buffer of 'wrap_array', increasing its 'array_version'.
+//
+void array_changed(Array *arr);
+
 // Get an array from a 'txt' file.
 //
 Array* get_array(char *name);
@@ -58,6 +135,23 @@ Matrix* create_matrix(int m, int n);
 //
 Matrix* create_identity_matrix(int ord);
 
+// Creates an 'm x n' matrix whose rows are in a given buffer, without copying
+// them: the row 'i' starts at 'buffer + i * stride', with 'stride >= n' ('n' for
+// a row-major buffer). 'deleter' works as in 'wrap_array', and 'free_matrix'
+// never frees the buffer if it is NULL. Functions that rearrange rows move the
+// data itself, so the buffer always holds the matrix. Writes made directly to the
+// buffer must be followed by 'matrix_changed' (see 'matrix_row_pointer').
+// Returns NULL if 'buffer' is NULL, 'm' or 'n' are equal zero or negative, or
+// 'stride' is smaller than 'n'.
+//
+Matrix* wrap_matrix(double *buffer, int m, int n, int stride, void (*deleter)(void *buffer));
+
+// Creates a matrix with given dimensions without setting its elements, for when
+// all of them will be written next.
+// Returns NULL if 'm' or 'n' are equal zero or negative.
+//
+Matrix* create_matrix_uninitialized(int m, int n);
+
 // Deallocates memory previously used for a matrix.
 //
 void free_matrix(Matrix *mat);
@@ -72,6 +166,14 @@ int matrix_row_number(Matrix *mat);
 //
 int matrix_column_number(Matrix *mat);
 
+// Gives the counter of changes of a matrix, as 'array_version' for arrays.
+// 'determinant' and 'frobenius_norm' return their last result at once while it
+// is the same, and the factorization cache (see 'linalg_factor_cache') finds the
+// decomposition of the matrix without comparing its elements.
+// A NULL matrix returns '0'.
+//
+unsigned long long matrix_version(Matrix *mat);
+
 // Inserts a value in a matrix in a given position.
 //
 void insert_in_matrix(double a, Matrix *mat, int i, int j);
@@ -82,7 +184,58 @@ void insert_in_matrix(double a, Matrix *mat, int i, int j);
 //
 double get_from_matrix(Matrix *mat, int i, int j);
 
+// Bulk accessors, much faster than 'insert_in_matrix' and 'get_from_matrix' for
+// many elements: the arguments are checked once and the rows are copied whole.
+// The 'set' functions copy from the buffer 'values' to the matrix and the 'get'
+// functions from the matrix to it. Nothing is copied if the matrix or the buffer
+// is NULL or the positions do not exist, and an error message is shown.
+
+// A row 'i' of the matrix, with 'matrix_column_number(mat)' elements:
+//
+void set_matrix_row(Matrix *mat, int i, double *values);
+
+void get_matrix_row(Matrix *mat, int i, double *values);
+
+// A column 'j' of the matrix, with 'matrix_row_number(mat)' elements:
+//
+void set_matrix_column(Matrix *mat, int j, double *values);
+
+void get_matrix_column(Matrix *mat, int j, double *values);
+
+// A block of 'rows x cols' elements of the matrix starting at position (i, j),
+// kept in the buffer by rows, with each row starting 'ld' (at least 'cols')
+// elements after the previous one:
+//
+void set_matrix_block(Matrix *mat, int i, int j, int rows, int cols, double *values, int ld);
+
+void get_matrix_block(Matrix *mat, int i, int j, int rows, int cols, double *values, int ld);
+
+// All the elements of the matrix, kept in the buffer by rows:
+//
+void set_matrix_buffer(Matrix *mat, double *values);
+
+void get_matrix_buffer(Matrix *mat, double *values);
+
+// Gives the 'matrix_column_number(mat)' elements of row 'i' of a matrix, so that
+// they can be read and written directly. Changes made this way must be followed
+// by 'matrix_changed', or the values saved with 'matrix_version' (as by
+// 'determinant') are still used. The rows of a matrix are not contiguous with
+// each other, and the pointer of a row may change with 'swap_rows' and the
+// functions that rearrange or resize the matrix.
+// Returns NULL if the matrix is NULL or the row does not exist.
+//
+double* matrix_row_pointer(Matrix *mat, int i);
+
+// Records a change made directly to the elements of a matrix, through
+// 'matrix_row_pointer' or the buffer of 'wrap_matrix', increasing its
+// 'matrix_version'.
+//
+void matrix_changed(Matrix *mat);
+
 // Get a matrix from a 'txt' file.
+// The file may also be a binary one written by 'save_matrix' or a compressed one
+// written by 'save_compressed_matrix'.
+// Returns NULL if the file does not hold a matrix or ends before all its elements.
 //
 Matrix* get_matrix(char *name);
 
@@ -90,10 +243,6 @@ Matrix* get_matrix(char *name);
 //
 void print_matrix(Matrix *mat);
 
-// Shows an error message indicating the function from where it came.
-//
-static void error_message_la(int nmbr, char *mssg);
-
 
 //
 // Copy functions:
@@ -175,6 +324,24 @@ void over_array_times_matrix(Array *arr, Matrix *mat);
 //
 void over_matrix_times_array(Matrix *mat, Array *arr);
 
+// Calculates 'y = alpha * mat * x + beta * y', overwriting 'y'.
+// If 'beta' is zero, the previous values of 'y' are not used.
+//
+void gemv(double alpha, Matrix *mat, Array *x, double beta, Array *y);
+
+// Calculates 'y = alpha * transpose(mat) * x + beta * y', overwriting 'y',
+// without transposing the matrix.
+// If 'beta' is zero, the previous values of 'y' are not used.
+//
+void gemv_transposed(double alpha, Matrix *mat, Array *x, double beta, Array *y);
+
+// Calculates 'y = alpha * mat * x + beta * y' for several vectors in only one
+// pass over the matrix. Each row of 'xs' is a vector 'x' and the row with
+// the same index in 'ys' is the corresponding 'y', which is overwritten.
+// If 'beta' is zero, the previous values of 'ys' are not used.
+//
+void gemv_multiple(double alpha, Matrix *mat, Matrix *xs, double beta, Matrix *ys);
+
 // Sums two matrixes and saves the result as a new one.
 // Returns NULL if the dimensions are incompatible with a sum
 // or if one or two of given matrices are NULL.
@@ -196,8 +363,29 @@ Matrix* rnumber_times_matrix(double num, Matrix *mat);
 // Returns NULL if the dimensions are incompatible with a multiplication
 // or if one or two of given matrices are NULL.
 //
+// If the tuning parameter 'strassen_cutoff' is set (see 'linalg_init') and all
+// dimensions are larger than it, the Strassen-Winograd method is used: the
+// dimensions are halved recursively, with 7 products instead of 8 at each level,
+// until one of them is not larger than the cutoff. It needs extra memory for
+// copies of the factors and of the result, plus about a third of that for the
+// temporaries. Its error is only bounded normwise: for order n and cutoff n0,
+//
+//   max|C - C'| <= [(n/n0)^log2(18) * (n0^2 + 6 * n0) - 6 * n] * u * max|A| * max|B|
+//
+// to first order in the unit roundoff u (Higham, "Accuracy and Stability of
+// Numerical Algorithms", 2nd ed., chapter 23), against |C - C'| <= n * u * |A| * |B|
+// elementwise for the usual method. Small elements of the result may therefore
+// lose all their precision when the factors have elements of very different
+// magnitudes; scaling the rows of 'a' and the columns of 'b' reduces the problem.
+//
 Matrix* matrix_times_matrix(Matrix *a, Matrix *b);
 
+// Multiplies two matrixes and saves the result in a pre-existing one, as
+// 'matrix_times_matrix' without allocating it. 'c' must have the rows of 'a'
+// and the columns of 'b' and cannot be one of the factors.
+//
+void matrix_times_matrix_into(Matrix *a, Matrix *b, Matrix *c);
+
 // Transposes a matrix and saves the result as a new one.
 // Returns NULL if the given matrix is NULL.
 //
@@ -248,6 +436,12 @@ Array* vector_product(Array *a, Array *b);
 //
 double euclidean_norm(Array *arr);
 
+// Calculates the Frobenius norm of a matrix: the square root of the sum of the
+// squares of its elements.
+// Returns '0' if 'mat' is NULL.
+//
+double frobenius_norm(Matrix *mat);
+
 // Determines the cosine of the angle between two vectors (arrays).
 // Returns '100' if one or both arrays are NULL
 // or have a zero length.
@@ -255,9 +449,22 @@ double euclidean_norm(Array *arr);
 double cosine_similarity(Array *a, Array *b);
 
 // Changes two rows of a matrix.
+// Only the references to the rows are exchanged, so it takes constant time.
 //
 void swap_rows(Matrix *mat, int a, int b);
 
+// Rearranges the elements of an array according to a permutation:
+// the element in position 'perm[i]' goes to position 'i'.
+// 'perm' must have the length of the array.
+//
+void apply_permutation_to_array(Array *arr, int *perm);
+
+// Rearranges the rows of a matrix according to a permutation:
+// the row 'perm[i]' becomes the row 'i'. Only the references to the
+// rows are moved. 'perm' must have one element for each row.
+//
+void apply_permutation_to_matrix(Matrix *mat, int *perm);
+
 // Transforms a square matrix into an upper triangular matrix, if it is possible.
 // Also works with a matrix that is not square, but only with elements that
 // have indices i > j.
@@ -266,6 +473,23 @@ void swap_rows(Matrix *mat, int a, int b);
 //
 int gaussian_elimination(Matrix *mat);
 
+// Transforms a square matrix into its LU decomposition with partial pivoting.
+// The strictly lower part receives 'L' (with a unit main diagonal, not stored)
+// and the upper part receives 'U'. The rows of the matrix are permuted in place
+// by the pivoting (the references to the rows are swapped, or the elements are
+// moved for wrapped matrices), and 'perm', that must have one element for each
+// row, records the resulting order: row 'i' of the matrix and of 'L * U' is row
+// 'perm[i]' of the original matrix.
+// Returns '1' or '-1', the sign of the permutation, or '0' if the matrix is singular.
+//
+int lu_decomposition(Matrix *mat, int *perm);
+
+// Solves the system 'A * x = b', given the LU decomposition of 'A' and its
+// permutation, as calculated by 'lu_decomposition'.
+// The solution overwrites 'b'.
+//
+void over_lu_solve(Matrix *lu, int *perm, Array *b);
+
 // Calculates the determinant of a square matrix.
 //
 double determinant(Matrix *mat);
@@ -286,6 +510,13 @@ Matrix* inverse_matrix(Matrix *mat);
 //
 double polynomial_function(double x, Array *coef);
 
+// Evaluates a polynomial for all the values in 'xs', saving the results in 'out'.
+// If 'dout' is not NULL, the derivative of the polynomial in each value is saved
+// in it in the same pass.
+// The arrays 'xs', 'out' and 'dout' must have the same length.
+//
+void polynomial_eval_many(Array *coef, Array *xs, Array *out, Array *dout);
+
 
 //
 // Functions for systems of equations:
@@ -304,4 +535,727 @@ int independent_system(Matrix *mat);
 // Solves a system of 'n' equations and 'n' variables.
 // Returns NULL if the system has no single solution.
 //
-Array* solve_system(Matrix *mat);
\ No newline at end of file
+Array* solve_system(Matrix *mat);
+
+//
+// Decompositions:
+//
+
+
+// Type of the function used to read blocks of rows of a matrix that is not in memory.
+// It must fill the first 'rows' rows of 'block' with the rows 'first' to
+// 'first + rows - 1' of the matrix and return '0', or return another value if
+// the reading fails.
+//
+typedef int (*RowBlockReader)(Matrix *block, int first, int rows, void *data);
+
+// Calculates the QR decomposition of a matrix with at least as many rows as columns,
+// by means of Householder reflections.
+// For a 'm x n' matrix, 'q' receives a new 'm x n' matrix with orthonormal columns
+// and 'r' a new 'n x n' upper triangular matrix. Any of them may be NULL if that
+// factor is not needed.
+//
+void qr_decomposition(Matrix *mat, Matrix **q, Matrix **r);
+
+// Calculates the Cholesky decomposition of a symmetric positive definite matrix:
+// returns a new lower triangular matrix 'L' such that 'mat = L * transpose(L)'.
+// Only the lower part of the matrix is used.
+// Returns NULL if the matrix is not square or not positive definite.
+//
+Matrix* cholesky_decomposition(Matrix *mat);
+
+// Calculates a truncated singular value decomposition of a matrix with a randomized
+// range finder: mat ~ u * diag(s) * transpose(v).
+// 'u' receives a new 'm x rank' matrix, 's' a new array with the 'rank' largest
+// singular values in decreasing order and 'v' a new 'n x rank' matrix.
+// 'oversampling' extra directions are sampled to improve the approximation and
+// 'power_iter' power iterations can be used when the singular values decay slowly.
+// Returns '1' on success and '0' otherwise.
+//
+int randomized_svd(Matrix *mat, int rank, int oversampling, int power_iter,
+                   Matrix **u, Array **s, Matrix **v);
+
+// Same as 'randomized_svd', for a 'm x n' matrix read in blocks of 'block_rows'
+// rows by 'read', so that it never needs to be entirely in memory.
+// The matrix is read '2 * power_iter + 2' times.
+//
+int randomized_svd_stream(int m, int n, RowBlockReader read, void *data, int block_rows,
+                          int rank, int oversampling, int power_iter,
+                          Matrix **u, Array **s, Matrix **v);
+
+
+//
+// Batches of three-dimensional vectors:
+//
+
+
+// Creates a batch of a given number of three-dimensional vectors, kept as
+// separate arrays of 'x', 'y' and 'z' components.
+// Returns NULL if 'len' is equal zero or negative.
+//
+VectorBatch* create_vector_batch(int len);
+
+// Deallocates memory previously used for a batch of vectors.
+//
+void free_vector_batch(VectorBatch *vb);
+
+// Gives the number of vectors in a batch.
+// A NULL batch returns '0'.
+//
+int length_of_vector_batch(VectorBatch *vb);
+
+// Inserts a vector in a batch in a given position.
+//
+void insert_in_vector_batch(double x, double y, double z, VectorBatch *vb, int pos);
+
+// Gets a component ('0', '1' or '2') of the vector in a given position of a batch.
+// If the position or the component do not exist or the batch is NULL,
+// the function returns '0'.
+//
+double get_from_vector_batch(VectorBatch *vb, int pos, int comp);
+
+// Calculates the vector products of the vectors in two batches, saving them in 'out'.
+// 'out' may be one of the other batches.
+//
+void batch_vector_product(VectorBatch *a, VectorBatch *b, VectorBatch *out);
+
+// Calculates the scalar products of the vectors in two batches, saving them in 'out'.
+//
+void batch_scalar_product(VectorBatch *a, VectorBatch *b, Array *out);
+
+// Calculates the euclidean norms of the vectors in a batch, saving them in 'out'.
+//
+void batch_euclidean_norm(VectorBatch *vb, Array *out);
+
+// Normalizes all the vectors in a batch, overwriting them.
+// Vectors with zero length are kept unchanged.
+//
+void over_normalize_vector_batch(VectorBatch *vb);
+
+
+//
+// Profiling counters:
+//
+
+
+// Counters of one function, identified by the number used in its error messages.
+// 'seconds' and 'flops' include the functions called by it. The memory allocated by
+// the creation functions is added to them and to the outermost function that was
+// running in the thread, so 'bytes' is meaningful for the calls made by the program.
+//
+typedef struct function_stats
+{
+    int number;
+
+    char *name;
+
+    long long calls;
+
+    double seconds;
+
+    long long bytes;
+
+    double flops;
+} FunctionStats;
+
+// Tells if the library was compiled with the profiling counters (LINALG_STATS).
+// Without them, all counters are zero and the functions have no overhead.
+//
+int linalg_stats_enabled(void);
+
+// Copies the counters of up to 'len' functions into 'stats', ordered by number
+// (the function number 'i' is in 'stats[i - 1]').
+// Returns the number of functions, so that it can be called first with 'len' zero.
+//
+int linalg_stats_snapshot(FunctionStats *stats, int len);
+
+// Clears all counters.
+//
+void linalg_stats_reset(void);
+
+// Writes the counters of the functions that were called in JSON.
+//
+void linalg_stats_print_json(FILE *out);
+
+
+//
+// Kernels selected at run time:
+//
+
+
+// Gives the name of the kernels used in the innermost loops of the library:
+// "generic", "avx2" or "avx512". They are chosen when the library is loaded,
+// by the instruction sets of the processor, unless the environment variable
+// LINALG_KERNELS forces a choice.
+//
+char* linalg_kernels_name(void);
+
+// Selects the kernels used by the library by their name.
+// Returns '1' on success, or '0' if they are not available on this processor.
+// It must not be called while other threads use the library.
+//
+int linalg_select_kernels(char *name);
+
+//
+// Tuning parameters:
+//
+
+
+// Loads a tuning profile: a text file with lines 'name = value' ('#' starts a
+// comment), as written by 'linalg_print_tuning' and by the 'tune_linalg' tool,
+// which measures the best values for the machine. If 'profile' is NULL, the file
+// named by the environment variable LINALG_TUNING is loaded, if there is one.
+// The parameters are:
+//
+//   gemm_block_rows, gemm_block_inner, gemm_block_cols:
+//       rows of the result computed together, and rows and columns of the blocks
+//       of the second factor kept in cache by 'matrix_times_matrix';
+//   gemm_parallel: multiply-adds from which matrix products are multithreaded;
+//   gemv_parallel: matrix elements from which matrix-vector products are multithreaded;
+//   gemv_columns: columns of each block in 'array_times_matrix' and similar functions;
+//   elementwise_parallel: matrix elements from which sums, subtractions and
+//       multiplications by real numbers are multithreaded;
+//   batch_parallel: vectors from which batch operations are multithreaded;
+//   poly_parallel: values from which 'polynomial_eval_many' is multithreaded;
+//   strassen_cutoff: order from which matrix products use the Strassen-Winograd
+//       method, or '0' (default) to disable it; see 'matrix_times_matrix';
+//   dag_tile: order of the tiles of the task-graph factorizations (128);
+//   dag_workers: threads of the task-graph factorizations, or '0' (default) for
+//       one for each processor.
+//
+// Returns '1' on success, or '0' if the file could not be read or has invalid lines
+// (the valid ones are applied). It must be called before other threads use the library.
+//
+int linalg_init(char *profile);
+
+// Changes a tuning parameter (see 'linalg_init').
+// Returns '1' on success, or '0' for unknown names and values out of range.
+//
+int linalg_set_parameter(char *name, int value);
+
+// Gives the value of a tuning parameter, or '-1' for unknown names.
+//
+int linalg_get_parameter(char *name);
+
+// Writes the tuning parameters in use as a profile that 'linalg_init' can load.
+//
+void linalg_print_tuning(FILE *filout);
+
+
+//
+// Out-of-core matrices:
+//
+
+
+// Tiled matrices are kept in a file, as square tiles of 'tile x tile' elements,
+// and only a cache of tiles is in memory, so they can be larger than the memory.
+// The cache is limited to 'budget' bytes (but holds at least four tiles) and is
+// replaced by the least recently used policy; a thread of each matrix reads in
+// advance the tiles that the operations will need next, while they calculate.
+// Tiles of 512 x 512 elements (2 MB) are a good choice for large matrices.
+// The positions are counted from zero, as in 'insert_in_matrix'.
+
+// Creates a matrix of zeros stored by tiles in a new file (replacing any file
+// with the same name). The file is sparse, so it only occupies the disk space
+// of the tiles written.
+// Returns NULL if the name is NULL, the dimensions are not positive or the file
+// cannot be created.
+//
+TiledMatrix* create_tiled_matrix(char *path, int m, int n, int tile, long long budget);
+
+// Opens a tiled matrix saved in a file by the functions of this section.
+// Returns NULL if the file cannot be opened or does not hold a tiled matrix.
+//
+TiledMatrix* open_tiled_matrix(char *path, long long budget);
+
+// Saves the changes of a tiled matrix to its file and frees its memory.
+// The file is kept.
+//
+void free_tiled_matrix(TiledMatrix *tm);
+
+// Inserts a value in a tiled matrix in a given position.
+// It reads and writes a whole tile, so it is only suited to a few elements.
+//
+void insert_in_tiled_matrix(double a, TiledMatrix *tm, int i, int j);
+
+// Gets a value in a tiled matrix from a given position.
+// If the position does not exist or the matrix is NULL, the function returns '0'.
+//
+double get_from_tiled_matrix(TiledMatrix *tm, int i, int j);
+
+// Saves a matrix in a new file as a tiled matrix.
+// Returns NULL if the matrix is NULL or the file cannot be created.
+//
+TiledMatrix* matrix_to_tiled_matrix(Matrix *mat, char *path, int tile, long long budget);
+
+// Loads a tiled matrix in memory as a usual matrix.
+// Returns NULL if the given matrix is NULL.
+//
+Matrix* tiled_matrix_to_matrix(TiledMatrix *tm);
+
+// Multiplies two tiled matrixes and saves the result in a third one, 'c', that
+// must already have the dimensions of the product. The three matrices must have
+// the same tile size. Each tile of 'c' is calculated from a row of tiles of 'a'
+// and a column of tiles of 'b', read in advance one product ahead.
+// Returns '1' on success, or '0' for NULL matrices or incompatible dimensions.
+//
+int tiled_matrix_times_matrix(TiledMatrix *a, TiledMatrix *b, TiledMatrix *c);
+
+// Transposes a tiled matrix and saves the result in another one, 'tr', that must
+// already have the transposed dimensions and the same tile size.
+// Returns '1' on success, or '0' for NULL matrices or incompatible dimensions.
+//
+int tiled_transpose_matrix(TiledMatrix *mat, TiledMatrix *tr);
+
+// Transforms a square tiled matrix into its LU decomposition with partial pivoting,
+// with the same results as 'lu_decomposition': the rows are swapped in place, so
+// 'tiled_matrix_to_matrix' gives the matrix that 'over_lu_solve' uses.
+// Each column of tiles is factored in memory, with the pivots searched in all of
+// its rows, so 'n x tile' elements are allocated besides the cache.
+// Returns '1' or '-1', the sign of the permutation, or '0' if the matrix is singular.
+//
+int tiled_lu_decomposition(TiledMatrix *tm, int *perm);
+
+// Writes the modified tiles of a tiled matrix to its file.
+//
+void sync_tiled_matrix(TiledMatrix *tm);
+
+// Gives the number of rows of a tiled matrix.
+// A NULL matrix returns '0'.
+//
+int tiled_matrix_row_number(TiledMatrix *tm);
+
+// Gives the number of columns of a tiled matrix.
+// A NULL matrix returns '0'.
+//
+int tiled_matrix_column_number(TiledMatrix *tm);
+
+//
+// Asynchronous tasks:
+//
+
+
+// Type exported for operations run by the worker threads
+//
+typedef struct async_task AsyncTask;
+
+// Function called by a worker thread when a task finishes, whatever its state.
+// It must not call 'task_wait' or 'free_task' for the same task.
+//
+typedef void (*TaskCallback)(AsyncTask *task, void *data);
+
+#define TASK_PENDING 0                  // States of a task
+#define TASK_RUNNING 1
+#define TASK_DONE 2
+#define TASK_CANCELLED 3
+#define TASK_FAILED 4
+
+// Functions that run 'inverse_matrix', 'matrix_times_matrix' and 'solve_system'
+// in a pool of worker threads, started on the first call, and return at once.
+// The arguments are copied, so they can be changed or freed right after the call.
+// When the task finishes, 'done' (if not NULL) is called by the worker thread
+// with the task and 'data'. The tasks run in the order they were submitted.
+// Return NULL if the arguments are invalid, like the synchronous functions.
+//
+AsyncTask* inverse_matrix_async(Matrix *mat, TaskCallback done, void *data);
+
+AsyncTask* matrix_times_matrix_async(Matrix *a, Matrix *b, TaskCallback done, void *data);
+
+AsyncTask* solve_system_async(Matrix *mat, TaskCallback done, void *data);
+
+// Gives the state of a task: TASK_PENDING, TASK_RUNNING, TASK_DONE, TASK_CANCELLED,
+// or TASK_FAILED if the operation had no result (a singular matrix, for example).
+//
+int task_status(AsyncTask *task);
+
+// Gives the fraction of the work of a task already done, from '0' to '1'.
+//
+double task_progress(AsyncTask *task);
+
+// Asks a task to stop. A pending task is removed from the queue and its callback
+// is called by this thread; a running one stops at its next checkpoint, within
+// a few rows of the elimination or blocks of the product.
+// Returns '1' if the task will end as cancelled, or '0' if it had already finished.
+//
+int task_cancel(AsyncTask *task);
+
+// Waits for the end of a task (and of its callback) and gives its result: a
+// Matrix* for the inverse and the product, or an Array* for a system; NULL if it
+// was cancelled or failed. The result belongs to the caller from then on.
+//
+void* task_wait(AsyncTask *task);
+
+// Frees a task. If it has not finished, it is freed when it does, so this never
+// blocks. A result not taken with 'task_wait' is freed with it.
+//
+void free_task(AsyncTask *task);
+
+// Starts the worker threads, 'workers' of them, or one for each processor if it
+// is zero or negative. It has no effect if they are running.
+// Returns the number of workers.
+//
+int linalg_start_workers(int workers);
+
+// Stops the worker threads after running the queued tasks. They are started
+// again by the next task.
+//
+void linalg_stop_workers(void);
+
+
+//
+// Task-graph factorizations:
+//
+
+
+// These functions give the same results as 'cholesky_decomposition', 'lu_decomposition'
+// and 'qr_decomposition' (up to rounding), for large matrices on many processors.
+// The matrix is copied to square tiles and the factorization is run as a graph of
+// tasks, each one working on a few tiles, that start as soon as the tiles they
+// use are ready, so the factorization of a panel overlaps the update of the rest
+// of the matrix by the previous one and no thread waits for the end of a step.
+// The threads take the tasks from each other when they have none. The order of
+// the tiles and the number of threads are the tuning parameters 'dag_tile' and
+// 'dag_workers' (see 'linalg_init').
+
+// Calculates the Cholesky decomposition of a symmetric positive definite matrix,
+// as 'cholesky_decomposition'.
+//
+Matrix* dag_cholesky_decomposition(Matrix *mat);
+
+// Transforms a square matrix into its LU decomposition with partial pivoting, as
+// 'lu_decomposition', with the rows of 'L * U' in the order of 'perm'.
+// Returns '1' or '-1', the sign of the permutation, or '0' if the matrix is
+// singular; in that case the matrix is not changed.
+//
+int dag_lu_decomposition(Matrix *mat, int *perm);
+
+// Calculates the QR decomposition of a matrix with at least as many rows as columns,
+// as 'qr_decomposition'. The columns of tiles are reduced by reflections that join
+// each tile below the diagonal to the triangle above it.
+//
+void dag_qr_decomposition(Matrix *mat, Matrix **q, Matrix **r);
+
+
+//
+// Updates of factorizations:
+//
+
+
+// When a matrix 'A' changes by a matrix of low rank, 'A + u * transpose(v)',
+// where 'u' and 'v' are 'n x k' matrices ('k' columns of rank 1), these functions
+// update its inverse or factors in O(k * n^2) operations instead of calculating
+// them again in O(n^3). A row 'i' of 'A' changes by 'd' with 'u' equal to the
+// column 'i' of the identity and 'v' equal to 'd', and a column in the same way.
+// The errors of the updates accumulate, so the factors should be calculated again
+// after many of them. Each function returns '1' on success and '0' for NULL or
+// incompatible matrices or when noted.
+
+// Updates the inverse of 'A', 'inv', to the inverse of 'A + u * transpose(v)', by
+// the Sherman-Morrison-Woodbury formula. 'inv' is not changed if the updated
+// matrix is singular, which returns '0'.
+//
+int over_inverse_update(Matrix *inv, Matrix *u, Matrix *v);
+
+// Updates a LU decomposition given by 'lu_decomposition' (or 'dag_lu_decomposition')
+// to that of 'A + u * transpose(v)', by Bennett's algorithm, with the same
+// permutation. The updated factors have no new pivoting, so they may lose accuracy
+// if the pivots become small; the function returns '0' if one becomes zero and
+// the decomposition must be calculated again, since 'lu' is then left partly
+// updated. An invalid permutation also returns '0', with 'lu' unchanged.
+//
+int over_lu_update(Matrix *lu, int *perm, Matrix *u, Matrix *v);
+
+// Updates the Cholesky factor 'l' of 'A' (see 'cholesky_decomposition') to that of
+// 'A + x * transpose(x)'.
+//
+int over_cholesky_update(Matrix *l, Matrix *x);
+
+// Updates the Cholesky factor 'l' of 'A' to that of 'A - x * transpose(x)'.
+// Returns '0' if that matrix is not positive definite, and the factor must be
+// calculated again.
+//
+int over_cholesky_downdate(Matrix *l, Matrix *x);
+
+// Updates the QR decomposition of a square matrix 'A' (see 'qr_decomposition')
+// to that of 'A + u * transpose(v)', by Givens rotations.
+//
+int over_qr_update(Matrix *q, Matrix *r, Matrix *u, Matrix *v);
+
+
+//
+// Factorization cache:
+//
+
+
+// Counters of the factorization cache
+//
+typedef struct factor_cache_stats
+{
+    long long hits;                     // Calls that found the decomposition in the cache
+
+    long long misses;
+
+    long long evictions;                // Decompositions removed to make room for others
+
+    long long entries;
+
+    long long bytes;                    // Memory used by the decompositions
+
+    long long budget;
+} FactorCacheStats;
+
+// Enables a cache of the LU decompositions calculated by 'determinant',
+// 'inverse_matrix' and 'solve_system' (of the coefficients, without the last
+// column), so that repeated calls for the same matrix skip the elimination.
+// The matrices are found by a hash of their dimensions and elements and then
+// compared element by element, so a cached decomposition is only used for an
+// identical matrix. A matrix that has not changed since its decomposition was
+// found (see 'matrix_version') skips the comparison, so the elements written
+// directly, through 'matrix_row_pointer' or the buffer of 'wrap_matrix', must
+// be reported with 'matrix_changed'. Each decomposition takes about '16 * n^2'
+// bytes; the least recently used ones are removed to keep the cache within
+// 'budget' bytes.
+// A budget of zero (the default) disables the cache and frees it.
+// With the cache, these functions use the decomposition with partial pivoting,
+// so their results may differ from those without it by rounding errors.
+// The cache can be used by several threads.
+//
+void linalg_factor_cache(long long budget);
+
+// Copies the counters of the factorization cache into 'stats'.
+//
+void factor_cache_stats(FactorCacheStats *stats);
+
+// Removes all decompositions from the factorization cache and clears its counters.
+// The budget is kept.
+//
+void factor_cache_clear(void);
+
+
+//
+// Streaming input and output:
+//
+
+
+// Matrices are read and written by blocks of rows, so files larger than the
+// memory can be processed. Text files have the format of 'get_matrix', with the
+// elements written with 17 significant digits so that they are read back exactly;
+// binary files hold the rows of doubles in the byte order of the machine. The
+// files are given open ('fdopen' gives one for a file descriptor) and are not
+// closed by these functions.
+
+// Type of the function called with each block of rows read by 'stream_matrix':
+// the first 'rows' rows of 'block' are the rows 'first' to 'first + rows - 1' of
+// the matrix. It returns '0' to go on, or another value to stop the reading.
+//
+typedef int (*RowBlockVisitor)(Matrix *block, int first, int rows, void *data);
+
+// Starts reading a matrix from a file, in text or binary (found by its first
+// byte), reading its dimensions.
+// Returns NULL if the file is NULL or does not hold a matrix.
+//
+MatrixReader* open_matrix_reader(FILE *filin);
+
+// Give the dimensions of the matrix being read.
+// A NULL reader returns '0'.
+//
+int matrix_reader_row_number(MatrixReader *rd);
+
+int matrix_reader_column_number(MatrixReader *rd);
+
+// Reads the next rows of the matrix into 'block', which must have its number of
+// columns, filling as many rows of the block as there are left.
+// Returns the number of rows read, '0' after the last row, or '-1' for invalid
+// arguments or errors reading the file.
+//
+int read_matrix_rows(MatrixReader *rd, Matrix *block);
+
+// Reads the rest of the matrix by blocks of 'block_rows' rows, calling 'visit'
+// with each one; only one block is in memory at a time.
+// Returns '1' if all the rows were read, or '0' for invalid arguments, errors
+// reading the file or if 'visit' stopped the reading.
+//
+int stream_matrix(MatrixReader *rd, int block_rows, RowBlockVisitor visit, void *data);
+
+// Function of type 'RowBlockReader' that reads the rows from a reader given as
+// 'data', so that 'randomized_svd_stream' can work on a file. Reading rows before
+// the last ones read starts the file again, which needs a file that can be
+// repositioned.
+//
+int matrix_reader_block(Matrix *block, int first, int rows, void *data);
+
+// Deallocates memory previously used for a reader. The file is not closed.
+//
+void free_matrix_reader(MatrixReader *rd);
+
+// Starts writing an 'm x n' matrix to a file, in binary if 'binary' is not zero
+// and in text otherwise. Text is kept in a buffer of the writer and written in
+// large pieces.
+// Returns NULL if the file is NULL or the dimensions are not positive.
+//
+MatrixWriter* open_matrix_writer(FILE *filout, int m, int n, int binary);
+
+// Writes the first 'rows' rows of 'block' as the next rows of the matrix.
+// Returns '1' on success, or '0' for invalid arguments (more rows than the matrix
+// has left) or errors writing the file.
+//
+int write_matrix_rows(MatrixWriter *wr, Matrix *block, int rows);
+
+// Writes what is left in the buffer of a writer and deallocates it. The file is
+// flushed but not closed.
+// Returns '1' if the whole matrix was written without errors, and '0' otherwise.
+//
+int free_matrix_writer(MatrixWriter *wr);
+
+// Saves a matrix in a file (replacing it), in binary if 'binary' is not zero and
+// in text otherwise. Both can be read by 'get_matrix'.
+// Returns '1' on success, and '0' otherwise.
+//
+int save_matrix(Matrix *mat, char *name, int binary);
+
+
+//
+// Compressed matrices:
+//
+
+
+// Compressed files keep a matrix in chunks of 'chunk_rows' rows, each one
+// compressed separately, with an index of the chunks at the end, so that rows
+// can be read without decompressing the whole file. The bytes of the doubles are
+// shuffled before the compression with zlib, at a 'level' from 1 (fastest) to 9
+// (smallest); at level 0, or if the library was built without zlib, the chunks
+// are only shuffled. The chunks are compressed and decompressed in parallel.
+// Chunks of a few hundred kilobytes ('chunk_rows * columns * 8' bytes) give good
+// compression and random access.
+
+// Saves a matrix in a compressed file (replacing it).
+// Returns '1' on success, and '0' for invalid arguments or errors writing the file.
+//
+int save_compressed_matrix(Matrix *mat, char *name, int chunk_rows, int level);
+
+// Converts a matrix file of 'get_matrix' (text or binary) into a compressed
+// file, reading it by blocks of rows, so it may be larger than the memory.
+// Returns '1' on success, and '0' otherwise.
+//
+int compress_matrix_file(char *src, char *dst, int chunk_rows, int level);
+
+// Loads a compressed matrix in memory; 'get_matrix' also does it.
+// Returns NULL if the file cannot be read, does not hold a compressed matrix or
+// was compressed with zlib and the library was built without it.
+//
+Matrix* get_compressed_matrix(char *name);
+
+// Opens a compressed matrix for reading blocks of rows.
+// Returns NULL if the file cannot be opened or does not hold a compressed matrix.
+//
+CompressedMatrix* open_compressed_matrix(char *name);
+
+// Function of type 'RowBlockReader' that reads the rows from a compressed matrix
+// given as 'data', decompressing only the chunks with those rows (the last one is
+// kept for the next call). It can be used with 'randomized_svd_stream'.
+//
+int compressed_matrix_block(Matrix *block, int first, int rows, void *data);
+
+// Give the dimensions of a compressed matrix.
+// A NULL matrix returns '0'.
+//
+int compressed_matrix_row_number(CompressedMatrix *cm);
+
+int compressed_matrix_column_number(CompressedMatrix *cm);
+
+// Closes a compressed matrix and deallocates its memory.
+//
+void free_compressed_matrix(CompressedMatrix *cm);
+
+
+//
+// Banded and tridiagonal systems:
+//
+
+
+// Band matrices keep only the 'kl' diagonals below the main one, the main one and
+// the 'ku' above it of a square matrix of order 'n', with 'O(n * (2 * kl + ku))'
+// memory, and their systems are solved in 'O(n * kl * (kl + ku))' operations
+// instead of 'O(n^3)'. The positions are counted from zero, as in 'insert_in_matrix'.
+
+// Creates an 'n x n' band matrix of zeros with 'kl' lower and 'ku' upper diagonals.
+// Returns NULL if 'n' is not positive or 'kl' or 'ku' are negative or not smaller than 'n'.
+//
+BandMatrix* create_band_matrix(int n, int kl, int ku);
+
+// Deallocates memory previously used for a band matrix.
+//
+void free_band_matrix(BandMatrix *band);
+
+// Inserts a value in a band matrix in a given position, which must be in the band.
+//
+void insert_in_band_matrix(double a, BandMatrix *band, int i, int j);
+
+// Gets a value in a band matrix from a given position.
+// Positions outside the band give '0'. If the position does not exist or the
+// matrix is NULL, the function returns '0'.
+//
+double get_from_band_matrix(BandMatrix *band, int i, int j);
+
+// Copies the band of 'kl' lower and 'ku' upper diagonals of a square matrix; the
+// elements outside it are not used.
+// Returns NULL if the matrix is NULL or not square or the band is invalid.
+//
+BandMatrix* matrix_to_band_matrix(Matrix *mat, int kl, int ku);
+
+// Copies a band matrix as a usual matrix.
+// Returns NULL if the given matrix is NULL.
+//
+Matrix* band_matrix_to_matrix(BandMatrix *band);
+
+// Multiplies a band matrix by an array and saves the result as a new array.
+// Returns NULL if the matrix or the array are NULL or the dimensions are
+// incompatible with a multiplication.
+//
+Array* band_matrix_times_array(BandMatrix *band, Array *arr);
+
+// Transforms a band matrix into its LU decomposition with partial pivoting,
+// searching the pivots within the band. 'U' has 'ku + kl' upper diagonals, which
+// fit in the matrix, and 'L' has 'kl' lower ones. Unlike 'lu_decomposition', the
+// rows are swapped as the columns are eliminated: 'piv[k]' (an array of 'n'
+// elements) receives the row swapped with row 'k' at step 'k', and the previous
+// columns of 'L' are not swapped; 'over_band_lu_solve' applies them in order.
+// Returns '1' or '-1', the sign of the permutation, or '0' if the matrix is singular.
+//
+int band_lu_decomposition(BandMatrix *band, int *piv);
+
+// Solves a system given the LU decomposition of its band matrix, calculated by
+// 'band_lu_decomposition', overwriting the right side 'b' with the solution.
+//
+void over_band_lu_solve(BandMatrix *lu, int *piv, Array *b);
+
+// Solves the system 'band * x = b' with the LU decomposition with partial
+// pivoting, keeping the band matrix, and returns 'x' as a new array.
+// Returns NULL if the system has no single solution.
+//
+Array* solve_band_system(BandMatrix *band, Array *b);
+
+// Solves a tridiagonal system by the Thomas algorithm, in 'O(n)' operations.
+// 'sub', 'diag' and 'sup' have 'n' elements: row 'i' of the matrix has 'sub[i]',
+// 'diag[i]' and 'sup[i]' in columns 'i - 1', 'i' and 'i + 1' ('sub[0]' and
+// 'sup[n - 1]' are not used). There is no pivoting, which is stable for
+// diagonally dominant or symmetric positive definite matrices; other systems can
+// be solved by 'solve_band_system' with 'kl = ku = 1'.
+// Returns the solution as a new array, or NULL if a pivot is zero.
+//
+Array* tridiagonal_solve(Array *sub, Array *diag, Array *sup, Array *b);
+
+// Solves many independent tridiagonal systems of the same order by the Thomas
+// algorithm, each in a column of the 'n x count' matrices: column 's' of 'sub',
+// 'diag' and 'sup' holds the diagonals of system 's', as in 'tridiagonal_solve',
+// and column 's' of 'b' its right side, overwritten with the solution. Each step
+// works on a row of all the systems, so the operations are vectorized, and blocks
+// of systems are solved in parallel (see 'batch_parallel' in 'linalg_init').
+// Returns '1' on success, or '0' for invalid arguments or if a pivot was zero
+// (the solutions of those systems are then infinite or not a number).
+//
+int batch_tridiagonal_solve(Matrix *sub, Matrix *diag, Matrix *sup, Matrix *b);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,799 @@
+// C++ interface of the linalg library.
+//
+// 'linalg::Array' and 'linalg::Matrix' own an 'Array' or 'Matrix' of the C
+// library and free it when they go out of scope. They are moved without
+// copying the elements, so results returned by value cost no copy, and the
+// operators that take a temporary reuse its storage:
+//
+//     linalg::Matrix d = a * b + c;       // Only the product is allocated.
+//
+// In-place operators ('+=', '-=', '*=' by a number) and the functions that
+// write into a given result ('multiply', 'add', 'subtract', 'transpose') do not
+// allocate when the result already has the right dimensions, so allocations
+// can be hoisted out of loops:
+//
+//     linalg::Matrix c(n, n);
+//
+//     for (...)
+//         linalg::multiply(a, b, c);       // Reuses 'c'.
+//
+// Invalid arguments (NULL objects, incompatible dimensions) throw
+// 'std::invalid_argument' instead of returning NULL.
+//
+// 'linalg::FixedMatrix<T, M, N>' is a matrix of dimensions known at compile
+// time, kept in the object itself (on the stack) and without calls to the C
+// library, for small transforms (2x2 to about 6x6). Its operations can be used
+// in constant expressions.
+//
+// Rows and arrays are also seen as 'std::span' (C++20). Mutable views, element
+// references and 'data()' count as a change of the object for 'array_version'
+// and 'matrix_version' when they are taken, so the values that the library
+// keeps for an unchanged object (norms, determinant, decompositions) are not
+// reused afterwards; a view kept across calls to the library must be taken again
+// after them.
+//
+
+
+#ifndef LINALG_HPP
+#define LINALG_HPP
+
+#include <cmath>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "linalg.h"
+
+namespace linalg
+{
+
+inline void check(bool condition, const char *message)     // Throws for invalid arguments.
+{
+    if (!condition)
+        throw std::invalid_argument(message);
+}
+
+class Array
+{
+public:
+    Array() noexcept = default;                             // Empty array, without elements
+
+    explicit Array(int len) : p_(::create_array(len))       // Array of 'len' zeros
+    {
+        check(p_ != nullptr, "linalg::Array: invalid length");
+    }
+
+    Array(std::initializer_list<double> values) : Array((int) values.size())
+    {
+        ::set_array_buffer(p_, const_cast<double*>(values.begin()));
+    }
+
+    static Array uninitialized(int len)                     // Array whose elements will all be written next
+    {
+        return adopt(::create_array_uninitialized(len));
+    }
+
+    // Array that uses a buffer of the caller without copying it; the buffer must
+    // remain valid while the array exists, and is not freed by it.
+    static Array wrap(double *buffer, int len)
+    {
+        return adopt(::wrap_array(buffer, len, nullptr));
+    }
+
+    static Array adopt(::Array *arr)                        // Takes the ownership of an array of the C library.
+    {
+        Array result;
+
+        check(arr != nullptr, "linalg::Array: NULL array");
+
+        result.p_ = arr;
+
+        return result;
+    }
+
+    Array(const Array &other) : p_(other.p_ ? ::copy_array(other.p_) : nullptr) {}
+
+    Array(Array &&other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+
+    Array& operator=(const Array &other)                    // Reuses the storage if the lengths are the same.
+    {
+        if (this == &other)
+            return *this;
+
+        if (p_ != nullptr && other.p_ != nullptr && size() == other.size())
+            ::over_copy_array(other.p_, p_);
+        else
+            *this = Array(other);
+
+        return *this;
+    }
+
+    Array& operator=(Array &&other) noexcept
+    {
+        std::swap(p_, other.p_);
+
+        return *this;
+    }
+
+    ~Array() { ::free_array(p_); }
+
+    ::Array* get() const noexcept { return p_; }            // Array of the C library, still owned by this object
+
+    ::Array* release() noexcept { return std::exchange(p_, nullptr); }
+
+    bool empty() const noexcept { return p_ == nullptr; }
+
+    int size() const noexcept { return ::length_of_array(p_); }
+
+    unsigned long long version() const noexcept { return ::array_version(p_); }
+
+    double operator[](int i) const { return ::array_pointer(p_)[i]; }
+
+    double& operator[](int i)
+    {
+        ::array_changed(p_);
+
+        return ::array_pointer(p_)[i];
+    }
+
+    double* data()
+    {
+        ::array_changed(p_);
+
+        return ::array_pointer(p_);
+    }
+
+    const double* data() const { return ::array_pointer(p_); }
+
+    std::span<double> span() { return {data(), (size_t) size()}; }
+
+    std::span<const double> span() const { return {data(), (size_t) size()}; }
+
+    Array& operator+=(const Array &other)
+    {
+        check(size() == other.size(), "linalg::Array: incompatible lengths");
+
+        ::over_sum_array(p_, other.p_);
+
+        return *this;
+    }
+
+    Array& operator-=(const Array &other)
+    {
+        check(size() == other.size(), "linalg::Array: incompatible lengths");
+
+        ::over_subtract_array(p_, other.p_);
+
+        return *this;
+    }
+
+    Array& operator*=(double num)
+    {
+        check(p_ != nullptr, "linalg::Array: empty array");
+
+        ::over_rnumber_times_array(num, p_);
+
+        return *this;
+    }
+
+private:
+    ::Array *p_ = nullptr;
+};
+
+class Matrix
+{
+public:
+    Matrix() noexcept = default;                            // Empty matrix, without elements
+
+    Matrix(int m, int n) : p_(::create_matrix(m, n))        // Matrix 'm x n' of zeros
+    {
+        check(p_ != nullptr, "linalg::Matrix: invalid dimensions");
+    }
+
+    Matrix(std::initializer_list<std::initializer_list<double>> rows)   // Matrix given by rows
+        : Matrix((int) rows.size(), rows.size() ? (int) rows.begin()->size() : 0)
+    {
+        int i = 0;
+
+        for (const auto &row : rows)
+        {
+            check((int) row.size() == cols(), "linalg::Matrix: rows of different lengths");
+
+            ::set_matrix_row(p_, i++, const_cast<double*>(row.begin()));
+        }
+    }
+
+    static Matrix uninitialized(int m, int n)               // Matrix whose elements will all be written next
+    {
+        return adopt(::create_matrix_uninitialized(m, n));
+    }
+
+    static Matrix identity(int ord) { return adopt(::create_identity_matrix(ord)); }
+
+    // Matrix whose rows are in a buffer of the caller, the row 'i' starting at
+    // 'buffer + i * stride'; see 'wrap_matrix'. The buffer is not freed by it.
+    static Matrix wrap(double *buffer, int m, int n, int stride)
+    {
+        return adopt(::wrap_matrix(buffer, m, n, stride, nullptr));
+    }
+
+    static Matrix adopt(::Matrix *mat)                      // Takes the ownership of a matrix of the C library.
+    {
+        Matrix result;
+
+        check(mat != nullptr, "linalg::Matrix: NULL matrix");
+
+        result.p_ = mat;
+
+        return result;
+    }
+
+    Matrix(const Matrix &other) : p_(other.p_ ? ::copy_matrix(other.p_) : nullptr) {}
+
+    Matrix(Matrix &&other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+
+    Matrix& operator=(const Matrix &other)                  // Reuses the storage if the dimensions are the same.
+    {
+        if (this == &other)
+            return *this;
+
+        if (p_ != nullptr && other.p_ != nullptr && same_shape(other))
+            ::over_copy_matrix(other.p_, p_);
+        else
+            *this = Matrix(other);
+
+        return *this;
+    }
+
+    Matrix& operator=(Matrix &&other) noexcept
+    {
+        std::swap(p_, other.p_);
+
+        return *this;
+    }
+
+    ~Matrix() { ::free_matrix(p_); }
+
+    ::Matrix* get() const noexcept { return p_; }           // Matrix of the C library, still owned by this object
+
+    ::Matrix* release() noexcept { return std::exchange(p_, nullptr); }
+
+    bool empty() const noexcept { return p_ == nullptr; }
+
+    int rows() const noexcept { return ::matrix_row_number(p_); }
+
+    int cols() const noexcept { return ::matrix_column_number(p_); }
+
+    bool same_shape(const Matrix &other) const noexcept { return rows() == other.rows() && cols() == other.cols(); }
+
+    unsigned long long version() const noexcept { return ::matrix_version(p_); }
+
+    double operator()(int i, int j) const { return ::matrix_row_pointer(p_, i)[j]; }
+
+    double& operator()(int i, int j)
+    {
+        ::matrix_changed(p_);
+
+        return ::matrix_row_pointer(p_, i)[j];
+    }
+
+    std::span<double> row(int i)                            // Row 'i'; rows are not contiguous with each other.
+    {
+        double *r = ::matrix_row_pointer(p_, i);
+
+        check(r != nullptr, "linalg::Matrix: invalid row");
+
+        ::matrix_changed(p_);
+
+        return {r, (size_t) cols()};
+    }
+
+    std::span<const double> row(int i) const
+    {
+        double *r = ::matrix_row_pointer(p_, i);
+
+        check(r != nullptr, "linalg::Matrix: invalid row");
+
+        return {r, (size_t) cols()};
+    }
+
+    void set_row(int i, std::span<const double> values)
+    {
+        check(p_ != nullptr && (int) values.size() == cols() && i >= 0 && i < rows(), "linalg::Matrix: invalid row");
+
+        ::set_matrix_row(p_, i, const_cast<double*>(values.data()));
+    }
+
+    void set_buffer(std::span<const double> values)         // All the elements, by rows
+    {
+        check(p_ != nullptr && (long long) values.size() == (long long) rows() * cols(), "linalg::Matrix: invalid buffer size");
+
+        ::set_matrix_buffer(p_, const_cast<double*>(values.data()));
+    }
+
+    void get_buffer(std::span<double> values) const
+    {
+        check(p_ != nullptr && (long long) values.size() == (long long) rows() * cols(), "linalg::Matrix: invalid buffer size");
+
+        ::get_matrix_buffer(p_, values.data());
+    }
+
+    Matrix& operator+=(const Matrix &other)
+    {
+        check(p_ != nullptr && same_shape(other), "linalg::Matrix: incompatible dimensions");
+
+        ::over_sum_matrix(p_, other.p_);
+
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix &other)
+    {
+        check(p_ != nullptr && same_shape(other), "linalg::Matrix: incompatible dimensions");
+
+        ::over_subtract_matrix(p_, other.p_);
+
+        return *this;
+    }
+
+    Matrix& operator*=(double num)
+    {
+        check(p_ != nullptr, "linalg::Matrix: empty matrix");
+
+        ::over_rnumber_times_matrix(num, p_);
+
+        return *this;
+    }
+
+private:
+    ::Matrix *p_ = nullptr;
+};
+
+
+// Operations with a new result. Those that take a temporary write into it.
+
+inline Array operator+(const Array &a, const Array &b)
+{
+    check(a.size() == b.size() && !a.empty(), "linalg::Array: incompatible lengths");
+
+    return Array::adopt(::sum_array(a.get(), b.get()));
+}
+
+inline Array operator+(Array &&a, const Array &b) { a += b; return std::move(a); }
+
+inline Array operator+(const Array &a, Array &&b) { b += a; return std::move(b); }
+
+inline Array operator-(const Array &a, const Array &b)
+{
+    check(a.size() == b.size() && !a.empty(), "linalg::Array: incompatible lengths");
+
+    return Array::adopt(::subtract_array(a.get(), b.get()));
+}
+
+inline Array operator-(Array &&a, const Array &b) { a -= b; return std::move(a); }
+
+inline Array operator*(double num, const Array &a) { return Array::adopt(::rnumber_times_array(num, a.get())); }
+
+inline Array operator*(double num, Array &&a) { a *= num; return std::move(a); }
+
+inline Matrix operator+(const Matrix &a, const Matrix &b)
+{
+    check(a.same_shape(b) && !a.empty(), "linalg::Matrix: incompatible dimensions");
+
+    return Matrix::adopt(::sum_matrix(a.get(), b.get()));
+}
+
+inline Matrix operator+(Matrix &&a, const Matrix &b) { a += b; return std::move(a); }
+
+inline Matrix operator+(const Matrix &a, Matrix &&b) { b += a; return std::move(b); }
+
+inline Matrix operator-(const Matrix &a, const Matrix &b)
+{
+    check(a.same_shape(b) && !a.empty(), "linalg::Matrix: incompatible dimensions");
+
+    return Matrix::adopt(::subtract_matrix(a.get(), b.get()));
+}
+
+inline Matrix operator-(Matrix &&a, const Matrix &b) { a -= b; return std::move(a); }
+
+inline Matrix operator*(double num, const Matrix &a) { return Matrix::adopt(::rnumber_times_matrix(num, a.get())); }
+
+inline Matrix operator*(double num, Matrix &&a) { a *= num; return std::move(a); }
+
+inline Matrix operator*(const Matrix &a, const Matrix &b)
+{
+    check(a.cols() == b.rows() && !a.empty(), "linalg::Matrix: incompatible dimensions");
+
+    return Matrix::adopt(::matrix_times_matrix(a.get(), b.get()));
+}
+
+inline Array operator*(const Matrix &a, const Array &x)
+{
+    check(a.cols() == x.size() && !a.empty(), "linalg::Matrix: incompatible dimensions");
+
+    return Array::adopt(::matrix_times_array(a.get(), x.get()));
+}
+
+inline Matrix transpose(const Matrix &a) { return Matrix::adopt(::transpose_matrix(a.get())); }
+
+
+// Operations that write into a given result. It is reused if its dimensions are
+// right, and replaced by a new object otherwise. It cannot be an operand.
+
+inline void multiply(const Matrix &a, const Matrix &b, Matrix &c)      // c = a * b
+{
+    check(a.cols() == b.rows() && !a.empty(), "linalg::Matrix: incompatible dimensions");
+    check(&c != &a && &c != &b, "linalg::Matrix: the result cannot be an operand");
+
+    if (c.rows() != a.rows() || c.cols() != b.cols())
+        c = Matrix::uninitialized(a.rows(), b.cols());
+
+    ::matrix_times_matrix_into(a.get(), b.get(), c.get());
+}
+
+inline void multiply(const Matrix &a, const Array &x, Array &y)         // y = a * x
+{
+    check(a.cols() == x.size() && !a.empty(), "linalg::Matrix: incompatible dimensions");
+    check(&y != &x, "linalg::Array: the result cannot be an operand");
+
+    if (y.size() != a.rows())
+        y = Array::uninitialized(a.rows());
+
+    ::gemv(1, a.get(), x.get(), 0, y.get());
+}
+
+inline void add(const Matrix &a, const Matrix &b, Matrix &c)           // c = a + b
+{
+    check(a.same_shape(b) && !a.empty(), "linalg::Matrix: incompatible dimensions");
+
+    if (&c == &b)
+    {
+        c += a;
+
+        return;
+    }
+
+    if (&c != &a)
+        c = a;                                              // Copies into 'c' if it has the same dimensions.
+
+    c += b;
+}
+
+inline void subtract(const Matrix &a, const Matrix &b, Matrix &c)      // c = a - b
+{
+    check(a.same_shape(b) && !a.empty(), "linalg::Matrix: incompatible dimensions");
+    check(&c != &b || &c == &a, "linalg::Matrix: the result cannot be the second operand");
+
+    if (&c != &a)
+        c = a;
+
+    c -= b;
+}
+
+inline void transpose(const Matrix &a, Matrix &t)                      // t = transpose(a)
+{
+    int i, j;
+
+    check(!a.empty(), "linalg::Matrix: empty matrix");
+    check(&t != &a, "linalg::Matrix: the result cannot be the operand");
+
+    if (t.rows() != a.cols() || t.cols() != a.rows())
+        t = Matrix::uninitialized(a.cols(), a.rows());
+
+    for (i = 0; i < t.rows(); i++)
+    {
+        std::span<double> row = t.row(i);
+
+        for (j = 0; j < t.cols(); j++)
+            row[j] = a(j, i);
+    }
+}
+
+
+// Matrices of fixed dimensions:
+
+template <typename T, int M, int N>
+class FixedMatrix
+{
+    static_assert(M > 0 && N > 0, "linalg::FixedMatrix: invalid dimensions");
+
+public:
+    constexpr FixedMatrix() = default;                      // Matrix of zeros
+
+    constexpr FixedMatrix(std::initializer_list<std::initializer_list<T>> rows)     // Matrix given by rows
+    {
+        int i = 0;
+
+        if ((int) rows.size() != M)
+            throw std::invalid_argument("linalg::FixedMatrix: wrong number of rows");
+
+        for (const auto &row : rows)
+        {
+            int j = 0;
+
+            if ((int) row.size() != N)
+                throw std::invalid_argument("linalg::FixedMatrix: wrong number of columns");
+
+            for (const T &v : row)
+                e_[i][j++] = v;
+
+            i++;
+        }
+    }
+
+    explicit FixedMatrix(const Matrix &mat)                 // Copy of a dynamic matrix with the same dimensions
+    {
+        int i, j;
+
+        check(mat.rows() == M && mat.cols() == N, "linalg::FixedMatrix: incompatible dimensions");
+
+        if constexpr (std::is_same_v<T, double>)
+            ::get_matrix_buffer(mat.get(), &e_[0][0]);
+        else
+        {
+            for (i = 0; i < M; i++)
+            {
+                for (j = 0; j < N; j++)
+                    e_[i][j] = (T) mat(i, j);
+            }
+        }
+    }
+
+    static constexpr FixedMatrix identity() requires (M == N)
+    {
+        FixedMatrix result;
+
+        for (int i = 0; i < N; i++)
+            result.e_[i][i] = 1;
+
+        return result;
+    }
+
+    static constexpr int rows() { return M; }
+
+    static constexpr int cols() { return N; }
+
+    constexpr T& operator()(int i, int j) { return e_[i][j]; }
+
+    constexpr const T& operator()(int i, int j) const { return e_[i][j]; }
+
+    constexpr T& operator[](int i) requires (N == 1) { return e_[i][0]; }      // Elements of vectors (one column)
+
+    constexpr const T& operator[](int i) const requires (N == 1) { return e_[i][0]; }
+
+    T* data() { return &e_[0][0]; }                         // Elements by rows, contiguous
+
+    const T* data() const { return &e_[0][0]; }
+
+    Matrix to_matrix() const                                // Dynamic matrix with the same elements
+    {
+        int i, j;
+        Matrix mat = Matrix::uninitialized(M, N);
+
+        if constexpr (std::is_same_v<T, double>)
+            ::set_matrix_buffer(mat.get(), const_cast<double*>(data()));
+        else
+        {
+            for (i = 0; i < M; i++)
+            {
+                for (j = 0; j < N; j++)
+                    mat(i, j) = (double) e_[i][j];
+            }
+        }
+
+        return mat;
+    }
+
+    constexpr FixedMatrix& operator+=(const FixedMatrix &other)
+    {
+        each([&](int i, int j) { e_[i][j] += other.e_[i][j]; }, std::make_integer_sequence<int, M * N>());
+
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator-=(const FixedMatrix &other)
+    {
+        each([&](int i, int j) { e_[i][j] -= other.e_[i][j]; }, std::make_integer_sequence<int, M * N>());
+
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator*=(T num)
+    {
+        each([&](int i, int j) { e_[i][j] *= num; }, std::make_integer_sequence<int, M * N>());
+
+        return *this;
+    }
+
+    constexpr bool operator==(const FixedMatrix &other) const = default;
+
+    // Calls 'f(i, j)' for every element, unrolled.
+    template <typename F, int... K>
+    static constexpr void each(F f, std::integer_sequence<int, K...>)
+    {
+        (f(K / N, K % N), ...);
+    }
+
+private:
+    T e_[M][N] {};
+};
+
+template <typename T, int N>
+using FixedVector = FixedMatrix<T, N, 1>;
+
+template <typename T, int M, int N>
+constexpr FixedMatrix<T, M, N> operator+(FixedMatrix<T, M, N> a, const FixedMatrix<T, M, N> &b) { return a += b; }
+
+template <typename T, int M, int N>
+constexpr FixedMatrix<T, M, N> operator-(FixedMatrix<T, M, N> a, const FixedMatrix<T, M, N> &b) { return a -= b; }
+
+template <typename T, int M, int N>
+constexpr FixedMatrix<T, M, N> operator*(T num, FixedMatrix<T, M, N> a) { return a *= num; }
+
+template <typename T, int M, int K, int N>
+constexpr FixedMatrix<T, M, N> operator*(const FixedMatrix<T, M, K> &a, const FixedMatrix<T, K, N> &b)     // Product, unrolled
+{
+    FixedMatrix<T, M, N> c;
+
+    auto dot = [&]<int... L>(int i, int j, std::integer_sequence<int, L...>) { return (T(0) + ... + (a(i, L) * b(L, j))); };
+
+    c.each([&](int i, int j) { c(i, j) = dot(i, j, std::make_integer_sequence<int, K>()); }, std::make_integer_sequence<int, M * N>());
+
+    return c;
+}
+
+template <typename T, int M, int N>
+constexpr FixedMatrix<T, N, M> transpose(const FixedMatrix<T, M, N> &a)
+{
+    FixedMatrix<T, N, M> t;
+
+    a.each([&](int i, int j) { t(j, i) = a(i, j); }, std::make_integer_sequence<int, M * N>());
+
+    return t;
+}
+
+template <typename T, int N>
+constexpr T scalar_product(const FixedVector<T, N> &a, const FixedVector<T, N> &b)
+{
+    return [&]<int... L>(std::integer_sequence<int, L...>) { return (T(0) + ... + (a[L] * b[L])); }(std::make_integer_sequence<int, N>());
+}
+
+template <typename T>
+constexpr FixedVector<T, 3> vector_product(const FixedVector<T, 3> &a, const FixedVector<T, 3> &b)    // As 'vector_product'
+{
+    FixedVector<T, 3> prod;
+
+    prod[0] = a[1] * b[2] - a[2] * b[1];
+
+    prod[1] = a[2] * b[0] - a[0] * b[2];
+
+    prod[2] = a[0] * b[1] - a[1] * b[0];
+
+    return prod;
+}
+
+template <typename T>
+constexpr T abs_la(T x) { return (x < 0) ? - x : x; }      // 'std::abs' is not 'constexpr' before C++23.
+
+// Gaussian elimination with partial pivoting of 'a', doing the same operations
+// on the columns of 'b', until 'a' is upper triangular; with 'reduce', it goes on
+// until 'a' is the identity and 'b' the solution. Returns the sign of the row
+// permutation, or '0' if a pivot is zero: as in the C library, a matrix is
+// singular when its elimination finds a column of zeros.
+template <typename T, int N, int K>
+constexpr int eliminate_la(FixedMatrix<T, N, N> &a, FixedMatrix<T, N, K> &b, bool reduce)
+{
+    int i, j, k, piv, sign = 1;
+    T fctr, tmp;
+
+    for (k = 0; k < N; k++)
+    {
+        piv = k;
+
+        for (i = k + 1; i < N; i++)
+        {
+            if (abs_la(a(i, k)) > abs_la(a(piv, k)))
+                piv = i;
+        }
+
+        if (a(piv, k) == T(0))
+            return 0;
+
+        if (piv != k)
+        {
+            for (j = 0; j < N; j++)
+            {
+                tmp = a(k, j); a(k, j) = a(piv, j); a(piv, j) = tmp;
+            }
+
+            for (j = 0; j < K; j++)
+            {
+                tmp = b(k, j); b(k, j) = b(piv, j); b(piv, j) = tmp;
+            }
+
+            sign = - sign;
+        }
+
+        for (i = reduce ? 0 : k + 1; i < N; i++)
+        {
+            if (i == k || a(i, k) == T(0))
+                continue;
+
+            fctr = a(i, k) / a(k, k);
+
+            for (j = k; j < N; j++)
+                a(i, j) -= fctr * a(k, j);
+
+            for (j = 0; j < K; j++)
+                b(i, j) -= fctr * b(k, j);
+        }
+    }
+
+    if (reduce)
+    {
+        for (i = 0; i < N; i++)
+        {
+            for (j = 0; j < K; j++)
+                b(i, j) /= a(i, i);
+        }
+    }
+
+    return sign;
+}
+
+template <typename T, int N>
+constexpr T determinant(const FixedMatrix<T, N, N> &a)     // As 'determinant'
+{
+    if constexpr (N == 1)
+        return a(0, 0);
+    else if constexpr (N == 2)
+        return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    else if constexpr (N == 3)
+        return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+             - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0))
+             + a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+    else
+    {
+        FixedMatrix<T, N, N> u = a;
+        FixedMatrix<T, N, 1> none;
+        T det = eliminate_la(u, none, false);
+
+        for (int i = 0; i < N && det != T(0); i++)
+            det *= u(i, i);
+
+        return det;
+    }
+}
+
+template <typename T, int N>
+constexpr std::optional<FixedMatrix<T, N, N>> inverse(const FixedMatrix<T, N, N> &a)   // As 'inverse_matrix': empty if there is no inverse.
+{
+    FixedMatrix<T, N, N> u = a, inv = FixedMatrix<T, N, N>::identity();
+
+    if (eliminate_la(u, inv, true) == 0)
+        return std::nullopt;
+
+    return inv;
+}
+
+// Solves 'a * x = b' for each column of 'b', as 'solve_system' with the augmented
+// matrix '[a | b]'. Empty if the system has no single solution.
+template <typename T, int N, int K>
+constexpr std::optional<FixedMatrix<T, N, K>> solve(const FixedMatrix<T, N, N> &a, const FixedMatrix<T, N, K> &b)
+{
+    FixedMatrix<T, N, N> u = a;
+    FixedMatrix<T, N, K> x = b;
+
+    if (eliminate_la(u, x, true) == 0)
+        return std::nullopt;
+
+    return x;
+}
+
+
+} // namespace linalg
+
+#endif
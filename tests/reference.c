@@ -0,0 +1,250 @@
+// Naive reference kernels used to check the functions of the linalg library.
+//
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "reference.h"
+
+void ref_matrix_times_matrix(const double *a, const double *b, double *c, int m, int p, int n)
+{
+    int i, j, k;
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            c[i * n + j] = 0;
+
+            for (k = 0; k < p; k++)
+                c[i * n + j] += a[i * p + k] * b[k * n + j];
+        }
+    }
+}
+
+void ref_transpose(const double *a, double *t, int m, int n)
+{
+    int i, j;
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+            t[j * m + i] = a[i * n + j];
+    }
+}
+
+void ref_matrix_times_array(const double *a, const double *x, double *y, int m, int n)
+{
+    int i, j;
+
+    for (i = 0; i < m; i++)
+    {
+        y[i] = 0;
+
+        for (j = 0; j < n; j++)
+            y[i] += a[i * n + j] * x[j];
+    }
+}
+
+void ref_array_times_matrix(const double *x, const double *a, double *y, int m, int n)
+{
+    int i, j;
+
+    for (j = 0; j < n; j++)
+    {
+        y[j] = 0;
+
+        for (i = 0; i < m; i++)
+            y[j] += x[i] * a[i * n + j];
+    }
+}
+
+double ref_scalar_product(const double *a, const double *b, int n)
+{
+    int i;
+    double s = 0;
+
+    for (i = 0; i < n; i++)
+        s += a[i] * b[i];
+
+    return s;
+}
+
+static int ref_elimination(double *a, int m, int n)     // Upper triangular form; returns the sign correction.
+{
+    int i, j, k, corr = 1;
+    double fctr, temp;
+
+    for (i = 0; i < m; i++)
+    {
+        if (a[i * n + i] == 0)
+        {
+            for (k = i + 1; k < m; k++)
+            {
+                if (a[k * n + i] != 0)
+                {
+                    for (j = 0; j < n; j++)
+                    {
+                        temp = a[i * n + j];
+
+                        a[i * n + j] = a[k * n + j];
+
+                        a[k * n + j] = temp;
+                    }
+
+                    corr = - corr;
+
+                    break;
+                }
+            }
+        }
+
+        if (a[i * n + i] == 0)
+            continue;
+
+        for (k = i + 1; k < m; k++)
+        {
+            fctr = - a[k * n + i] / a[i * n + i];
+
+            for (j = i + 1; j < n; j++)
+                a[k * n + j] += fctr * a[i * n + j];
+
+            a[k * n + i] = 0;
+        }
+    }
+
+    return corr;
+}
+
+double ref_determinant(const double *a, int n)
+{
+    int i, corr;
+    double det = 1, *t;
+
+    t = malloc((size_t) n * n * sizeof(double));
+
+    memcpy(t, a, (size_t) n * n * sizeof(double));
+
+    corr = ref_elimination(t, n, n);
+
+    for (i = 0; i < n; i++)
+        det *= t[i * n + i];
+
+    free(t);
+
+    return det * corr;
+}
+
+int ref_inverse(const double *a, double *inv, int n)
+{
+    int i, j, k;
+    double fctr, temp, *t;
+
+    t = malloc((size_t) n * n * sizeof(double));
+
+    memcpy(t, a, (size_t) n * n * sizeof(double));
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            inv[i * n + j] = (i == j);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (t[i * n + i] == 0)
+        {
+            for (k = i + 1; k < n && t[k * n + i] == 0; k++)
+                ;
+
+            if (k == n)
+            {
+                free(t);
+
+                return 0;
+            }
+
+            for (j = 0; j < n; j++)
+            {
+                temp = t[i * n + j]; t[i * n + j] = t[k * n + j]; t[k * n + j] = temp;
+
+                temp = inv[i * n + j]; inv[i * n + j] = inv[k * n + j]; inv[k * n + j] = temp;
+            }
+        }
+
+        fctr = t[i * n + i];
+
+        for (j = 0; j < n; j++)
+        {
+            t[i * n + j] /= fctr;
+
+            inv[i * n + j] /= fctr;
+        }
+
+        for (k = 0; k < n; k++)
+        {
+            if (k == i)
+                continue;
+
+            fctr = - t[k * n + i];
+
+            for (j = 0; j < n; j++)
+            {
+                t[k * n + j] += fctr * t[i * n + j];
+
+                inv[k * n + j] += fctr * inv[i * n + j];
+            }
+        }
+    }
+
+    free(t);
+
+    return 1;
+}
+
+int ref_solve_system(const double *a, double *x, int n)
+{
+    int i, j;
+    double *t;
+
+    t = malloc((size_t) n * (n + 1) * sizeof(double));
+
+    memcpy(t, a, (size_t) n * (n + 1) * sizeof(double));
+
+    ref_elimination(t, n, n + 1);
+
+    for (i = 0; i < n; i++)
+    {
+        if (t[i * (n + 1) + i] == 0)
+        {
+            free(t);
+
+            return 0;
+        }
+    }
+
+    for (i = n - 1; i >= 0; i--)
+    {
+        x[i] = t[i * (n + 1) + n];
+
+        for (j = i + 1; j < n; j++)
+            x[i] -= t[i * (n + 1) + j] * x[j];
+
+        x[i] /= t[i * (n + 1) + i];
+    }
+
+    free(t);
+
+    return 1;
+}
+
+double ref_polynomial(const double *coef, int len, double x)
+{
+    int i;
+    double fx = coef[len - 1];
+
+    for (i = len - 2; i >= 0; i--)
+        fx = fx * x + coef[i];
+
+    return fx;
+}
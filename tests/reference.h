@@ -0,0 +1,45 @@
+// Naive reference kernels used to check the functions of the linalg library.
+//
+// They keep the straightforward algorithms of the first versions of the library
+// and work on plain row-major buffers, independent of the 'Matrix' and 'Array'
+// types, so that optimized kernels can be compared against them.
+//
+
+
+// c (m x n) = a (m x p) * b (p x n)
+//
+void ref_matrix_times_matrix(const double *a, const double *b, double *c, int m, int p, int n);
+
+// t (n x m) = transpose(a (m x n))
+//
+void ref_transpose(const double *a, double *t, int m, int n);
+
+// y (m) = a (m x n) * x (n)
+//
+void ref_matrix_times_array(const double *a, const double *x, double *y, int m, int n);
+
+// y (n) = x (m) * a (m x n)
+//
+void ref_array_times_matrix(const double *x, const double *a, double *y, int m, int n);
+
+// Scalar product of two vectors of length 'n'.
+//
+double ref_scalar_product(const double *a, const double *b, int n);
+
+// Determinant of a 'n x n' matrix by Gaussian elimination with the first non-null pivot.
+//
+double ref_determinant(const double *a, int n);
+
+// Inverse of a 'n x n' matrix by Gauss-Jordan elimination.
+// Returns '0' if the matrix is singular and '1' otherwise.
+//
+int ref_inverse(const double *a, double *inv, int n);
+
+// Solution of the system given by the augmented matrix 'a' (n x (n + 1)).
+// Returns '0' if the system has no single solution and '1' otherwise.
+//
+int ref_solve_system(const double *a, double *x, int n);
+
+// Polynomial with 'len' coefficients ordered by degree evaluated in 'x' by Horner's method.
+//
+double ref_polynomial(const double *coef, int len, double x);
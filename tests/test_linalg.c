@@ -0,0 +1,2088 @@
+// Correctness tests of the linalg library.
+//
+// Each function is checked against the naive reference kernels of 'reference.c'
+// on random, ill-conditioned, singular and edge-size inputs, with tolerances
+// given in units of the machine epsilon. Exact operations (copies, sums,
+// transpositions) must match to the last bit.
+//
+// The tests print one line for each failed check and return a non-zero
+// status if any check failed.
+//
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "linalg.h"
+#include "reference.h"
+
+#define CHECK(cond, ...) do { checks++; if (!(cond)) { failures++; \
+        printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+#define TOL(n) (64.0 * (n) * DBL_EPSILON)              // Relative tolerance for sums of 'n' products
+
+static const int sizes[] = {1, 2, 3, 5, 8, 17, 64, 129};
+
+#define NSIZES ((int) (sizeof(sizes) / sizeof(sizes[0])))
+
+static int checks = 0, failures = 0;
+
+static unsigned long long rnd_state = 88172645463325252ULL;
+
+
+// Helpers:
+
+static double rnd(void)         // Uniform pseudo-random number in [-1, 1).
+{
+    rnd_state ^= rnd_state << 13;
+
+    rnd_state ^= rnd_state >> 7;
+
+    rnd_state ^= rnd_state << 17;
+
+    return (double) (rnd_state >> 11) / 4503599627370496.0 - 1;
+}
+
+static Matrix* random_matrix(int m, int n)
+{
+    int i, j;
+    Matrix *mat = create_matrix(m, n);
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+            insert_in_matrix(rnd(), mat, i, j);
+    }
+
+    return mat;
+}
+
+static Matrix* dominant_matrix(int n)       // Random matrix far from singular.
+{
+    int i;
+    Matrix *mat = random_matrix(n, n);
+
+    for (i = 0; i < n; i++)
+        insert_in_matrix(get_from_matrix(mat, i, i) + n, mat, i, i);
+
+    return mat;
+}
+
+static Matrix* hilbert_matrix(int n)        // Classic ill-conditioned matrix.
+{
+    int i, j;
+    Matrix *mat = create_matrix(n, n);
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            insert_in_matrix(1.0 / (i + j + 1), mat, i, j);
+    }
+
+    return mat;
+}
+
+static Matrix* singular_matrix(int n)       // Random matrix with a null column, singular even after rounding.
+{
+    int i;
+    Matrix *mat = random_matrix(n, n);
+
+    for (i = 0; i < n; i++)
+        insert_in_matrix(0, mat, i, n / 2);
+
+    return mat;
+}
+
+static Array* random_array(int len)
+{
+    int i;
+    Array *arr = create_array(len);
+
+    for (i = 0; i < len; i++)
+        insert_in_array(rnd(), arr, i);
+
+    return arr;
+}
+
+static double* matrix_buffer(Matrix *mat)       // Row-major copy of a matrix.
+{
+    int i, j, m = matrix_row_number(mat), n = matrix_column_number(mat);
+    double *buf = malloc((size_t) m * n * sizeof(double));
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+            buf[i * n + j] = get_from_matrix(mat, i, j);
+    }
+
+    return buf;
+}
+
+static double* array_buffer(Array *arr)
+{
+    int i, len = length_of_array(arr);
+    double *buf = malloc(len * sizeof(double));
+
+    for (i = 0; i < len; i++)
+        buf[i] = get_from_array(arr, i);
+
+    return buf;
+}
+
+static double max_abs(const double *a, int n)
+{
+    int i;
+    double mx = 0;
+
+    for (i = 0; i < n; i++)
+        mx = fmax(mx, fabs(a[i]));
+
+    return mx;
+}
+
+static double rel_error(const double *got, const double *ref, int n)   // Normwise relative error.
+{
+    int i;
+    double err = 0, scale = max_abs(ref, n);
+
+    for (i = 0; i < n; i++)
+        err = fmax(err, fabs(got[i] - ref[i]));
+
+    return (scale > 0) ? err / scale : err;
+}
+
+static double matrix_rel_error(Matrix *got, const double *ref)
+{
+    double *buf = matrix_buffer(got), err;
+
+    err = rel_error(buf, ref, matrix_row_number(got) * matrix_column_number(got));
+
+    free(buf);
+
+    return err;
+}
+
+static double array_rel_error(Array *got, const double *ref)
+{
+    double *buf = array_buffer(got), err;
+
+    err = rel_error(buf, ref, length_of_array(got));
+
+    free(buf);
+
+    return err;
+}
+
+static int same_matrix(Matrix *a, Matrix *b)    // Bitwise equality
+{
+    int i, j;
+
+    if (matrix_row_number(a) != matrix_row_number(b) || matrix_column_number(a) != matrix_column_number(b))
+        return 0;
+
+    for (i = 0; i < matrix_row_number(a); i++)
+    {
+        for (j = 0; j < matrix_column_number(a); j++)
+        {
+            if (get_from_matrix(a, i, j) != get_from_matrix(b, i, j))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+static double identity_error(Matrix *mat)       // Largest difference to the identity matrix.
+{
+    int i, j;
+    double err = 0;
+
+    for (i = 0; i < matrix_row_number(mat); i++)
+    {
+        for (j = 0; j < matrix_column_number(mat); j++)
+            err = fmax(err, fabs(get_from_matrix(mat, i, j) - (i == j)));
+    }
+
+    return err;
+}
+
+
+// Tests:
+
+static void test_access(void)
+{
+    Array *arr = create_array(4);
+    Matrix *mat = create_matrix(2, 3), *id = create_identity_matrix(3);
+
+    CHECK(create_array(0) == NULL && create_matrix(0, 2) == NULL && create_matrix(2, -1) == NULL,
+          "invalid dimensions must give NULL");
+    CHECK(length_of_array(arr) == 4 && length_of_array(NULL) == 0, "length_of_array");
+    CHECK(matrix_row_number(mat) == 2 && matrix_column_number(mat) == 3 && matrix_row_number(NULL) == 0,
+          "matrix dimensions");
+
+    insert_in_array(2.5, arr, 3);
+    insert_in_matrix(-1.5, mat, 1, 2);
+
+    CHECK(get_from_array(arr, 3) == 2.5 && get_from_array(arr, 0) == 0, "array insertion");
+    CHECK(get_from_matrix(mat, 1, 2) == -1.5 && get_from_matrix(mat, 0, 0) == 0, "matrix insertion");
+    CHECK(get_from_array(arr, 4) == 0 && get_from_matrix(mat, 2, 0) == 0, "positions out of range give 0");
+    CHECK(identity_error(id) == 0, "create_identity_matrix");
+
+    free_array(arr);
+    free_matrix(mat);
+    free_matrix(id);
+}
+
+static void test_files(void)
+{
+    char *name = "test_linalg.tmp";
+    FILE *filout;
+    Array *arr;
+    Matrix *mat, *sys;
+
+    filout = fopen(name, "w");
+    fprintf(filout, "3 1.5 -2 4e-3\n");
+    fclose(filout);
+
+    arr = get_array(name);
+    CHECK(length_of_array(arr) == 3 && get_from_array(arr, 2) == 4e-3, "get_array");
+
+    filout = fopen(name, "w");
+    fprintf(filout, "2x3\n1 2 3\n4 5 6.25\n");
+    fclose(filout);
+
+    mat = get_matrix(name);
+    sys = get_system(name);
+    CHECK(matrix_row_number(mat) == 2 && get_from_matrix(mat, 1, 2) == 6.25, "get_matrix");
+    CHECK(same_matrix(mat, sys), "get_system");
+
+    remove(name);
+    free_array(arr);
+    free_matrix(mat);
+    free_matrix(sys);
+}
+
+static void test_copies_and_sums(void)
+{
+    int s, i, n;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+
+        Matrix *a = random_matrix(n, n + 1), *b = random_matrix(n, n + 1), *c, *d;
+        Array *x = random_array(n), *y = random_array(n), *z, *w, *w2;
+
+        c = copy_matrix(a);
+        CHECK(same_matrix(a, c), "copy_matrix, n = %d", n);
+        over_copy_matrix(b, c);
+        CHECK(same_matrix(b, c), "over_copy_matrix, n = %d", n);
+        free_matrix(c);
+
+        c = sum_matrix(a, b);
+        d = subtract_matrix(c, b);
+        for (i = 0; i < n; i++)
+            CHECK(get_from_matrix(c, i, n) == get_from_matrix(a, i, n) + get_from_matrix(b, i, n),
+                  "sum_matrix, n = %d", n);
+        over_subtract_matrix(c, b);
+        CHECK(same_matrix(c, d), "over_subtract_matrix, n = %d", n);
+        over_sum_matrix(c, b);
+        free_matrix(d);
+        d = rnumber_times_matrix(3, a);
+        over_rnumber_times_matrix(3, a);
+        CHECK(same_matrix(a, d), "rnumber_times_matrix, n = %d", n);
+        free_matrix(c);
+        free_matrix(d);
+
+        z = copy_array(x);
+        CHECK(get_from_array(z, n - 1) == get_from_array(x, n - 1), "copy_array, n = %d", n);
+        w = sum_array(x, y);
+        over_sum_array(z, y);
+        CHECK(get_from_array(z, 0) == get_from_array(w, 0) && get_from_array(w, 0) == get_from_array(x, 0) + get_from_array(y, 0),
+              "sum_array, n = %d", n);
+        free_array(w);
+        w = subtract_array(x, y);
+        over_subtract_array(z, y);
+        over_subtract_array(z, y);
+        CHECK(get_from_array(z, n - 1) == get_from_array(w, n - 1), "subtract_array, n = %d", n);
+        free_array(w);
+        w = rnumber_times_array(-2, x);
+        over_rnumber_times_array(-2, x);
+        CHECK(get_from_array(w, 0) == get_from_array(x, 0), "rnumber_times_array, n = %d", n);
+        over_copy_array(y, z);
+        CHECK(get_from_array(z, n - 1) == get_from_array(y, n - 1), "over_copy_array, n = %d", n);
+        w2 = create_array(n + 1);
+        CHECK(sum_array(x, w2) == NULL, "sum_array with different lengths");
+        free_array(w2);
+
+        free_matrix(a);
+        free_matrix(b);
+        free_array(x);
+        free_array(y);
+        free_array(z);
+        free_array(w);
+    }
+}
+
+static void test_products(void)
+{
+    int s, m, n, p;
+    Matrix *za = create_matrix(2, 2), *zb = create_matrix(2, 2), *zc;
+    Array *zx = create_array(2), *zy = create_array(2);
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        m = sizes[s];
+        n = sizes[(s + 3) % NSIZES];
+        p = sizes[(s + 5) % NSIZES];
+
+        Matrix *a = random_matrix(m, p), *b = random_matrix(p, n), *c, *sq = random_matrix(n, n);
+        Array *x = random_array(p), *xt = random_array(m), *y, *z;
+        double *ab = matrix_buffer(a), *bb = matrix_buffer(b), *ref = malloc((size_t) (m + n + p) * (m + n + p) * sizeof(double));
+        double *xb = array_buffer(x), *xtb = array_buffer(xt), *yb;
+
+        c = matrix_times_matrix(a, b);
+        ref_matrix_times_matrix(ab, bb, ref, m, p, n);
+        CHECK(matrix_rel_error(c, ref) <= TOL(p), "matrix_times_matrix, %dx%d * %dx%d", m, p, p, n);
+        free_matrix(c);
+
+        c = transpose_matrix(a);
+        ref_transpose(ab, ref, m, p);
+        CHECK(matrix_rel_error(c, ref) == 0, "transpose_matrix, %dx%d", m, p);
+        free_matrix(c);
+
+        y = matrix_times_array(a, x);
+        ref_matrix_times_array(ab, xb, ref, m, p);
+        CHECK(array_rel_error(y, ref) <= TOL(p), "matrix_times_array, %dx%d", m, p);
+
+        z = create_array(m);
+        over_copy_array(y, z);
+        gemv(2, a, x, -1, z);
+        CHECK(array_rel_error(z, ref) <= TOL(p), "gemv, %dx%d", m, p);
+        free_array(y);
+        free_array(z);
+
+        y = array_times_matrix(xt, a);
+        ref_array_times_matrix(xtb, ab, ref, m, p);
+        CHECK(array_rel_error(y, ref) <= TOL(m), "array_times_matrix, %dx%d", m, p);
+        z = create_array(p);
+        gemv_transposed(1, a, xt, 0, z);
+        CHECK(array_rel_error(z, ref) <= TOL(m), "gemv_transposed, %dx%d", m, p);
+        free_array(y);
+        free_array(z);
+
+        c = copy_matrix(a);                         // Square right-hand factors for the over_ products
+        free_matrix(sq);
+        sq = random_matrix(p, p);
+        yb = matrix_buffer(sq);
+        over_matrix_times_matrix(c, sq);
+        ref_matrix_times_matrix(ab, yb, ref, m, p, p);
+        CHECK(matrix_rel_error(c, ref) <= TOL(p), "over_matrix_times_matrix, %dx%d", m, p);
+        free_matrix(c);
+
+        y = copy_array(x);
+        over_matrix_times_array(sq, y);
+        ref_matrix_times_array(yb, xb, ref, p, p);
+        CHECK(array_rel_error(y, ref) <= TOL(p), "over_matrix_times_array, n = %d", p);
+        over_copy_array(x, y);
+        over_array_times_matrix(y, sq);
+        ref_array_times_matrix(xb, yb, ref, p, p);
+        CHECK(array_rel_error(y, ref) <= TOL(p), "over_array_times_matrix, n = %d", p);
+        free_array(y);
+
+        c = copy_matrix(sq);
+        over_transpose_matrix(c);
+        ref_transpose(yb, ref, p, p);
+        CHECK(matrix_rel_error(c, ref) == 0, "over_transpose_matrix, n = %d", p);
+        free_matrix(c);
+
+        c = random_matrix(3, p);                    // Three vectors at once
+        {
+            Matrix *ys = create_matrix(3, m);
+            double *cb = matrix_buffer(c);
+            int k;
+
+            gemv_multiple(1, a, c, 0, ys);
+
+            for (k = 0; k < 3; k++)
+            {
+                Array *row = create_array(m);
+                int i;
+
+                ref_matrix_times_array(ab, cb + k * p, ref, m, p);
+
+                for (i = 0; i < m; i++)
+                    insert_in_array(get_from_matrix(ys, k, i), row, i);
+
+                CHECK(array_rel_error(row, ref) <= TOL(p), "gemv_multiple, %dx%d", m, p);
+                free_array(row);
+            }
+
+            free(cb);
+            free_matrix(ys);
+        }
+        free_matrix(c);
+
+        CHECK(matrix_times_matrix(a, a) == NULL || m == p, "matrix_times_matrix with incompatible dimensions");
+
+        free_matrix(a);
+        free_matrix(b);
+        free_matrix(sq);
+        free_array(x);
+        free_array(xt);
+        free(ab);
+        free(bb);
+        free(ref);
+        free(xb);
+        free(xtb);
+        free(yb);
+    }
+
+    insert_in_matrix(INFINITY, zb, 0, 0);           // Zeros times non-finite values give NaN, as in every term of the sums.
+    insert_in_matrix(NAN, zb, 1, 1);
+    zc = matrix_times_matrix(za, zb);
+    gemv_transposed(1, zb, zx, 0, zy);
+    CHECK(isnan(get_from_matrix(zc, 1, 0)) && isnan(get_from_matrix(zc, 0, 1)), "matrix_times_matrix with non-finite elements");
+    CHECK(isnan(get_from_array(zy, 0)) && isnan(get_from_array(zy, 1)), "gemv_transposed with non-finite elements");
+
+    free_matrix(za);
+    free_matrix(zb);
+    free_matrix(zc);
+    free_array(zx);
+    free_array(zy);
+}
+
+static void test_vectors(void)
+{
+    int s, n, i;
+    Array *a = create_array(3), *b = create_array(3), *c;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+
+        Array *x = random_array(n), *y = random_array(n);
+        double *xb = array_buffer(x), *yb = array_buffer(y), ref;
+
+        ref = ref_scalar_product(xb, yb, n);
+        CHECK(fabs(scalar_product(x, y) - ref) <= TOL(n) * n, "scalar_product, n = %d", n);
+        ref = sqrt(ref_scalar_product(xb, xb, n));
+        CHECK(fabs(euclidean_norm(x) - ref) <= TOL(n) * ref, "euclidean_norm, n = %d", n);
+        CHECK(fabs(cosine_similarity(x, x) - 1) <= TOL(n), "cosine_similarity, n = %d", n);
+
+        free_array(x);
+        free_array(y);
+        free(xb);
+        free(yb);
+    }
+
+    insert_in_array(1, a, 0);
+    insert_in_array(1, b, 1);
+    c = vector_product(a, b);
+    CHECK(get_from_array(c, 0) == 0 && get_from_array(c, 1) == 0 && get_from_array(c, 2) == 1, "vector_product");
+    free_array(c);
+
+    for (i = 0; i < 3; i++)
+    {
+        insert_in_array(rnd(), a, i);
+        insert_in_array(rnd(), b, i);
+    }
+    c = vector_product(a, b);
+    CHECK(fabs(scalar_product(a, c)) <= TOL(3) && fabs(scalar_product(b, c)) <= TOL(3),
+          "vector_product is orthogonal to its factors");
+    free_array(c);
+    c = create_array(2);
+    CHECK(vector_product(a, c) == NULL, "vector_product with two dimensions");
+
+    free_array(a);
+    free_array(b);
+    free_array(c);
+}
+
+static void test_vector_batches(void)
+{
+    int i, k, n = 1000;
+    double err = 0;
+    VectorBatch *a = create_vector_batch(n), *b = create_vector_batch(n), *c = create_vector_batch(n);
+    Array *dot = create_array(n), *nrm = create_array(n), *u = create_array(3), *v = create_array(3), *w;
+
+    for (i = 0; i < n; i++)
+    {
+        insert_in_vector_batch(rnd(), rnd(), rnd(), a, i);
+        insert_in_vector_batch(rnd(), rnd(), rnd(), b, i);
+    }
+
+    batch_vector_product(a, b, c);
+    batch_scalar_product(a, b, dot);
+    batch_euclidean_norm(a, nrm);
+
+    for (i = 0; i < n; i++)
+    {
+        for (k = 0; k < 3; k++)
+        {
+            insert_in_array(get_from_vector_batch(a, i, k), u, k);
+            insert_in_array(get_from_vector_batch(b, i, k), v, k);
+        }
+
+        w = vector_product(u, v);
+
+        for (k = 0; k < 3; k++)
+            err = fmax(err, fabs(get_from_array(w, k) - get_from_vector_batch(c, i, k)));
+
+        err = fmax(err, fabs(get_from_array(dot, i) - scalar_product(u, v)));
+        err = fmax(err, fabs(get_from_array(nrm, i) - euclidean_norm(u)));
+        free_array(w);
+    }
+
+    CHECK(err <= TOL(3), "batch operations against single vectors, error %g", err);
+
+    over_normalize_vector_batch(a);
+    batch_euclidean_norm(a, nrm);
+    for (i = 0, err = 0; i < n; i++)
+        err = fmax(err, fabs(get_from_array(nrm, i) - 1));
+    CHECK(err <= TOL(3), "over_normalize_vector_batch, error %g", err);
+
+    free_vector_batch(a);
+    free_vector_batch(b);
+    free_vector_batch(c);
+    free_array(dot);
+    free_array(nrm);
+    free_array(u);
+    free_array(v);
+}
+
+static void test_permutations(void)
+{
+    int perm[5] = {3, 0, 4, 1, 2}, bad[5] = {0, 0, 1, 2, 3}, i, j;
+    Matrix *a = random_matrix(5, 4), *b = copy_matrix(a);
+    Array *x = random_array(5), *y = copy_array(x);
+
+    swap_rows(b, 0, 4);
+    for (j = 0; j < 4; j++)
+        CHECK(get_from_matrix(b, 0, j) == get_from_matrix(a, 4, j) && get_from_matrix(b, 4, j) == get_from_matrix(a, 0, j),
+              "swap_rows");
+    swap_rows(b, 0, 4);
+
+    apply_permutation_to_matrix(b, perm);
+    apply_permutation_to_array(y, perm);
+    for (i = 0; i < 5; i++)
+    {
+        CHECK(get_from_matrix(b, i, 2) == get_from_matrix(a, perm[i], 2), "apply_permutation_to_matrix");
+        CHECK(get_from_array(y, i) == get_from_array(x, perm[i]), "apply_permutation_to_array");
+    }
+
+    apply_permutation_to_array(y, bad);             // Refused, the array is kept.
+    CHECK(get_from_array(y, 0) == get_from_array(x, perm[0]), "invalid permutation must be refused");
+
+    free_matrix(a);
+    free_matrix(b);
+    free_array(x);
+    free_array(y);
+}
+
+static void test_elimination(void)
+{
+    int s, n, i, j, *perm;
+    double ref, det;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+        perm = malloc(n * sizeof(int));
+
+        Matrix *a = dominant_matrix(n), *h = hilbert_matrix(n < 8 ? n : 8), *z = singular_matrix(n), *t, *inv, *prod;
+        double *ab = matrix_buffer(a), *refinv = malloc((size_t) n * n * sizeof(double));
+
+        t = copy_matrix(a);                         // Upper triangular form
+        gaussian_elimination(t);
+        for (i = 1, det = 0; i < n; i++)
+        {
+            for (j = 0; j < i; j++)
+                det = fmax(det, fabs(get_from_matrix(t, i, j)));
+        }
+        CHECK(det == 0, "gaussian_elimination leaves non-null elements below the diagonal, n = %d", n);
+        free_matrix(t);
+
+        ref = ref_determinant(ab, n);
+        CHECK(fabs(determinant(a) - ref) <= TOL(n) * n * fabs(ref), "determinant, n = %d", n);
+        t = copy_matrix(a);
+        CHECK(fabs(over_determinant(t) - ref) <= TOL(n) * n * fabs(ref), "over_determinant, n = %d", n);
+        free_matrix(t);
+
+        t = copy_matrix(a);
+        det = lu_decomposition(t, perm);
+        for (i = 0; i < n; i++)
+            det *= get_from_matrix(t, i, i);
+        CHECK(fabs(det - ref) <= TOL(n) * n * fabs(ref), "lu_decomposition determinant, n = %d", n);
+        free_matrix(t);
+
+        inv = inverse_matrix(a);
+        prod = matrix_times_matrix(a, inv);
+        CHECK(identity_error(prod) <= TOL(n) * n, "inverse_matrix residual, n = %d", n);
+        ref_inverse(ab, refinv, n);
+        CHECK(matrix_rel_error(inv, refinv) <= TOL(n) * n, "inverse_matrix against the reference, n = %d", n);
+        free_matrix(inv);
+        free_matrix(prod);
+
+        if (n > 1)                                  // Singular matrices
+        {
+            CHECK(determinant(z) == 0, "determinant of a singular matrix, n = %d", n);
+            CHECK(inverse_matrix(z) == NULL, "inverse_matrix of a singular matrix, n = %d", n);
+            t = copy_matrix(z);
+            CHECK(lu_decomposition(t, perm) == 0, "lu_decomposition of a singular matrix, n = %d", n);
+            free_matrix(t);
+        }
+
+        inv = inverse_matrix(h);                    // Ill-conditioned: compared with the same algorithm
+        free(ab);
+        ab = matrix_buffer(h);
+        ref_inverse(ab, refinv, matrix_row_number(h));
+        CHECK(matrix_rel_error(inv, refinv) <= 1e-4, "inverse_matrix of a Hilbert matrix, n = %d", matrix_row_number(h));
+        free_matrix(inv);
+
+        free_matrix(a);
+        free_matrix(h);
+        free_matrix(z);
+        free(ab);
+        free(refinv);
+        free(perm);
+    }
+}
+
+static void test_systems(void)
+{
+    int s, n, i, j, *perm;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+        perm = malloc(n * sizeof(int));
+
+        Matrix *a = dominant_matrix(n), *sys = create_matrix(n, n + 1), *lu;
+        Array *sol, *b = random_array(n), *x;
+        double *sb, *ref = malloc(n * sizeof(double));
+
+        for (i = 0; i < n; i++)
+        {
+            for (j = 0; j < n; j++)
+                insert_in_matrix(get_from_matrix(a, i, j), sys, i, j);
+
+            insert_in_matrix(get_from_array(b, i), sys, i, n);
+        }
+
+        sb = matrix_buffer(sys);
+        ref_solve_system(sb, ref, n);
+        sol = solve_system(sys);
+        CHECK(sol != NULL && array_rel_error(sol, ref) <= TOL(n) * n, "solve_system, n = %d", n);
+
+        lu = copy_matrix(a);
+        lu_decomposition(lu, perm);
+        x = copy_array(b);
+        over_lu_solve(lu, perm, x);
+        CHECK(array_rel_error(x, ref) <= TOL(n) * n, "over_lu_solve, n = %d", n);
+
+        if (n > 1)
+        {
+            perm[0] = perm[1];
+            over_lu_solve(lu, perm, x);
+            CHECK(array_rel_error(x, ref) <= TOL(n) * n, "over_lu_solve must keep the right side with an invalid permutation, n = %d", n);
+        }
+
+        free_matrix(lu);                            // Independence after the elimination
+        lu = copy_matrix(sys);
+        gaussian_elimination(lu);
+        CHECK(independent_system(lu) == 1, "independent_system, n = %d", n);
+
+        if (n > 1)
+        {
+            for (j = 0; j <= n; j++)                // Two equal equations
+                insert_in_matrix(get_from_matrix(sys, 0, j), sys, n - 1, j);
+
+            CHECK(solve_system(sys) == NULL, "solve_system of a dependent system, n = %d", n);
+        }
+
+        free_matrix(a);
+        free_matrix(sys);
+        free_matrix(lu);
+        free_array(sol);
+        free_array(b);
+        free_array(x);
+        free(sb);
+        free(ref);
+        free(perm);
+    }
+}
+
+static void test_polynomials(void)
+{
+    int deg, i, n = 1001;
+    double err, derr, ref, dref, xv;
+    Array *xs = create_array(n), *out = create_array(n), *dout = create_array(n), *out2 = create_array(n);
+
+    for (i = 0; i < n; i++)
+        insert_in_array(2 * rnd(), xs, i);
+
+    for (deg = 0; deg <= 24; deg++)
+    {
+        Array *coef = random_array(deg + 1), *dcoef = (deg > 0) ? create_array(deg) : NULL;
+        double *cb = array_buffer(coef), *db = NULL;
+
+        for (i = 1; i <= deg; i++)
+            insert_in_array(i * get_from_array(coef, i), dcoef, i - 1);
+
+        if (deg > 0)
+            db = array_buffer(dcoef);
+
+        polynomial_eval_many(coef, xs, out, dout);
+        polynomial_eval_many(coef, xs, out2, NULL);
+
+        for (i = 0, err = 0, derr = 0; i < n; i++)
+        {
+            xv = get_from_array(xs, i);
+            ref = ref_polynomial(cb, deg + 1, xv);
+            dref = (deg > 0) ? ref_polynomial(db, deg, xv) : 0;
+
+            err = fmax(err, fabs(get_from_array(out, i) - ref) / fmax(1, fabs(ref)));
+            err = fmax(err, fabs(get_from_array(out2, i) - ref) / fmax(1, fabs(ref)));
+            err = fmax(err, fabs(polynomial_function(xv, coef) - ref) / fmax(1, fabs(ref)));
+            derr = fmax(derr, fabs(get_from_array(dout, i) - dref) / fmax(1, fabs(dref)));
+        }
+
+        CHECK(err <= TOL(deg + 1) * (1 << (deg < 10 ? deg : 10)), "polynomial evaluation, degree %d, error %g", deg, err);
+        CHECK(derr <= TOL(deg + 1) * (1 << (deg < 10 ? deg : 10)), "polynomial derivative, degree %d, error %g", deg, derr);
+
+        free_array(coef);
+        free_array(dcoef);
+        free(cb);
+        free(db);
+    }
+
+    free_array(xs);
+    free_array(out);
+    free_array(dout);
+    free_array(out2);
+}
+
+static void test_decompositions(void)
+{
+    int s, m, n, i, j, k, rank = 5;
+    double err;
+    Matrix *q, *r, *qt, *prod, *u, *v;
+    Array *sv;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+        m = n + sizes[(s + 2) % NSIZES];
+
+        Matrix *a = random_matrix(m, n);
+        double *ab = matrix_buffer(a);
+
+        qr_decomposition(a, &q, &r);
+        prod = matrix_times_matrix(q, r);
+        CHECK(matrix_rel_error(prod, ab) <= TOL(n) * 4, "qr_decomposition product, %dx%d", m, n);
+        qt = transpose_matrix(q);
+        free_matrix(prod);
+        prod = matrix_times_matrix(qt, q);
+        CHECK(identity_error(prod) <= TOL(m) * 4, "qr_decomposition orthogonality, %dx%d", m, n);
+
+        for (i = 1, err = 0; i < n; i++)
+        {
+            for (j = 0; j < i; j++)
+                err = fmax(err, fabs(get_from_matrix(r, i, j)));
+        }
+        CHECK(err == 0, "qr_decomposition 'r' must be upper triangular, %dx%d", m, n);
+
+        free_matrix(a);
+        free_matrix(q);
+        free_matrix(r);
+        free_matrix(qt);
+        free_matrix(prod);
+        free(ab);
+    }
+
+    m = 200;                                        // A matrix of rank 5 is recovered exactly.
+    n = 60;
+    u = random_matrix(m, rank);
+    v = random_matrix(rank, n);
+    prod = matrix_times_matrix(u, v);
+    free_matrix(u);
+    free_matrix(v);
+
+    CHECK(randomized_svd(prod, rank, 5, 1, &u, &sv, &v) == 1, "randomized_svd");
+
+    for (i = 0, err = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            double x = 0;
+
+            for (k = 0; k < rank; k++)
+                x += get_from_matrix(u, i, k) * get_from_array(sv, k) * get_from_matrix(v, j, k);
+
+            err = fmax(err, fabs(x - get_from_matrix(prod, i, j)));
+        }
+    }
+    CHECK(err <= 1e-10, "randomized_svd of a matrix of rank %d, error %g", rank, err);
+
+    for (k = 1; k < rank; k++)
+        CHECK(get_from_array(sv, k) <= get_from_array(sv, k - 1), "singular values must decrease");
+
+    free_matrix(prod);
+    free_matrix(u);
+    free_matrix(v);
+    free_array(sv);
+}
+
+static void test_stats(void)
+{
+    int count, i;
+    FunctionStats *before, *after;
+    Matrix *a = dominant_matrix(20), *b;
+    FILE *filout;
+
+    count = linalg_stats_snapshot(NULL, 0);
+    CHECK(count >= 67, "linalg_stats_snapshot must count the functions");
+
+    before = malloc(count * sizeof(FunctionStats));
+    after = malloc(count * sizeof(FunctionStats));
+
+    linalg_stats_snapshot(before, count);
+    b = matrix_times_matrix(a, a);
+    linalg_stats_snapshot(after, count);
+
+    CHECK(strcmp(after[26].name, "matrix_times_matrix") == 0 && after[26].number == 27, "function names by number");
+
+    if (linalg_stats_enabled())
+    {
+        CHECK(after[26].calls == before[26].calls + 1, "calls of matrix_times_matrix");
+        CHECK(after[26].flops - before[26].flops == 2.0 * 20 * 20 * 20, "operations of matrix_times_matrix");
+        CHECK(after[26].bytes - before[26].bytes >= 20 * 20 * (long long) sizeof(double), "memory of matrix_times_matrix");
+        CHECK(after[4].calls == before[4].calls + 1, "nested call of create_matrix");
+        CHECK(after[26].seconds >= before[26].seconds, "time of matrix_times_matrix");
+
+        linalg_stats_snapshot(before, count);
+        set_matrix_row(a, 20, NULL);
+        get_from_matrix(a, 20, 0);
+        linalg_stats_snapshot(after, count);
+        CHECK(after[111].calls == before[111].calls && after[7].calls == before[7].calls, "rejected calls are not counted");
+
+        linalg_stats_reset();
+        linalg_stats_snapshot(after, count);
+        for (i = 0; i < count; i++)
+            CHECK(after[i].calls == 0 && after[i].bytes == 0, "linalg_stats_reset, function %d", i + 1);
+    }
+    else
+    {
+        for (i = 0; i < count; i++)
+            CHECK(after[i].calls == 0, "counters must be zero without LINALG_STATS, function %d", i + 1);
+    }
+
+    filout = tmpfile();                         // The JSON output must be complete.
+    linalg_stats_print_json(filout);
+    CHECK(ftell(filout) > 0, "linalg_stats_print_json");
+    fclose(filout);
+
+    free(before);
+    free(after);
+    free_matrix(a);
+    free_matrix(b);
+}
+
+static void test_kernels(void)                  // Repeats the tests of the products with every set of kernels of the processor.
+{
+    static char *names[] = {"generic", "avx2", "avx512"};
+    char *chosen = linalg_kernels_name();
+    int i;
+
+    CHECK(linalg_select_kernels(chosen) == 1, "linalg_select_kernels, the kernels chosen at start");
+    CHECK(linalg_select_kernels("none") == 0, "linalg_select_kernels, unknown kernels");
+    CHECK(strcmp(linalg_kernels_name(), chosen) == 0, "a failed selection must keep the kernels");
+
+    for (i = 0; i < 3; i++)
+    {
+        if (linalg_select_kernels(names[i]) == 0)
+            continue;
+
+        CHECK(strcmp(linalg_kernels_name(), names[i]) == 0, "linalg_kernels_name, %s", names[i]);
+
+        test_copies_and_sums();
+        test_products();
+        test_vectors();
+        test_systems();
+    }
+
+    linalg_select_kernels(chosen);
+}
+
+static void test_tuning(void)                   // Repeats the tests of the products with small blocks and multithreading everywhere.
+{
+    static char *names[] = {"gemm_block_rows", "gemm_block_inner", "gemm_block_cols", "gemm_parallel", "gemv_parallel",
+                            "gemv_columns", "elementwise_parallel", "batch_parallel", "poly_parallel"};
+    int saved[9], i;
+    FILE *filout;
+
+    for (i = 0; i < 9; i++)
+    {
+        saved[i] = linalg_get_parameter(names[i]);
+        CHECK(saved[i] >= 0, "linalg_get_parameter, %s", names[i]);
+    }
+
+    CHECK(linalg_get_parameter("none") == -1, "linalg_get_parameter, unknown name");
+    CHECK(linalg_set_parameter("gemm_block_rows", 0) == 0, "linalg_set_parameter, value out of range");
+    CHECK(linalg_init(NULL) == 1, "linalg_init without a profile");
+    CHECK(linalg_init("test_linalg_missing.tuning") == 0, "linalg_init, missing file");
+
+    filout = fopen("test_linalg.tuning", "w");
+    fprintf(filout, "# Odd block sizes, so that every block edge is used\n\ngemm_block_rows = 3\n  gemm_block_inner = 5\n"
+            "gemm_block_cols = 7\ngemm_parallel = 0\ngemv_parallel = 0\ngemv_columns = 6\nelementwise_parallel = 0\n"
+            "batch_parallel = 0\npoly_parallel = 0\n");
+    fclose(filout);
+
+    CHECK(linalg_init("test_linalg.tuning") == 1, "linalg_init");
+    CHECK(linalg_get_parameter("gemm_block_inner") == 5 && linalg_get_parameter("gemv_columns") == 6, "parameters loaded by linalg_init");
+
+    test_copies_and_sums();
+    test_products();
+    test_vector_batches();
+    test_polynomials();
+
+    filout = fopen("test_linalg.tuning", "w");      // 'linalg_print_tuning' must write a profile that can be loaded.
+    linalg_print_tuning(filout);
+    fprintf(filout, "gemm_block_rows = -2\ngemm_parallel = -1e12\ngemm_block_inner = 64abc\n");
+    fclose(filout);
+
+    CHECK(linalg_init("test_linalg.tuning") == 0, "linalg_init, invalid line");
+    CHECK(linalg_get_parameter("gemm_block_rows") == 3 && linalg_get_parameter("gemm_parallel") == 0 &&
+          linalg_get_parameter("gemm_block_inner") == 5,
+          "linalg_init must keep the parameter of an invalid line");
+
+    remove("test_linalg.tuning");
+
+    for (i = 0; i < 9; i++)
+        linalg_set_parameter(names[i], saved[i]);
+}
+
+static void test_strassen(void)                 // Strassen's method against the reference, for odd and rectangular sizes.
+{
+    int s, m, n, p, cut, cuts[] = {1, 4, 16};
+    double err, bound;
+
+    CHECK(linalg_get_parameter("strassen_cutoff") == 0, "Strassen's method must be disabled by default");
+
+    for (cut = 0; cut < 3; cut++)
+    {
+        linalg_set_parameter("strassen_cutoff", cuts[cut]);
+
+        for (s = 0; s < NSIZES; s++)
+        {
+            m = sizes[s];
+            n = sizes[(s + 3) % NSIZES];
+            p = sizes[(s + 5) % NSIZES];
+
+            Matrix *a = random_matrix(m, p), *b = random_matrix(p, n), *c, *sq = random_matrix(n, n);
+            double *ab = matrix_buffer(a), *bb = matrix_buffer(b), *ref = malloc((size_t) (m + n + p) * (m + n + p) * sizeof(double));
+
+            bound = pow((double) p / cuts[cut], log2(18.0)) * (cuts[cut] * cuts[cut] + 6.0 * cuts[cut]) * DBL_EPSILON;
+
+            c = matrix_times_matrix(a, b);
+            ref_matrix_times_matrix(ab, bb, ref, m, p, n);
+            err = matrix_rel_error(c, ref);
+            CHECK(err <= bound + TOL(p), "Strassen matrix_times_matrix, %dx%d * %dx%d, cutoff %d: error %g", m, p, p, n, cuts[cut], err);
+            free_matrix(c);
+
+            free(bb);
+            bb = matrix_buffer(sq);
+            c = copy_matrix(b);
+            over_matrix_times_matrix(c, sq);
+            free(ab);
+            ab = matrix_buffer(b);
+            ref_matrix_times_matrix(ab, bb, ref, p, n, n);
+            CHECK(matrix_rel_error(c, ref) <= bound + TOL(n), "Strassen over_matrix_times_matrix, %dx%d, cutoff %d", p, n, cuts[cut]);
+            free_matrix(c);
+
+            free_matrix(a);
+            free_matrix(b);
+            free_matrix(sq);
+            free(ab);
+            free(bb);
+            free(ref);
+        }
+    }
+
+    linalg_set_parameter("strassen_cutoff", 0);
+}
+
+static void test_tiled(void)                   // Out-of-core matrices with a cache of a few tiles, against the usual functions.
+{
+    static const int dims[][4] = {{1, 1, 1, 1}, {5, 3, 7, 4}, {37, 29, 23, 8}, {64, 64, 64, 16}};
+    int s, m, p, n, tile, *perm, *tperm, sign;
+    Matrix *a, *b, *c, *ref, *lu;
+    TiledMatrix *ta, *tb, *tc;
+    Array *x, *y;
+    double *buf;
+
+    for (s = 0; s < 4; s++)
+    {
+        m = dims[s][0];
+        p = dims[s][1];
+        n = dims[s][2];
+        tile = dims[s][3];
+
+        a = random_matrix(m, p);
+        b = random_matrix(p, n);
+
+        ta = matrix_to_tiled_matrix(a, "test_linalg_a.tiles", tile, 0);     // Cache of four tiles: every operation evicts.
+        tb = matrix_to_tiled_matrix(b, "test_linalg_b.tiles", tile, 0);
+        tc = create_tiled_matrix("test_linalg_c.tiles", m, n, tile, 0);
+
+        CHECK(tiled_matrix_row_number(ta) == m && tiled_matrix_column_number(ta) == p, "tiled matrix dimensions, %dx%d", m, p);
+        CHECK(get_from_tiled_matrix(ta, m - 1, p - 1) == get_from_matrix(a, m - 1, p - 1), "get_from_tiled_matrix, %dx%d", m, p);
+
+        c = tiled_matrix_to_matrix(ta);
+        CHECK(same_matrix(c, a), "matrix_to_tiled_matrix and back, %dx%d, tiles of %d", m, p, tile);
+        free_matrix(c);
+
+        CHECK(tiled_matrix_times_matrix(tb, ta, tc) == 0 || (n == m && p == m), "tiled_matrix_times_matrix, incompatible dimensions");
+        CHECK(tiled_matrix_times_matrix(ta, tb, tc) == 1, "tiled_matrix_times_matrix, %dx%d * %dx%d", m, p, p, n);
+        ref = matrix_times_matrix(a, b);
+        buf = matrix_buffer(ref);
+        c = tiled_matrix_to_matrix(tc);
+        CHECK(matrix_rel_error(c, buf) <= TOL(p), "tiled_matrix_times_matrix, %dx%d * %dx%d, tiles of %d", m, p, p, n, tile);
+        free_matrix(c);
+        free(buf);
+        free_matrix(ref);
+
+        free_tiled_matrix(tc);                      // The transpose of 'a', reusing the file
+        tc = create_tiled_matrix("test_linalg_c.tiles", p, m, tile, 0);
+        CHECK(tiled_transpose_matrix(ta, tc) == 1, "tiled_transpose_matrix, %dx%d", m, p);
+        ref = transpose_matrix(a);
+        c = tiled_matrix_to_matrix(tc);
+        CHECK(same_matrix(c, ref), "tiled_transpose_matrix, %dx%d, tiles of %d", m, p, tile);
+        free_matrix(c);
+        free_matrix(ref);
+
+        insert_in_tiled_matrix(42, ta, m / 2, p / 2);   // Changes must be saved in the file.
+        free_tiled_matrix(ta);
+        ta = open_tiled_matrix("test_linalg_a.tiles", 1 << 20);
+        CHECK(ta != NULL && tiled_matrix_row_number(ta) == m && tiled_matrix_column_number(ta) == p, "open_tiled_matrix, %dx%d", m, p);
+        CHECK(get_from_tiled_matrix(ta, m / 2, p / 2) == 42, "insert_in_tiled_matrix saved in the file, %dx%d", m, p);
+
+        free_tiled_matrix(ta);
+        free_tiled_matrix(tb);
+        free_tiled_matrix(tc);
+        free_matrix(a);
+        free_matrix(b);
+    }
+
+    for (s = 0; s < NSIZES; s++)                    // LU decomposition, with panels of several sizes
+    {
+        n = sizes[s];
+        tile = (s % 3) + 3;
+
+        a = random_matrix(n, n);
+        perm = malloc(n * sizeof(int));
+        tperm = malloc(n * sizeof(int));
+
+        lu = copy_matrix(a);
+        sign = lu_decomposition(lu, perm);
+
+        ta = matrix_to_tiled_matrix(a, "test_linalg_a.tiles", tile, 0);
+        CHECK(tiled_lu_decomposition(ta, tperm) == sign, "tiled_lu_decomposition, sign, n = %d, tiles of %d", n, tile);
+        CHECK(memcmp(perm, tperm, n * sizeof(int)) == 0, "tiled_lu_decomposition, pivots, n = %d, tiles of %d", n, tile);
+
+        c = tiled_matrix_to_matrix(ta);
+        buf = matrix_buffer(lu);
+        CHECK(matrix_rel_error(c, buf) <= TOL(n) * n, "tiled_lu_decomposition, factors, n = %d, tiles of %d", n, tile);
+        free(buf);
+
+        x = random_array(n);                        // The factors solve systems with 'over_lu_solve'.
+        y = matrix_times_array(a, x);
+        over_lu_solve(c, tperm, y);
+        buf = array_buffer(x);
+        CHECK(array_rel_error(y, buf) <= TOL(n) * n * n, "tiled_lu_decomposition with over_lu_solve, n = %d", n);
+        free(buf);
+
+        free_tiled_matrix(ta);
+        free_matrix(c);
+        free_matrix(lu);
+        free_matrix(a);
+        free_array(x);
+        free_array(y);
+
+        a = singular_matrix(n);
+        ta = matrix_to_tiled_matrix(a, "test_linalg_a.tiles", tile, 0);
+        CHECK(tiled_lu_decomposition(ta, tperm) == 0, "tiled_lu_decomposition of a singular matrix, n = %d", n);
+        free_tiled_matrix(ta);
+        free_matrix(a);
+
+        free(perm);
+        free(tperm);
+    }
+
+    CHECK(open_tiled_matrix("test_linalg_missing.tiles", 0) == NULL, "open_tiled_matrix, missing file");
+
+    remove("test_linalg_a.tiles");
+    remove("test_linalg_b.tiles");
+    remove("test_linalg_c.tiles");
+}
+
+static void count_callback(AsyncTask *task, void *data)     // Counts the finished tasks.
+{
+    (void) task;
+
+    (*(int*) data)++;
+}
+
+static void test_async(void)                    // Asynchronous functions against the synchronous ones.
+{
+    int calls = 0, cancelled, i;
+    Matrix *a = dominant_matrix(60), *b = random_matrix(60, 17), *ref, *res, *big;
+    Matrix *sys = random_matrix(12, 13);
+    AsyncTask *t1, *t2, *t3;
+    Array *sol;
+    double *buf;
+
+    for (i = 0; i < 12; i++)                        // Singular system
+        insert_in_matrix(0, sys, i, 5);
+
+    CHECK(linalg_start_workers(1) == 1, "linalg_start_workers");
+    CHECK(matrix_times_matrix_async(b, b, NULL, NULL) == NULL, "matrix_times_matrix_async, incompatible dimensions");
+
+    t1 = matrix_times_matrix_async(a, b, count_callback, &calls);
+    t2 = inverse_matrix_async(a, count_callback, &calls);
+    ref = copy_matrix(a);                           // The tasks have their own copies.
+    free_matrix(a);
+    a = ref;
+    t3 = solve_system_async(sys, count_callback, &calls);
+
+    res = task_wait(t1);
+    ref = matrix_times_matrix(a, b);
+    buf = matrix_buffer(ref);
+    CHECK(task_status(t1) == TASK_DONE && res != NULL && matrix_rel_error(res, buf) == 0, "matrix_times_matrix_async");
+    CHECK(task_progress(t1) == 1, "task_progress of a finished task");
+    free(buf);
+    free_matrix(ref);
+    free_matrix(res);
+
+    res = task_wait(t2);
+    CHECK(task_status(t2) == TASK_DONE && res != NULL, "inverse_matrix_async");
+    if (res != NULL)
+    {
+        ref = matrix_times_matrix(a, res);
+        CHECK(identity_error(ref) <= TOL(60) * 60, "inverse_matrix_async, A * inv(A)");
+        free_matrix(ref);
+    }
+    free_matrix(res);
+
+    sol = task_wait(t3);
+    CHECK(task_status(t3) == TASK_FAILED && sol == NULL, "solve_system_async of a singular system");
+    CHECK(calls == 3, "callbacks of the finished tasks: %d", calls);
+    CHECK(task_cancel(t3) == 0, "task_cancel of a finished task");
+
+    free_task(t1);
+    free_task(t2);
+    free_task(t3);
+
+    big = dominant_matrix(400);                     // A long task keeps the only worker busy.
+    t1 = inverse_matrix_async(big, count_callback, &calls);
+    t2 = matrix_times_matrix_async(big, big, count_callback, &calls);
+
+    CHECK(task_cancel(t2) == 1 && task_status(t2) == TASK_CANCELLED, "task_cancel of a pending task");
+    CHECK(calls == 4, "callback of a task cancelled before it started");
+    CHECK(task_wait(t2) == NULL, "task_wait of a cancelled task");
+
+    cancelled = task_cancel(t1);
+    res = task_wait(t1);
+    CHECK(cancelled ? (res == NULL && task_status(t1) == TASK_CANCELLED) : task_status(t1) == TASK_DONE, "task_cancel of a running task");
+    CHECK(task_progress(t1) >= 0 && task_progress(t1) <= 1, "task_progress");
+    free_matrix(res);
+    free_task(t1);
+    free_task(t2);
+
+    t1 = matrix_times_matrix_async(big, big, NULL, NULL);   // Freed before it finishes, with its result
+    free_task(t1);
+
+    linalg_stop_workers();
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(sys);
+    free_matrix(big);
+}
+
+static void test_dag(void)                      // Task-graph factorizations against the usual ones, with small tiles and several threads.
+{
+    int s, m, n, i, sign, *perm, *dperm;
+    Matrix *a, *b, *l, *dl, *lu, *q, *r, *qt, *prod;
+    double *buf, err;
+
+    linalg_set_parameter("dag_workers", 4);
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+        m = n + sizes[(s + 2) % NSIZES];
+
+        linalg_set_parameter("dag_tile", (s % 3) + 3);
+
+        b = random_matrix(n, n);                    // Symmetric positive definite matrix
+        qt = transpose_matrix(b);
+        a = matrix_times_matrix(b, qt);
+        for (i = 0; i < n; i++)
+            insert_in_matrix(get_from_matrix(a, i, i) + n, a, i, i);
+        free_matrix(b);
+        free_matrix(qt);
+
+        l = cholesky_decomposition(a);
+        dl = dag_cholesky_decomposition(a);
+        CHECK(l != NULL && dl != NULL, "cholesky_decomposition, n = %d", n);
+        qt = transpose_matrix(l);
+        prod = matrix_times_matrix(l, qt);
+        buf = matrix_buffer(a);
+        CHECK(matrix_rel_error(prod, buf) <= TOL(n) * 4, "cholesky_decomposition product, n = %d", n);
+        free(buf);
+        buf = matrix_buffer(l);
+        CHECK(matrix_rel_error(dl, buf) <= TOL(n) * 4, "dag_cholesky_decomposition, n = %d", n);
+        free(buf);
+        free_matrix(l);
+        free_matrix(dl);
+        free_matrix(qt);
+        free_matrix(prod);
+
+        over_rnumber_times_matrix(-1, a);           // Negative definite
+        CHECK(cholesky_decomposition(a) == NULL, "cholesky_decomposition of a matrix not positive definite, n = %d", n);
+        CHECK(dag_cholesky_decomposition(a) == NULL, "dag_cholesky_decomposition of a matrix not positive definite, n = %d", n);
+        free_matrix(a);
+
+        a = random_matrix(n, n);
+        perm = malloc(n * sizeof(int));
+        dperm = malloc(n * sizeof(int));
+        lu = copy_matrix(a);
+        sign = lu_decomposition(lu, perm);
+        CHECK(dag_lu_decomposition(a, dperm) == sign, "dag_lu_decomposition, sign, n = %d", n);
+        CHECK(memcmp(perm, dperm, n * sizeof(int)) == 0, "dag_lu_decomposition, pivots, n = %d", n);
+        buf = matrix_buffer(lu);
+        CHECK(matrix_rel_error(a, buf) <= TOL(n) * n, "dag_lu_decomposition, factors, n = %d", n);
+        free(buf);
+        free_matrix(a);
+        free_matrix(lu);
+
+        a = singular_matrix(n);
+        buf = matrix_buffer(a);
+        CHECK(dag_lu_decomposition(a, dperm) == 0 && matrix_rel_error(a, buf) == 0, "dag_lu_decomposition of a singular matrix, n = %d", n);
+        free(buf);
+        free_matrix(a);
+        free(perm);
+        free(dperm);
+
+        a = random_matrix(m, n);
+        buf = matrix_buffer(a);
+        dag_qr_decomposition(a, &q, &r);
+        prod = matrix_times_matrix(q, r);
+        CHECK(matrix_rel_error(prod, buf) <= TOL(n) * 4, "dag_qr_decomposition product, %dx%d", m, n);
+        qt = transpose_matrix(q);
+        free_matrix(prod);
+        prod = matrix_times_matrix(qt, q);
+        CHECK(identity_error(prod) <= TOL(m) * 4, "dag_qr_decomposition orthogonality, %dx%d", m, n);
+
+        for (i = 1, err = 0; i < n * n; i++)
+        {
+            if (i % n < i / n)
+                err = fmax(err, fabs(get_from_matrix(r, i / n, i % n)));
+        }
+        CHECK(err == 0, "dag_qr_decomposition 'r' must be upper triangular, %dx%d", m, n);
+
+        free_matrix(a);
+        free_matrix(q);
+        free_matrix(r);
+        free_matrix(qt);
+        free_matrix(prod);
+        free(buf);
+    }
+
+    linalg_set_parameter("dag_tile", 128);
+    linalg_set_parameter("dag_workers", 0);
+}
+
+static void test_updates(void)                  // Updated factors against those of the changed matrix.
+{
+    int s, n, k, i, *perm;
+    Matrix *a, *a2, *u, *v, *vt, *uv, *inv, *prod, *l, *l0, *lt, *q, *r, *qt;
+    Array *x, *y;
+    double *buf, err;
+
+    for (s = 0; s < NSIZES; s++)
+    {
+        n = sizes[s];
+        k = (s % 3) + 1;
+
+        a = dominant_matrix(n);
+        u = random_matrix(n, k);
+        v = random_matrix(n, k);
+        vt = transpose_matrix(v);
+        uv = matrix_times_matrix(u, vt);
+        a2 = copy_matrix(a);
+        over_sum_matrix(a2, uv);
+
+        inv = inverse_matrix(a);
+        CHECK(over_inverse_update(inv, u, v) == 1, "over_inverse_update, n = %d, rank %d", n, k);
+        prod = matrix_times_matrix(a2, inv);
+        CHECK(identity_error(prod) <= TOL(n) * n * 4, "over_inverse_update, A * inv(A), n = %d, rank %d", n, k);
+        free_matrix(prod);
+        free_matrix(inv);
+
+        perm = malloc(n * sizeof(int));             // The updated factors solve systems of the changed matrix.
+        l = copy_matrix(a);
+        lu_decomposition(l, perm);
+        i = perm[0];
+        perm[0] = n;
+        CHECK(over_lu_update(l, perm, u, v) == 0, "over_lu_update with an invalid permutation, n = %d", n);
+        perm[0] = i;
+        CHECK(over_lu_update(l, perm, u, v) == 1, "over_lu_update, n = %d, rank %d", n, k);
+        x = random_array(n);
+        y = matrix_times_array(a2, x);
+        over_lu_solve(l, perm, y);
+        buf = array_buffer(x);
+        CHECK(array_rel_error(y, buf) <= TOL(n) * n * n, "over_lu_update with over_lu_solve, n = %d, rank %d", n, k);
+        free(buf);
+        free_array(x);
+        free_array(y);
+        free_matrix(l);
+        free(perm);
+
+        qr_decomposition(a, &q, &r);
+        CHECK(over_qr_update(q, r, u, v) == 1, "over_qr_update, n = %d, rank %d", n, k);
+        prod = matrix_times_matrix(q, r);
+        buf = matrix_buffer(a2);
+        CHECK(matrix_rel_error(prod, buf) <= TOL(n) * 8, "over_qr_update product, n = %d, rank %d", n, k);
+        free(buf);
+        free_matrix(prod);
+        qt = transpose_matrix(q);
+        prod = matrix_times_matrix(qt, q);
+        CHECK(identity_error(prod) <= TOL(n) * 8, "over_qr_update orthogonality, n = %d, rank %d", n, k);
+
+        for (i = 1, err = 0; i < n * n; i++)
+        {
+            if (i % n < i / n)
+                err = fmax(err, fabs(get_from_matrix(r, i / n, i % n)));
+        }
+        CHECK(err == 0, "over_qr_update 'r' must be upper triangular, n = %d", n);
+        free_matrix(prod);
+        free_matrix(qt);
+        free_matrix(q);
+        free_matrix(r);
+
+        free_matrix(a2);                            // Cholesky factors of A * A' and A * A' + u * u'
+        free_matrix(uv);
+        lt = transpose_matrix(a);
+        a2 = matrix_times_matrix(a, lt);
+        free_matrix(lt);
+        l0 = cholesky_decomposition(a2);
+        l = copy_matrix(l0);
+        CHECK(over_cholesky_update(l, u) == 1, "over_cholesky_update, n = %d, rank %d", n, k);
+        free_matrix(vt);
+        vt = transpose_matrix(u);
+        uv = matrix_times_matrix(u, vt);
+        over_sum_matrix(uv, a2);
+        lt = transpose_matrix(l);
+        prod = matrix_times_matrix(l, lt);
+        buf = matrix_buffer(uv);
+        CHECK(matrix_rel_error(prod, buf) <= TOL(n) * 8, "over_cholesky_update product, n = %d, rank %d", n, k);
+        free(buf);
+
+        CHECK(over_cholesky_downdate(l, u) == 1, "over_cholesky_downdate, n = %d, rank %d", n, k);
+        buf = matrix_buffer(l0);
+        CHECK(matrix_rel_error(l, buf) <= TOL(n) * n * 4, "over_cholesky_downdate back to the first factor, n = %d", n);
+        free(buf);
+
+        over_rnumber_times_matrix(2, l0);           // A - 4 * A is not positive definite.
+        CHECK(over_cholesky_downdate(l, l0) == 0, "over_cholesky_downdate of a matrix not positive definite, n = %d", n);
+
+        free_matrix(a);
+        free_matrix(a2);
+        free_matrix(u);
+        free_matrix(v);
+        free_matrix(vt);
+        free_matrix(uv);
+        free_matrix(l);
+        free_matrix(l0);
+        free_matrix(lt);
+        free_matrix(prod);
+    }
+
+    a = dominant_matrix(5);
+    u = random_matrix(5, 2);
+    v = random_matrix(4, 2);
+    CHECK(over_inverse_update(a, u, v) == 0 && over_cholesky_update(a, v) == 0 && over_qr_update(a, u, u, v) == 0,
+          "updates with incompatible dimensions");
+    free_matrix(a);
+    free_matrix(u);
+    free_matrix(v);
+}
+
+static void test_factor_cache(void)             // Cached decompositions against the usual functions.
+{
+    int i;
+    double det, ref;
+    Matrix *a = dominant_matrix(20), *b = dominant_matrix(20), *sys, *inv, *prod;
+    Array *sol, *sol2;
+    FactorCacheStats st;
+    double *buf;
+
+    inv = copy_matrix(a);
+    ref = over_determinant(inv);
+    free_matrix(inv);
+    sys = create_matrix(20, 21);
+    for (i = 0; i < 20 * 21; i++)
+        insert_in_matrix(i % 21 < 20 ? get_from_matrix(a, i / 21, i % 21) : rnd(), sys, i / 21, i % 21);
+    sol2 = solve_system(sys);
+
+    linalg_factor_cache(1 << 20);
+    factor_cache_clear();
+
+    det = determinant(a);
+    CHECK(fabs(det - ref) <= TOL(20) * 20 * fabs(ref), "determinant with the factorization cache");
+    CHECK(determinant(a) == det, "determinant of an unchanged matrix");
+
+    inv = inverse_matrix(a);
+    prod = matrix_times_matrix(a, inv);
+    CHECK(identity_error(prod) <= TOL(20) * 20, "inverse_matrix from the factorization cache");
+    free_matrix(inv);
+    free_matrix(prod);
+
+    sol = solve_system(sys);                        // Same coefficients, other right side
+    buf = array_buffer(sol2);
+    CHECK(sol != NULL && array_rel_error(sol, buf) <= TOL(20) * 20, "solve_system from the factorization cache");
+    free(buf);
+    free_array(sol);
+
+    factor_cache_stats(&st);
+    CHECK(st.hits == 2 && st.misses == 1 && st.entries == 1 && st.bytes > 2 * 20 * 20 * 8,
+          "factor_cache_stats: %lld hits, %lld misses", st.hits, st.misses);
+
+    insert_in_matrix(get_from_matrix(a, 3, 4) + 1e-9, a, 3, 4);    // A changed matrix is not found.
+    determinant(a);
+    factor_cache_stats(&st);
+    CHECK(st.misses == 2 && st.entries == 2, "factorization cache of a changed matrix");
+
+    linalg_factor_cache(st.bytes / 2 + 1);          // Room for one decomposition
+    factor_cache_stats(&st);
+    CHECK(st.entries == 1 && st.evictions == 1, "factorization cache reduced");
+    determinant(b);
+    free_matrix(inverse_matrix(a));
+    factor_cache_stats(&st);
+    CHECK(st.entries == 1 && st.evictions == 3 && st.hits == 2 && st.misses == 4, "factorization cache eviction");
+
+    free_matrix(b);
+    b = singular_matrix(20);
+    CHECK(inverse_matrix(b) == NULL && inverse_matrix(b) == NULL && determinant(b) == 0, "factorization cache of a singular matrix");
+
+    linalg_factor_cache(0);
+    factor_cache_stats(&st);
+    CHECK(st.entries == 0 && st.bytes == 0 && st.budget == 0, "factorization cache disabled");
+    factor_cache_clear();
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(sys);
+    free_array(sol2);
+}
+
+static void test_versions(void)                 // Counters of changes and the values saved with them.
+{
+    int i, perm[6];
+    unsigned long long v;
+    double norm, det, ref;
+    Array *x = random_array(6), *y = create_array(6);
+    Matrix *a = dominant_matrix(6), *b = random_matrix(6, 6), *t;
+    FactorCacheStats st;
+
+    t = create_matrix(2, 3);
+    CHECK(array_version(y) == 1 && matrix_version(t) == 1 && array_version(NULL) == 0, "versions of new arrays and matrices");
+    free_matrix(t);
+
+    v = array_version(x);
+    norm = euclidean_norm(x);
+    CHECK(euclidean_norm(x) == norm && array_version(x) == v, "euclidean_norm does not change the array");
+    insert_in_array(10, x, 2);
+    CHECK(array_version(x) == v + 1, "insert_in_array changes the version");
+    CHECK(euclidean_norm(x) > norm && fabs(euclidean_norm(x) - sqrt(scalar_product(x, x))) <= 4 * DBL_EPSILON * euclidean_norm(x),
+          "euclidean_norm after a change");
+
+    v = array_version(y);
+    gemv(1, a, x, 0, y);
+    CHECK(array_version(y) > v, "gemv changes the version of 'y'");
+    v = array_version(x);
+    over_rnumber_times_array(2, x);
+    CHECK(array_version(x) == v + 1, "over_rnumber_times_array changes the version");
+
+    t = copy_matrix(a);
+    ref = over_determinant(t);
+    free_matrix(t);
+    det = determinant(a);
+    CHECK(fabs(det - ref) <= TOL(6) * fabs(ref) && determinant(a) == det, "determinant of an unchanged matrix");
+    v = matrix_version(a);
+    swap_rows(a, 0, 1);
+    CHECK(matrix_version(a) > v && fabs(determinant(a) + det) <= TOL(6) * fabs(det), "determinant after swap_rows");
+    insert_in_matrix(get_from_matrix(a, 2, 2) * 2, a, 2, 2);
+    t = copy_matrix(a);
+    ref = over_determinant(t);
+    free_matrix(t);
+    CHECK(fabs(determinant(a) - ref) <= TOL(6) * fabs(ref), "determinant after insert_in_matrix");
+
+    for (i = 0, norm = 0; i < 36; i++)
+        norm += get_from_matrix(b, i / 6, i % 6) * get_from_matrix(b, i / 6, i % 6);
+    CHECK(fabs(frobenius_norm(b) - sqrt(norm)) <= TOL(36) * sqrt(norm) && frobenius_norm(NULL) == 0, "frobenius_norm");
+    v = matrix_version(b);
+    over_rnumber_times_matrix(2, b);
+    CHECK(matrix_version(b) > v && fabs(frobenius_norm(b) - 2 * sqrt(norm)) <= TOL(36) * sqrt(norm), "frobenius_norm after a change");
+    v = matrix_version(b);
+    over_sum_matrix(b, a);
+    over_transpose_matrix(b);
+    lu_decomposition(b, perm);
+    CHECK(matrix_version(b) >= v + 3, "over_sum_matrix, over_transpose_matrix and lu_decomposition change the version");
+
+    linalg_factor_cache(1 << 20);                   // Found again by the version, then by the elements after a change
+    factor_cache_clear();
+    t = inverse_matrix(a);
+    free_matrix(t);
+    t = inverse_matrix(a);
+    free_matrix(t);
+    insert_in_matrix(get_from_matrix(a, 0, 0), a, 0, 0);
+    t = inverse_matrix(a);
+    factor_cache_stats(&st);
+    CHECK(st.hits == 2 && st.misses == 1, "factorization cache with versions: %lld hits, %lld misses", st.hits, st.misses);
+    free_matrix(t);
+    linalg_factor_cache(0);
+    factor_cache_clear();
+
+    free_array(x);
+    free_array(y);
+    free_matrix(a);
+    free_matrix(b);
+}
+
+static void test_bulk(void)                     // Bulk accessors against the accessors of single elements.
+{
+    int i, j, err;
+    double buf[7 * 9], out[7 * 9], *row;
+    unsigned long long v;
+    Matrix *a = create_matrix(7, 5), *b, *c, *d;
+    Array *x = create_array(9);
+
+    for (i = 0; i < 7 * 9; i++)
+        buf[i] = rnd();
+
+    set_matrix_buffer(a, buf);
+    for (i = 0, err = 0; i < 35; i++)
+        err += get_from_matrix(a, i / 5, i % 5) != buf[i];
+    get_matrix_buffer(a, out);
+    CHECK(err == 0 && memcmp(buf, out, 35 * sizeof(double)) == 0, "set_matrix_buffer and get_matrix_buffer");
+
+    v = matrix_version(a);
+    set_matrix_row(a, 3, buf + 40);
+    set_matrix_column(a, 4, buf + 50);
+    get_matrix_row(a, 3, out);
+    get_matrix_column(a, 4, out + 5);
+    CHECK(memcmp(out, buf + 40, 4 * sizeof(double)) == 0 && out[4] == buf[53] && memcmp(out + 5, buf + 50, 7 * sizeof(double)) == 0,
+          "set_matrix_row, set_matrix_column and the 'get' functions");
+    CHECK(matrix_version(a) == v + 2, "bulk accessors change the version");
+
+    set_matrix_block(a, 2, 1, 3, 2, buf, 9);        // Rows of the buffer with 9 elements
+    for (i = 0, err = 0; i < 3; i++)
+    {
+        for (j = 0; j < 2; j++)
+            err += get_from_matrix(a, 2 + i, 1 + j) != buf[i * 9 + j];
+    }
+    get_matrix_block(a, 2, 1, 3, 2, out, 2);
+    CHECK(err == 0 && out[0] == buf[0] && out[3] == buf[10] && out[5] == buf[19], "set_matrix_block and get_matrix_block");
+
+    memcpy(out, buf, sizeof(buf));
+    get_matrix_block(a, 6, 4, 2, 1, out, 1);        // Outside the matrix: nothing is copied.
+    set_matrix_block(a, 0, 0, 2, 3, buf, 2);
+    set_matrix_row(a, 7, buf);
+    get_matrix_column(NULL, 0, out);
+    CHECK(memcmp(out, buf, sizeof(buf)) == 0 && get_from_matrix(a, 0, 0) == buf[0], "bulk accessors with invalid arguments");
+
+    row = matrix_row_pointer(a, 5);
+    row[2] = 42;
+    CHECK(get_from_matrix(a, 5, 2) == 42 && matrix_row_pointer(a, 7) == NULL, "matrix_row_pointer");
+
+    set_array_buffer(x, buf);
+    get_array_buffer(x, out);
+    CHECK(memcmp(out, buf, 9 * sizeof(double)) == 0 && array_version(x) == 2, "set_array_buffer and get_array_buffer");
+    CHECK(array_pointer(x)[8] == buf[8] && array_pointer(NULL) == NULL, "array_pointer");
+
+    v = array_version(x);
+    array_changed(x);
+    matrix_changed(a);
+    CHECK(array_version(x) == v + 1 && matrix_version(a) > 1, "array_changed and matrix_changed");
+
+    b = random_matrix(5, 3);
+    c = create_matrix(7, 3);
+    d = matrix_times_matrix(a, b);
+    matrix_times_matrix_into(a, b, c);
+    CHECK(same_matrix(c, d), "matrix_times_matrix_into");
+    matrix_times_matrix_into(a, b, a);
+    CHECK(get_from_matrix(a, 5, 2) == 42, "matrix_times_matrix_into with incompatible arguments");
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(c);
+    free_matrix(d);
+    free_array(x);
+}
+
+static int released;
+
+static void count_release(void *buffer)         // Deleter of the tests of wrapped buffers.
+{
+    released++;
+
+    free(buffer);
+}
+
+static void test_wrap(void)                     // Matrices and arrays that use buffers of the caller.
+{
+    int i, j, err, perm[6], perm2[6];
+    double *buf = malloc(6 * 9 * sizeof(double)), *data = malloc(6 * sizeof(double)), *copy, small[4] = {1, 2, 3, 4}, det, norm;
+    Matrix *a, *b, *c;
+    Array *x;
+
+    for (i = 0; i < 6 * 9; i++)
+        buf[i] = rnd();
+
+    a = wrap_matrix(buf, 6, 6, 9, count_release);       // Rows of 6 elements in rows of 9 of the buffer
+    for (i = 0, err = 0; i < 6; i++)
+    {
+        for (j = 0; j < 6; j++)
+            err += get_from_matrix(a, i, j) != buf[i * 9 + j];
+    }
+    CHECK(err == 0 && matrix_version(a) == 1, "wrap_matrix uses the buffer with a stride");
+
+    insert_in_matrix(7, a, 2, 3);
+    CHECK(buf[2 * 9 + 3] == 7, "changes of a wrapped matrix are in the buffer");
+
+    b = copy_matrix(a);
+    copy = matrix_buffer(a);
+    swap_rows(a, 0, 5);
+    CHECK(buf[0] == copy[30] && buf[45] == copy[0] && buf[5 * 9 + 5] == copy[5], "swap_rows moves the data of a wrapped matrix");
+    swap_rows(a, 0, 5);
+
+    lu_decomposition(a, perm);
+    lu_decomposition(b, perm2);
+    for (i = 0, err = 0; i < 6; i++)
+    {
+        for (j = 0; j < 6; j++)
+            err += buf[i * 9 + j] != get_from_matrix(b, i, j);
+    }
+    CHECK(err == 0 && memcmp(perm, perm2, sizeof(perm)) == 0, "lu_decomposition of a wrapped matrix, in the buffer");
+
+    for (i = 0; i < 6; i++)
+        perm[i] = (i + 2) % 6;
+    apply_permutation_to_matrix(a, perm);
+    apply_permutation_to_matrix(b, perm);
+    CHECK(buf[0] == get_from_matrix(b, 0, 0) && buf[4 * 9 + 5] == get_from_matrix(b, 4, 5), "apply_permutation_to_matrix with a wrapped matrix");
+
+    c = wrap_matrix(buf, 3, 9, 18, NULL);           // Even rows of the same buffer, kept by the caller
+    CHECK(get_from_matrix(c, 1, 8) == buf[26], "wrap_matrix without ownership");
+    free_matrix(c);
+    CHECK(released == 0, "the buffer is kept without a deleter");
+    free_matrix(a);
+    CHECK(released == 1, "free_matrix calls the deleter");
+
+    x = wrap_array(data, 6, count_release);
+    insert_in_array(3, x, 4);
+    CHECK(data[4] == 3 && length_of_array(x) == 6, "wrap_array");
+    free_array(x);
+    CHECK(released == 2, "free_array calls the deleter");
+
+    c = wrap_matrix(small, 2, 2, 2, NULL);          // Writes to the buffer, reported to the saved values
+    x = wrap_array(small + 2, 2, NULL);
+    det = determinant(c);
+    norm = euclidean_norm(x);
+    small[0] = 10;
+    small[3] = 0;
+    matrix_changed(c);
+    array_changed(x);
+    CHECK(det == -2 && determinant(c) == -6, "matrix_changed after writing to the buffer of a wrapped matrix");
+    CHECK(norm == 5 && euclidean_norm(x) == 3, "array_changed after writing to the buffer of a wrapped array");
+    free_matrix(c);
+    free_array(x);
+
+    CHECK(wrap_matrix(NULL, 2, 2, 2, NULL) == NULL && wrap_matrix(copy, 2, 3, 2, NULL) == NULL && wrap_array(NULL, 3, NULL) == NULL,
+          "wrap functions with invalid arguments");
+
+    c = create_matrix_uninitialized(5, 6);
+    set_matrix_buffer(c, copy);
+    x = create_array_uninitialized(30);
+    set_array_buffer(x, copy);
+    CHECK(get_from_matrix(c, 4, 5) == copy[29] && get_from_array(x, 29) == copy[29] && matrix_version(c) == 2,
+          "create_matrix_uninitialized and create_array_uninitialized");
+
+    free_matrix(b);
+    free_matrix(c);
+    free_array(x);
+    free(copy);
+}
+
+static int column_sums(Matrix *block, int first, int rows, void *data)     // Visitor of 'test_streams'.
+{
+    int i, j;
+    double *sums = data;
+
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < matrix_column_number(block); j++)
+            sums[j] += get_from_matrix(block, i, j);
+    }
+
+    sums[5] += first;                               // Checks the order of the blocks.
+
+    return 0;
+}
+
+static void test_streams(void)                  // Streaming readers and writers against whole matrices.
+{
+    char *name = "test_linalg.tmp", bytes[16384];
+    int binary, i, j, counts[4];
+    size_t len;
+    double sums[6], ref[6];
+    FILE *file;
+    Matrix *a = random_matrix(37, 5), *b, *block = create_matrix(16, 5), *part;
+    MatrixReader *rd;
+    MatrixWriter *wr;
+
+    insert_in_matrix(1.0 / 3, a, 0, 0);             // Values that need 17 digits or special formats
+    insert_in_matrix(-0.0, a, 0, 1);
+    insert_in_matrix(DBL_MIN / 3, a, 0, 2);
+    insert_in_matrix(-DBL_MAX, a, 0, 3);
+
+    for (binary = 0; binary <= 1; binary++)
+    {
+        CHECK(save_matrix(a, name, binary), "save_matrix, binary = %d", binary);
+        b = get_matrix(name);
+        CHECK(b != NULL && same_matrix(a, b), "get_matrix reads what save_matrix wrote, binary = %d", binary);
+        free_matrix(b);
+
+        file = fopen(name, "rb");                   // Half of the file
+        len = fread(bytes, 1, sizeof(bytes), file);
+        fclose(file);
+        file = fopen(name, "wb");
+        fwrite(bytes, 1, len / 2, file);
+        fclose(file);
+        CHECK(len < sizeof(bytes) && get_matrix(name) == NULL, "get_matrix of a truncated file, binary = %d", binary);
+
+        file = tmpfile();
+        wr = open_matrix_writer(file, 37, 5, binary);
+        for (i = 0; i < 37; i += 10)                // Blocks of 10 rows of 'a'
+        {
+            part = create_matrix(10, 5);
+            for (j = 0; j < 10 && i + j < 37; j++)
+                set_matrix_row(part, j, matrix_row_pointer(a, i + j));
+            CHECK(write_matrix_rows(wr, part, j), "write_matrix_rows, binary = %d", binary);
+            free_matrix(part);
+        }
+        CHECK(free_matrix_writer(wr), "free_matrix_writer, binary = %d", binary);
+
+        rewind(file);
+        rd = open_matrix_reader(file);
+        CHECK(matrix_reader_row_number(rd) == 37 && matrix_reader_column_number(rd) == 5, "open_matrix_reader, binary = %d", binary);
+        for (i = 0; i < 4; i++)
+            counts[i] = read_matrix_rows(rd, block);
+        CHECK(counts[0] == 16 && counts[1] == 16 && counts[2] == 5 && counts[3] == 0, "read_matrix_rows, binary = %d", binary);
+        CHECK(memcmp(matrix_row_pointer(block, 4), matrix_row_pointer(a, 36), 5 * sizeof(double)) == 0,
+              "read_matrix_rows gives the last rows, binary = %d", binary);
+
+        CHECK(matrix_reader_block(block, 20, 3, rd) == 0 && get_from_matrix(block, 2, 4) == get_from_matrix(a, 22, 4),
+              "matrix_reader_block reads the file again, binary = %d", binary);
+        CHECK(matrix_reader_block(block, 30, 7, rd) == 0 && get_from_matrix(block, 0, 1) == get_from_matrix(a, 30, 1),
+              "matrix_reader_block skips rows, binary = %d", binary);
+        free_matrix_reader(rd);
+
+        rewind(file);
+        rd = open_matrix_reader(file);
+        memset(sums, 0, sizeof(sums));
+        memset(ref, 0, sizeof(ref));
+        for (i = 0; i < 37; i++)
+        {
+            for (j = 0; j < 5; j++)
+                ref[j] += get_from_matrix(a, i, j);
+        }
+        CHECK(stream_matrix(rd, 8, column_sums, sums) && memcmp(sums, ref, 5 * sizeof(double)) == 0 && sums[5] == 0 + 8 + 16 + 24 + 32,
+              "stream_matrix, binary = %d", binary);
+        free_matrix_reader(rd);
+        fclose(file);
+    }
+
+    file = tmpfile();
+    wr = open_matrix_writer(file, 3, 5, 0);
+    CHECK(!write_matrix_rows(wr, block, 4) && write_matrix_rows(wr, block, 2) && !free_matrix_writer(wr), "incomplete writers fail");
+    rewind(file);
+    fprintf(file, "not a matrix");
+    rewind(file);
+    CHECK(open_matrix_reader(file) == NULL, "open_matrix_reader of an invalid file");
+    fclose(file);
+
+    remove(name);
+    free_matrix(a);
+    free_matrix(block);
+}
+
+static void test_compressed(void)               // Compressed files against the original matrices.
+{
+    char *name = "test_linalg.tmp", *text = "test_linalg_text.tmp";
+    int level, i, j;
+    Matrix *a = random_matrix(45, 13), *b, *block = create_matrix(20, 13);
+    CompressedMatrix *cm;
+
+    for (i = 0; i < 45; i++)                        // Columns with few distinct bytes, as in measured data
+    {
+        for (j = 0; j < 6; j++)
+            insert_in_matrix(i * 0.25 + j, a, i, j);
+    }
+
+    for (level = 0; level <= 9; level += 3)
+    {
+        CHECK(save_compressed_matrix(a, name, 7, level), "save_compressed_matrix, level = %d", level);
+        b = get_compressed_matrix(name);
+        CHECK(b != NULL && same_matrix(a, b), "get_compressed_matrix, level = %d", level);
+        free_matrix(b);
+    }
+
+    b = get_matrix(name);
+    CHECK(b != NULL && same_matrix(a, b), "get_matrix reads compressed files");
+    free_matrix(b);
+
+    cm = open_compressed_matrix(name);
+    CHECK(compressed_matrix_row_number(cm) == 45 && compressed_matrix_column_number(cm) == 13, "open_compressed_matrix");
+    CHECK(compressed_matrix_block(block, 10, 20, cm) == 0 && memcmp(matrix_row_pointer(block, 19), matrix_row_pointer(a, 29), 13 * sizeof(double)) == 0,
+          "compressed_matrix_block");
+    CHECK(compressed_matrix_block(block, 2, 1, cm) == 0 && memcmp(matrix_row_pointer(block, 0), matrix_row_pointer(a, 2), 13 * sizeof(double)) == 0,
+          "compressed_matrix_block going back");
+    CHECK(compressed_matrix_block(block, 40, 6, cm) != 0, "compressed_matrix_block after the last row");
+    free_compressed_matrix(cm);
+
+    save_matrix(a, text, 0);
+    CHECK(compress_matrix_file(text, name, 4, 6), "compress_matrix_file");
+    b = get_matrix(name);
+    CHECK(b != NULL && same_matrix(a, b), "compress_matrix_file keeps the elements");
+    free_matrix(b);
+
+    CHECK(save_compressed_matrix(a, name, 100, 1) && (b = get_compressed_matrix(name)) != NULL && same_matrix(a, b),
+          "one chunk larger than the matrix");
+    free_matrix(b);
+
+    CHECK(get_compressed_matrix(text) == NULL && open_compressed_matrix(text) == NULL, "a text file is not a compressed matrix");
+    CHECK(!save_compressed_matrix(a, name, 0, 1) && !save_compressed_matrix(a, name, 4, 10), "invalid arguments");
+
+    remove(name);
+    remove(text);
+    free_matrix(a);
+    free_matrix(block);
+}
+
+static Array* residual(Array *ax, Array *b)     // 'ax - b' of the tests of systems.
+{
+    int i;
+    Array *res = create_array(length_of_array(b));
+
+    for (i = 0; i < length_of_array(b); i++)
+        insert_in_array(get_from_array(ax, i) - get_from_array(b, i), res, i);
+
+    return res;
+}
+
+static void test_band(void)                     // Band and tridiagonal systems against the dense matrices.
+{
+    static const int bands[][2] = {{0, 0}, {1, 1}, {2, 1}, {1, 3}, {4, 4}, {0, 2}};
+    int n = 30, k, i, j, count = 37, s, parallel;
+    double err, *ref;
+    Matrix *dense, *back, *sub, *diag, *sup, *rhs;
+    Array *x, *b, *ax, *dx, *res, *a1, *a2, *a3, *b1, *x1;
+    BandMatrix *band;
+
+    for (k = 0; k < 6; k++)
+    {
+        int kl = bands[k][0], ku = bands[k][1];
+
+        dense = random_matrix(n, n);                // Small diagonal: the rows must be swapped.
+
+        for (i = 0; i < n; i++)
+        {
+            for (j = 0; j < n; j++)
+            {
+                if (j < i - kl || j > i + ku)
+                    insert_in_matrix(0, dense, i, j);
+            }
+
+            insert_in_matrix(1e-3 * get_from_matrix(dense, i, i), dense, i, i);
+        }
+
+        band = matrix_to_band_matrix(dense, kl, ku);
+        back = band_matrix_to_matrix(band);
+        CHECK(band != NULL && same_matrix(dense, back), "band_matrix_to_matrix, kl = %d, ku = %d", kl, ku);
+
+        b = random_array(n);
+        ax = band_matrix_times_array(band, b);
+        dx = matrix_times_array(dense, b);
+        ref = array_buffer(dx);
+        CHECK(array_rel_error(ax, ref) < 1e-15, "band_matrix_times_array, kl = %d, ku = %d", kl, ku);
+        free(ref);
+
+        x = solve_band_system(band, b);
+        CHECK(x != NULL && same_matrix(dense, back), "solve_band_system keeps the matrix, kl = %d, ku = %d", kl, ku);
+
+        free_array(ax);
+        free_array(dx);
+        ax = band_matrix_times_array(band, x);
+        res = residual(ax, b);
+        err = euclidean_norm(res) / (euclidean_norm(x) + 1);
+        CHECK(err < 1e-10, "solve_band_system, kl = %d, ku = %d: residual %g", kl, ku, err);
+
+        free_array(x);
+        free_array(b);
+        free_array(ax);
+        free_array(res);
+        free_matrix(back);
+        free_band_matrix(band);
+        free_matrix(dense);
+    }
+
+    a1 = random_array(n);                           // Tridiagonal, diagonally dominant
+    a2 = random_array(n);
+    a3 = random_array(n);
+    b1 = random_array(n);
+    band = create_band_matrix(n, 1, 1);
+
+    for (i = 0; i < n; i++)
+    {
+        insert_in_array(get_from_array(a2, i) + 3, a2, i);
+
+        insert_in_band_matrix(get_from_array(a2, i), band, i, i);
+
+        if (i > 0)
+            insert_in_band_matrix(get_from_array(a1, i), band, i, i - 1);
+
+        if (i < n - 1)
+            insert_in_band_matrix(get_from_array(a3, i), band, i, i + 1);
+    }
+
+    x1 = tridiagonal_solve(a1, a2, a3, b1);
+    x = solve_band_system(band, b1);
+    ref = array_buffer(x);
+    CHECK(x1 != NULL && array_rel_error(x1, ref) < 1e-14, "tridiagonal_solve against solve_band_system");
+    free(ref);
+    free_array(x);
+
+    sub = random_matrix(n, count);                  // One system in each column
+    diag = random_matrix(n, count);
+    sup = random_matrix(n, count);
+    rhs = random_matrix(n, count);
+    back = create_matrix(n, count);
+
+    for (i = 0; i < n; i++)
+    {
+        for (s = 0; s < count; s++)
+            insert_in_matrix(get_from_matrix(diag, i, s) + 3, diag, i, s);
+    }
+
+    for (s = 0; s < count; s++)
+    {
+        Array *c1 = create_array(n), *c2 = create_array(n), *c3 = create_array(n), *cb = create_array(n), *cx;
+
+        for (i = 0; i < n; i++)
+        {
+            insert_in_array(get_from_matrix(sub, i, s), c1, i);
+            insert_in_array(get_from_matrix(diag, i, s), c2, i);
+            insert_in_array(get_from_matrix(sup, i, s), c3, i);
+            insert_in_array(get_from_matrix(rhs, i, s), cb, i);
+        }
+
+        cx = tridiagonal_solve(c1, c2, c3, cb);
+
+        for (i = 0; i < n; i++)
+            insert_in_matrix(get_from_array(cx, i), back, i, s);
+
+        free_array(c1);
+        free_array(c2);
+        free_array(c3);
+        free_array(cb);
+        free_array(cx);
+    }
+
+    ref = matrix_buffer(back);
+    over_copy_matrix(rhs, back);
+    CHECK(batch_tridiagonal_solve(sub, diag, sup, rhs) && matrix_rel_error(rhs, ref) < 1e-14, "batch_tridiagonal_solve");
+
+    parallel = linalg_get_parameter("batch_parallel");
+    linalg_set_parameter("batch_parallel", 0);
+    over_copy_matrix(back, rhs);
+    CHECK(batch_tridiagonal_solve(sub, diag, sup, rhs) && matrix_rel_error(rhs, ref) < 1e-14, "batch_tridiagonal_solve in parallel");
+    linalg_set_parameter("batch_parallel", parallel);
+    free(ref);
+
+    insert_in_array(0, a2, 0);
+    CHECK(tridiagonal_solve(a1, a2, a3, b1) == NULL, "tridiagonal_solve with a zero pivot");
+    insert_in_matrix(0, diag, 0, 5);
+    CHECK(!batch_tridiagonal_solve(sub, diag, sup, rhs), "batch_tridiagonal_solve with a zero pivot");
+
+    for (i = 3; i <= 5; i++)                        // Null column
+        insert_in_band_matrix(0, band, i, 4);
+
+    CHECK(solve_band_system(band, b1) == NULL, "solve_band_system of a singular matrix");
+    CHECK(get_from_band_matrix(band, 0, 5) == 0 && create_band_matrix(3, 3, 0) == NULL && create_band_matrix(3, 0, -1) == NULL,
+          "positions outside the band and invalid bands");
+    x = create_array(n + 1);
+    CHECK(band_matrix_times_array(band, x) == NULL, "band_matrix_times_array with incompatible dimensions");
+    free_array(x);
+
+    free_array(a1);
+    free_array(a2);
+    free_array(a3);
+    free_array(b1);
+    free_array(x1);
+    free_matrix(sub);
+    free_matrix(diag);
+    free_matrix(sup);
+    free_matrix(rhs);
+    free_matrix(back);
+    free_band_matrix(band);
+}
+
+int main(void)
+{
+    test_access();
+    test_files();
+    test_copies_and_sums();
+    test_products();
+    test_vectors();
+    test_vector_batches();
+    test_permutations();
+    test_elimination();
+    test_systems();
+    test_polynomials();
+    test_decompositions();
+    test_stats();
+    test_kernels();
+    test_tuning();
+    test_strassen();
+    test_tiled();
+    test_async();
+    test_dag();
+    test_updates();
+    test_factor_cache();
+    test_versions();
+    test_bulk();
+    test_wrap();
+    test_streams();
+    test_compressed();
+    test_band();
+
+    printf("\n%d checks, %d failures\n", checks, failures);
+
+    return failures != 0;
+}
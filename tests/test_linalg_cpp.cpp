@@ -0,0 +1,268 @@
+// Tests of the C++ interface of the linalg library ('linalg.hpp').
+//
+// The wrappers only call the C functions, so the tests check ownership, moves,
+// the reuse of storage and the views, and compare results with the C library,
+// also for the fixed-size matrices.
+//
+// The tests print one line for each failed check and return a non-zero
+// status if any check failed.
+//
+
+
+#include <cstdio>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "linalg.hpp"
+
+#define CHECK(cond, ...) do { checks++; if (!(cond)) { failures++; \
+        std::printf("FAIL %s:%d: ", __FILE__, __LINE__); std::printf(__VA_ARGS__); std::printf("\n"); } } while (0)
+
+static int checks = 0, failures = 0;
+
+static unsigned long long rnd_state = 88172645463325252ULL;
+
+
+// Helpers:
+
+static double rnd()             // Uniform pseudo-random number in [-1, 1).
+{
+    rnd_state ^= rnd_state << 13;
+
+    rnd_state ^= rnd_state >> 7;
+
+    rnd_state ^= rnd_state << 17;
+
+    return (double) (rnd_state >> 11) / 4503599627370496.0 - 1;
+}
+
+static linalg::Matrix random_matrix(int m, int n)
+{
+    std::vector<double> buf(m * n);
+
+    for (double &v : buf)
+        v = rnd();
+
+    linalg::Matrix mat = linalg::Matrix::uninitialized(m, n);
+
+    mat.set_buffer(buf);
+
+    return mat;
+}
+
+static double max_difference(const linalg::Matrix &a, ::Matrix *b)     // Largest difference between the elements of two matrices.
+{
+    int i, j;
+    double d = 0;
+
+    for (i = 0; i < a.rows(); i++)
+    {
+        for (j = 0; j < a.cols(); j++)
+            d = std::fmax(d, std::fabs(a(i, j) - get_from_matrix(b, i, j)));
+    }
+
+    return d;
+}
+
+
+// Tests:
+
+static void test_ownership()    // Construction, copies and moves.
+{
+    linalg::Matrix a = random_matrix(4, 3), b = a, e;
+    ::Matrix *raw = a.get();
+
+    CHECK(b.get() != a.get() && max_difference(b, a.get()) == 0, "copy constructor copies the elements");
+
+    linalg::Matrix c = std::move(a);
+    CHECK(c.get() == raw && a.empty(), "move constructor takes the matrix");
+
+    e = std::move(c);
+    CHECK(e.get() == raw, "move assignment takes the matrix");
+
+    raw = b.get();
+    b = e;
+    CHECK(b.get() == raw && max_difference(b, e.get()) == 0, "copy assignment reuses a matrix of the same dimensions");
+
+    b = linalg::Matrix(2, 2);
+    b = e;
+    CHECK(b.rows() == 4 && b.cols() == 3 && max_difference(b, e.get()) == 0, "copy assignment with other dimensions");
+
+    ::Matrix *released = b.release();
+    CHECK(b.empty() && released != nullptr, "release");
+    free_matrix(released);
+
+    linalg::Matrix m = {{1, 2}, {3, 4}, {5, 6}};
+    linalg::Array x = {1, -1};
+    CHECK(m.rows() == 3 && m(2, 1) == 6 && x.size() == 2 && x[1] == -1, "initializer lists");
+
+    bool thrown = false;
+
+    try
+    {
+        linalg::Matrix bad = {{1, 2}, {3}};
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown, "rows of different lengths throw");
+
+    double buf[6] = {1, 2, 3, 4, 5, 6};
+    {
+        linalg::Matrix w = linalg::Matrix::wrap(buf, 2, 2, 3);
+
+        w(1, 1) = 9;
+    }
+    CHECK(buf[4] == 9, "wrapped matrix writes into the buffer and does not free it");
+}
+
+static void test_operators()    // Results against the C functions.
+{
+    linalg::Matrix a = random_matrix(5, 5), b = random_matrix(5, 5), c = random_matrix(5, 5);
+    ::Matrix *ab = matrix_times_matrix(a.get(), b.get()), *ref = sum_matrix(ab, c.get());
+
+    linalg::Matrix d = a * b + c;
+    CHECK(max_difference(d, ref) == 0, "a * b + c");
+
+    ::Matrix *raw = d.get();
+    linalg::Matrix e = std::move(d) - c;
+    CHECK(e.get() == raw && max_difference(e, ab) < 1e-14, "an operator reuses a temporary");
+
+    raw = e.get();
+    e += c;
+    e *= 2;
+    e -= c;
+    over_rnumber_times_matrix(2, ref);
+    over_subtract_matrix(ref, c.get());
+    CHECK(e.get() == raw && max_difference(e, ref) < 1e-14, "in-place operators");
+
+    linalg::Array x = {1, 2, 3, 4, 5}, y;
+    linalg::multiply(a, x, y);
+    ::Array *ry = matrix_times_array(a.get(), x.get());
+    double *data = y.data();
+    linalg::multiply(a, x, y);
+    CHECK(y.data() == data && std::fabs(y[4] - get_from_array(ry, 4)) < 1e-14, "multiply by an array reuses the result");
+
+    linalg::Matrix p(5, 5);
+    raw = p.get();
+    linalg::multiply(a, b, p);
+    CHECK(p.get() == raw && max_difference(p, ab) == 0, "multiply reuses the result");
+
+    linalg::Matrix q;
+    linalg::multiply(a, b, q);
+    linalg::add(a, b, p);
+    linalg::subtract(p, b, p);
+    CHECK(max_difference(q, ab) == 0 && p.get() == raw && max_difference(p, a.get()) < 1e-15, "multiply, add and subtract");
+
+    linalg::Matrix t;
+    linalg::transpose(random_matrix(3, 4), t);
+    linalg::Matrix tt = linalg::transpose(t);
+    CHECK(t.rows() == 4 && t.cols() == 3 && tt(2, 3) == t(3, 2), "transpose");
+
+    bool thrown = false;
+
+    try
+    {
+        linalg::multiply(a, t, p);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown, "incompatible dimensions throw");
+
+    free_matrix(ab);
+    free_matrix(ref);
+    free_array(ry);
+}
+
+static void test_views()        // Spans and the counters of changes.
+{
+    linalg::Matrix a = random_matrix(3, 3);
+    linalg::Array x = {3, 4};
+    double n = euclidean_norm(x.get());
+
+    x.span()[0] = 0;
+    CHECK(n == 5 && euclidean_norm(x.get()) == 4, "a mutable view is a change of the array");
+
+    double det = determinant(a.get());
+    unsigned long long v = a.version();
+    std::span<double> row = a.row(1);
+    for (double &r : row)
+        r *= 2;
+    CHECK(a.version() > v && std::fabs(determinant(a.get()) - 2 * det) < 1e-14, "a mutable row is a change of the matrix");
+
+    const linalg::Matrix &ca = a;
+    v = a.version();
+    CHECK(ca.row(2).size() == 3 && ca(1, 0) == row[0] && a.version() == v, "constant views are not changes");
+
+    std::vector<double> buf(9);
+    a.get_buffer(buf);
+    CHECK(buf[4] == ca(1, 1), "get_buffer");
+}
+
+static void test_fixed()        // Fixed-size matrices against the C functions.
+{
+    constexpr linalg::FixedMatrix<double, 3, 3> r = {{2, 1, 0}, {1, 3, 1}, {0, 1, 4}};
+    static_assert(linalg::determinant(r) == 18 && linalg::inverse(r).has_value(), "constant expressions");
+    static_assert(r * linalg::FixedMatrix<double, 3, 3>::identity() == r, "constant expressions");
+
+    int n;
+
+    for (n = 1; n <= 6; n++)
+    {
+        linalg::Matrix d = random_matrix(6, 6);
+        linalg::FixedMatrix<double, 6, 6> f(d);
+        ::Matrix *inv = inverse_matrix(d.get());
+        double det = determinant(d.get());
+
+        CHECK(std::fabs(linalg::determinant(f) - det) <= 1e-13 * std::fabs(det) + 1e-15, "determinant 6x6, %g", det);
+
+        auto fi = linalg::inverse(f);
+        CHECK(fi.has_value() && max_difference(fi->to_matrix(), inv) < 1e-10, "inverse 6x6");
+
+        linalg::FixedVector<double, 6> b;
+        for (int i = 0; i < 6; i++)
+            b[i] = rnd();
+        auto x = linalg::solve(f, b);
+        linalg::FixedVector<double, 6> res = f * *x - b;
+        CHECK(x.has_value() && std::sqrt(linalg::scalar_product(res, res)) < 1e-12, "solve 6x6");
+
+        free_matrix(inv);
+    }
+
+    linalg::Matrix a = random_matrix(4, 3), b = random_matrix(3, 2);
+    linalg::FixedMatrix<double, 4, 3> fa(a);
+    linalg::FixedMatrix<double, 3, 2> fb(b);
+    linalg::Matrix ab = a * b;
+    CHECK(max_difference(ab, (fa * fb).to_matrix().get()) < 1e-15, "product against the dynamic matrix");
+    CHECK(linalg::transpose(fa)(2, 3) == fa(3, 2) && (fa + fa - fa) == fa && (2.0 * fa)(1, 1) == 2 * fa(1, 1), "other operations");
+
+    linalg::FixedMatrix<double, 2, 2> s = {{1, 2}, {2, 4}};
+    linalg::FixedMatrix<double, 4, 4> z;
+    CHECK(!linalg::inverse(s) && !linalg::solve(s, linalg::FixedVector<double, 2>()) && linalg::determinant(z) == 0,
+          "singular matrices");
+
+    linalg::Array u = {1, 2, 3}, v = {-2, 0.5, 4};
+    ::Array *w = vector_product(u.get(), v.get());
+    linalg::FixedVector<double, 3> fu = {{1}, {2}, {3}}, fv = {{-2}, {0.5}, {4}};
+    auto fw = linalg::vector_product(fu, fv);
+    CHECK(fw[0] == get_from_array(w, 0) && fw[1] == get_from_array(w, 1) && fw[2] == get_from_array(w, 2), "vector_product");
+    free_array(w);
+
+    linalg::FixedMatrix<float, 2, 2> g(linalg::Matrix({{1, 2}, {3, 4}}));
+    CHECK(linalg::determinant(g) == -2.0f && g.to_matrix()(1, 0) == 3, "conversions with other types");
+}
+
+int main()
+{
+    test_ownership();
+    test_operators();
+    test_views();
+    test_fixed();
+
+    std::printf("%d checks, %d failures\n", checks, failures);
+
+    return failures != 0;
+}
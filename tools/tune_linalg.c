@@ -0,0 +1,389 @@
+// Autotuner for the linalg library.
+//
+// Measures, on the current machine, the block sizes of the matrix product and
+// the sizes from which the multithreaded kernels are faster than the sequential
+// ones, and writes them as a tuning profile that 'linalg_init' loads:
+//
+//     linalg_init("linalg.tuning");      // or LINALG_TUNING=linalg.tuning
+//
+// Usage: tune_linalg [--output FILE] [--size N] [--time S] [--strassen N] [--quick]
+//
+// '--size' is the order of the matrices used to choose the block sizes (512 by
+// default) and '--time' the minimum time of each measurement. With '--strassen',
+// the cutoff of the Strassen-Winograd method is chosen for products of order N,
+// and kept disabled if the method is not faster there. '--quick' tries fewer
+// candidates with small sizes, to check that the tool works.
+//
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "linalg.h"
+
+#define NEVER 2147483647                                // Threshold that disables multithreading
+#define GAIN 0.9                                        // Parallel runs must take at most this fraction of the time
+
+typedef struct workload                                 // Data for the measured calls
+{
+    int n;
+
+    Matrix *a;
+
+    Matrix *b;
+
+    Array *x;                                           // Arrays of length 'n'
+
+    Array *y;
+
+    Array *xs;                                          // Arrays of length 'n * n'
+
+    Array *ys;
+
+    Array *coef;                                        // Polynomial of degree 15
+
+    VectorBatch *va;
+
+    VectorBatch *vb;
+} Workload;
+
+static double mintime = 0.05;
+
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double random_value(void)
+{
+    return 2.0 * rand() / RAND_MAX - 1;
+}
+
+static Matrix* random_matrix(int n)
+{
+    int i, j;
+    double *row = malloc(n * sizeof(double));
+    Matrix *mat = create_matrix(n, n);
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            row[j] = random_value();
+
+        set_matrix_row(mat, i, row);
+    }
+
+    free(row);
+
+    return mat;
+}
+
+static void setup(Workload *w, int n)                   // Data for matrices 'n x n', arrays and batches of 'n * n' elements.
+{
+    int i;
+
+    w->n = n;
+
+    w->a = random_matrix(n);
+
+    w->b = random_matrix(n);
+
+    w->x = create_array(n);
+
+    w->y = create_array(n);
+
+    for (i = 0; i < n; i++)
+        insert_in_array(random_value(), w->x, i);
+
+    w->xs = create_array(n * n);
+
+    w->ys = create_array(n * n);
+
+    w->va = create_vector_batch(n * n);
+
+    w->vb = create_vector_batch(n * n);
+
+    for (i = 0; i < n * n; i++)
+    {
+        insert_in_array(random_value(), w->xs, i);
+
+        insert_in_vector_batch(random_value(), random_value(), random_value(), w->va, i);
+
+        insert_in_vector_batch(random_value(), random_value(), random_value(), w->vb, i);
+    }
+
+    w->coef = create_array(16);
+
+    for (i = 0; i < 16; i++)
+        insert_in_array(random_value(), w->coef, i);
+}
+
+static void release(Workload *w)
+{
+    free_matrix(w->a);
+    free_matrix(w->b);
+    free_array(w->x);
+    free_array(w->y);
+    free_array(w->xs);
+    free_array(w->ys);
+    free_array(w->coef);
+    free_vector_batch(w->va);
+    free_vector_batch(w->vb);
+}
+
+
+// Measured calls:
+
+static void run_gemm(Workload *w) { free_matrix(matrix_times_matrix(w->a, w->b)); }
+static void run_gemv(Workload *w) { gemv(1, w->a, w->x, 0, w->y); }
+static void run_gemv_transposed(Workload *w) { gemv_transposed(1, w->a, w->x, 0, w->y); }
+static void run_sum(Workload *w) { over_sum_matrix(w->b, w->a); }
+static void run_batch(Workload *w) { batch_scalar_product(w->va, w->vb, w->ys); }
+static void run_poly(Workload *w) { polynomial_eval_many(w->coef, w->xs, w->ys, NULL); }
+
+static double seconds_per_call(void (*run)(Workload *w), Workload *w)   // Best of the repetitions within 'mintime'.
+{
+    double start, t, best = 1e300, total = 0;
+
+    run(w);                                             // Warm-up
+
+    while (total < mintime)
+    {
+        start = now();
+
+        run(w);
+
+        t = now() - start;
+
+        if (t < best)
+            best = t;
+
+        total += t;
+    }
+
+    return best;
+}
+
+static int tune_block(char *name, const int *cand, int ncand, void (*run)(Workload *w), Workload *w)    // Chooses the fastest value of a parameter.
+{
+    int k, best = linalg_get_parameter(name);
+    double t, tbest = 1e300;
+
+    for (k = 0; k < ncand; k++)
+    {
+        linalg_set_parameter(name, cand[k]);
+
+        t = seconds_per_call(run, w);
+
+        printf("  %-20s %8d %12.6f ms\n", name, cand[k], t * 1e3);
+
+        if (t < tbest)
+        {
+            tbest = t;
+
+            best = cand[k];
+        }
+    }
+
+    linalg_set_parameter(name, best);
+
+    return best;
+}
+
+// Chooses the smallest size from which multithreading is faster, for this one
+// and all larger sizes measured. 'sizes' are matrix orders and 'work' converts
+// them to the unit of the parameter.
+static int tune_threshold(char *name, const int *sizes, int nsizes, void (*run)(Workload *w), double (*work)(int n))
+{
+    int k, threshold = NEVER;
+    double tseq, tpar;
+    Workload w;
+
+    for (k = nsizes - 1; k >= 0; k--)                   // From the largest size down
+    {
+        setup(&w, sizes[k]);
+
+        linalg_set_parameter(name, NEVER);
+
+        tseq = seconds_per_call(run, &w);
+
+        linalg_set_parameter(name, 0);
+
+        tpar = seconds_per_call(run, &w);
+
+        release(&w);
+
+        printf("  %-20s %8.0f  sequential %10.6f ms, parallel %10.6f ms\n", name, work(sizes[k]), tseq * 1e3, tpar * 1e3);
+
+        if (tpar > GAIN * tseq)
+            break;
+
+        threshold = (int) work(sizes[k]);
+    }
+
+    linalg_set_parameter(name, threshold);
+
+    return threshold;
+}
+
+static int tune_strassen(int n, const int *cuts, int ncuts)    // Chooses the cutoff of Strassen's method for products of order 'n'.
+{
+    int k, best = 0;
+    double t, tbest;
+    Workload w;
+
+    w.a = random_matrix(n);                             // Only the matrices: the other data of 'setup' would be too large.
+
+    w.b = random_matrix(n);
+
+    linalg_set_parameter("strassen_cutoff", 0);
+
+    tbest = GAIN * seconds_per_call(run_gemm, &w);      // The method must be clearly faster than the usual one.
+
+    printf("  %-20s %8d %12.6f ms\n", "strassen_cutoff", 0, tbest / GAIN * 1e3);
+
+    for (k = 0; k < ncuts && 2 * cuts[k] <= n; k++)
+    {
+        linalg_set_parameter("strassen_cutoff", cuts[k]);
+
+        t = seconds_per_call(run_gemm, &w);
+
+        printf("  %-20s %8d %12.6f ms\n", "strassen_cutoff", cuts[k], t * 1e3);
+
+        if (t < tbest)
+        {
+            tbest = t;
+
+            best = cuts[k];
+        }
+    }
+
+    free_matrix(w.a);
+    free_matrix(w.b);
+
+    linalg_set_parameter("strassen_cutoff", best);
+
+    return best;
+}
+
+static double cubic(int n) { return (double) n * n * n; }
+static double square(int n) { return (double) n * n; }
+
+static void usage(char *prog)
+{
+    fprintf(stderr, "Usage: %s [--output FILE] [--size N] [--time S] [--strassen N] [--quick]\n", prog);
+
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    static const int rows[] = {8, 16, 32, 64, 128}, inner[] = {64, 128, 256, 512}, cols[] = {256, 512, 1024, 2048, 4096};
+    static const int columns[] = {128, 256, 512, 1024, 2048};
+    static const int orders[] = {8, 16, 32, 64, 128, 256, 512, 1024};
+    static const int cubic_orders[] = {16, 32, 64, 128, 256};
+    static const int cutoffs[] = {64, 128, 256, 512, 1024}, quick_cutoffs[] = {8, 16};
+    char *output = "linalg.tuning";
+    int i, n = 512, strassen = 0, quick = 0, ncand, nord;
+    Workload w;
+    FILE *filout;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+            mintime = atof(argv[++i]);
+        else if (strcmp(argv[i], "--strassen") == 0 && i + 1 < argc)
+            strassen = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quick") == 0)
+            quick = 1;
+        else
+            usage(argv[0]);
+    }
+
+    if (quick)
+    {
+        n = 32;
+
+        strassen = (strassen > 0) ? 64 : 0;
+
+        mintime = 0.001;
+    }
+
+    if (n < 2 || mintime < 0 || strassen < 0)
+        usage(argv[0]);
+
+    ncand = quick ? 2 : 5;                              // Candidates of each list that are tried
+
+    nord = quick ? 3 : 8;
+
+    linalg_init(NULL);                                  // Starts from the profile in use, if any.
+
+    printf("Kernels: %s\n\nBlock sizes of the matrix product, n = %d:\n", linalg_kernels_name(), n);
+
+    setup(&w, n);
+
+    linalg_set_parameter("gemm_parallel", NEVER);       // Blocks are chosen for one thread, since each thread works on its own blocks.
+
+    linalg_set_parameter("strassen_cutoff", 0);
+
+    tune_block("gemm_block_inner", inner, ncand < 4 ? ncand : 4, run_gemm, &w);
+    tune_block("gemm_block_cols", cols, ncand, run_gemm, &w);
+    tune_block("gemm_block_rows", rows, ncand, run_gemm, &w);
+
+    printf("\nColumns of the blocks of transposed matrix-vector products:\n");
+
+    release(&w);
+
+    setup(&w, quick ? n : 2 * n);
+
+    tune_block("gemv_columns", columns, ncand, run_gemv_transposed, &w);
+
+    release(&w);
+
+    printf("\nSizes from which multithreading is faster:\n");
+
+    tune_threshold("gemm_parallel", cubic_orders, quick ? 2 : 5, run_gemm, cubic);
+    tune_threshold("gemv_parallel", orders, nord, run_gemv, square);
+    tune_threshold("elementwise_parallel", orders, nord, run_sum, square);
+    tune_threshold("batch_parallel", orders, nord, run_batch, square);
+    tune_threshold("poly_parallel", orders, quick ? 3 : 6, run_poly, square);
+
+    if (strassen > 0)
+    {
+        printf("\nCutoff of the Strassen-Winograd method, n = %d:\n", strassen);
+
+        if (quick)
+            tune_strassen(strassen, quick_cutoffs, 2);
+        else
+            tune_strassen(strassen, cutoffs, 5);
+    }
+
+    filout = fopen(output, "w");
+
+    if (filout == NULL)
+    {
+        fprintf(stderr, "Error opening '%s'!\n", output);
+
+        return 1;
+    }
+
+    linalg_print_tuning(filout);
+
+    fclose(filout);
+
+    printf("\nProfile saved in '%s'.\n", output);
+
+    return 0;
+}